@@ -33,17 +33,68 @@ std::vector<ExecuteFunctionPointer> &Code::executeFunctions()
     return execute_functions;
 }
 
+std::vector<std::string> &Code::names()
+{
+    static std::vector<std::string> names;
+    return names;
+}
+
 Code *Code::getCode(WordType value)
 {
     return codes()[value];
 }
 
+unsigned Code::getCodeCount()
+{
+    return codes().size();
+}
+
 
-Code::Code(RecreateFunctionPointer recreate_function, ExecuteFunctionPointer execute_function) :
-    value {addCode(this)}
+Code::Code(RecreateFunctionPointer recreate_function, ExecuteFunctionPointer execute_function,
+        int stack_effect, unsigned operand_count) :
+    value {addCode(this)},
+    stack_effect {stack_effect == PopsChainOperands ? PushesOperand : stack_effect},
+    chain_operand_offset {stack_effect == PopsChainOperands ? 0 : NoChainOperand},
+    operand_count {operand_count}
 {
     recreateFunctions().emplace_back(recreate_function);
     executeFunctions().emplace_back(execute_function);
+    names().emplace_back();
+}
+
+Code::Code(const char *name, RecreateFunctionPointer recreate_function,
+        ExecuteFunctionPointer execute_function, int stack_effect, unsigned operand_count) :
+    Code {recreate_function, execute_function, stack_effect, operand_count}
+{
+    setName(name);
+}
+
+// the stack effect is the result pushed less the operands popped
+int dataTypesStackEffect(const StackDataTypes &data_types)
+{
+    return (data_types.result ? 1 : 0) - (data_types.first_operand ? 1 : 0)
+        - (data_types.second_operand ? 1 : 0);
+}
+
+Code::Code(const char *name, RecreateFunctionPointer recreate_function,
+        ExecuteFunctionPointer execute_function, StackDataTypes data_types,
+        unsigned operand_count) :
+    Code {name, recreate_function, execute_function, dataTypesStackEffect(data_types),
+        operand_count}
+{
+    this->data_types = data_types;
+}
+
+const std::string &Code::getName() const
+{
+    return names()[value];
+}
+
+// names are only set during static initialization (and by the one time set up of the fused
+// codes), afterwards they are only read
+void Code::setName(const std::string &name)
+{
+    names()[value] = name;
 }
 
 void Code::recreate(Recreator &recreator) const
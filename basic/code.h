@@ -8,8 +8,11 @@
 #ifndef IBC_CODE_H
 #define IBC_CODE_H
 
+#include <limits>
+#include <string>
 #include <vector>
 
+#include "datatype.h"
 #include "wordtype.h"
 
 
@@ -19,23 +22,89 @@ using ExecuteFunctionPointer = void(*)(Executer &);
 class Recreator;
 using RecreateFunctionPointer = void(*)(Recreator &);
 
+constexpr int PushesOperand = 1;
+constexpr int PopsOperand = -1;
+// a chain code pops the number of items in its first operand and pushes its result, so its
+// stack effect depends on its operands
+constexpr int PopsChainOperands = std::numeric_limits<int>::min();
+constexpr unsigned OneOperand = 1;
+constexpr unsigned TwoOperands = 2;
+
+// the data types of the items a code pops (the second operand is the top item) and of the item
+// it pushes, which are checked when the code of a program image is opened; the items popped by a
+// chain code are given by its operands
+
+struct StackDataTypes {
+    DataType first_operand;
+    DataType second_operand;
+    DataType result;
+};
+
+inline StackDataTypes pushes(DataType result_data_type)
+{
+    return StackDataTypes {{}, {}, result_data_type};
+}
+
+inline StackDataTypes pops(DataType operand_data_type)
+{
+    return StackDataTypes {operand_data_type, {}, {}};
+}
+
+inline StackDataTypes converts(DataType operand_data_type, DataType result_data_type)
+{
+    return StackDataTypes {operand_data_type, {}, result_data_type};
+}
+
+int dataTypesStackEffect(const StackDataTypes &data_types);
+
+// each code has a name that does not depend on the order of static initialization (which assigns
+// the values), so that a saved program can be mapped to the values of the running program;
+// codes of a keyword are named by the keyword, other codes are given a name when defined
+
 class Code {
 public:
     static Code *getCode(WordType value);
+    static unsigned getCodeCount();
 
-    Code(RecreateFunctionPointer recreate_function, ExecuteFunctionPointer execute_function);
+    Code(RecreateFunctionPointer recreate_function, ExecuteFunctionPointer execute_function,
+        int stack_effect = 0, unsigned operand_count = 0);
+    Code(const char *name, RecreateFunctionPointer recreate_function,
+        ExecuteFunctionPointer execute_function, int stack_effect = 0,
+        unsigned operand_count = 0);
+    Code(const char *name, RecreateFunctionPointer recreate_function,
+        ExecuteFunctionPointer execute_function, StackDataTypes data_types,
+        unsigned operand_count = 0);
 
     WordType getValue() const;
+    const std::string &getName() const;
+    void setName(const std::string &name);
+    int getStackEffect(const WordType *operands) const;
+    bool hasChainOperand() const;
+    unsigned getChainOperandOffset() const;
+    unsigned getOperandCount() const;
+    const StackDataTypes &getDataTypes() const;
+    void setResultDataType(DataType data_type);
     void recreate(Recreator &recreator) const;
     static const ExecuteFunctionPointer *getExecuteFunctions();
 
+protected:
+    void setStackInfo(const Code &first_code, const Code &second_code);
+    void setOperandDataTypes(DataType first_data_type, DataType second_data_type = {});
+
 private:
     static WordType addCode(Code *code);
     static std::vector<Code *> &codes();
     static std::vector<RecreateFunctionPointer> &recreateFunctions();
     static std::vector<ExecuteFunctionPointer> &executeFunctions();
+    static std::vector<std::string> &names();
+
+    static constexpr int NoChainOperand = -1;
 
     WordType value;
+    int stack_effect;               // without the items popped by a chain code
+    int chain_operand_offset;       // or NoChainOperand
+    unsigned operand_count;
+    StackDataTypes data_types;
 };
 
 
@@ -44,5 +113,59 @@ inline WordType Code::getValue() const
     return value;
 }
 
+// the operands are the words that follow the code, which are only read for a chain code
+inline int Code::getStackEffect(const WordType *operands) const
+{
+    if (!hasChainOperand()) {
+        return stack_effect;
+    }
+    return stack_effect - static_cast<int>(operands[chain_operand_offset]);
+}
+
+inline bool Code::hasChainOperand() const
+{
+    return chain_operand_offset != NoChainOperand;
+}
+
+inline unsigned Code::getChainOperandOffset() const
+{
+    return chain_operand_offset;
+}
+
+inline unsigned Code::getOperandCount() const
+{
+    return operand_count;
+}
+
+inline const StackDataTypes &Code::getDataTypes() const
+{
+    return data_types;
+}
+
+// the result of an operator or function code is set by the codes of its keyword
+inline void Code::setResultDataType(DataType data_type)
+{
+    data_types.result = data_type;
+}
+
+inline void Code::setOperandDataTypes(DataType first_data_type, DataType second_data_type)
+{
+    data_types.first_operand = first_data_type;
+    data_types.second_operand = second_data_type;
+}
+
+// the operands of the second code follow the operands of the first code, at most one of the
+// codes can be a chain code
+inline void Code::setStackInfo(const Code &first_code, const Code &second_code)
+{
+    stack_effect = first_code.stack_effect + second_code.stack_effect;
+    if (first_code.hasChainOperand()) {
+        chain_operand_offset = first_code.chain_operand_offset;
+    } else if (second_code.hasChainOperand()) {
+        chain_operand_offset = first_code.operand_count + second_code.chain_operand_offset;
+    }
+    operand_count = first_code.operand_count + second_code.operand_count;
+}
+
 
 #endif  // IBC_CODE_H
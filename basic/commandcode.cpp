@@ -26,20 +26,34 @@ std::map<WordType, CompilerFunctionPointer> &CommandCode::compileFunctions()
     return compile_functions;
 }
 
-CommandCode *CommandCode::find(const ci_string &keyword)
+// the maps are only changed by the constructor during static initialization, afterwards they are
+// only read and never with operator[] (which may insert) so that threads can share them
+
+// there are only a few commands, so they are searched instead of creating a key to find
+CommandCode *CommandCode::find(ci_string_view keyword)
+{
+    for (auto &command_code : commandCodes()) {
+        if (keyword == command_code.first.c_str()) {
+            return command_code.second;
+        }
+    }
+    return nullptr;
+}
+
+const char *CommandCode::findKeyword(WordType code_value)
 {
-    // FIXME need to check if keyword is present (this line will add a null code pointer)
-    return commandCodes()[keyword];
+    auto it = commandNames().find(code_value);
+    return it == commandNames().end() ? nullptr : it->second;
 }
 
 void CommandCode::compile(Compiler &compiler) const
 {
-    compileFunctions()[getValue()](compiler);
+    compileFunctions().at(getValue())(compiler);
 }
 
 const char *CommandCode::getKeyword() const
 {
-    return commandNames()[getValue()];
+    return commandNames().at(getValue());
 }
 
 
@@ -47,6 +61,7 @@ CommandCode::CommandCode(const char *keyword, CompilerFunctionPointer compile_fu
         RecreateFunctionPointer recreate_function, ExecuteFunctionPointer execute_function) :
     Code {recreate_function, execute_function}
 {
+    setName(keyword);
     commandCodes()[keyword] = this;
     commandNames()[getValue()] = keyword;
     compileFunctions()[getValue()] = compile_function;
@@ -23,7 +23,8 @@ class ProgramUnit;
 
 class CommandCode : public Code {
 public:
-    static CommandCode *find(const ci_string &keyword);
+    static CommandCode *find(ci_string_view keyword);
+    static const char *findKeyword(WordType code_value);
 
     CommandCode(const char *keyword, CompilerFunctionPointer compile_function,
         RecreateFunctionPointer recreate_function, ExecuteFunctionPointer execute_function);
@@ -6,12 +6,14 @@
  */
 
 #include "executer.h"
+#include "fusedcode.h"
 #include "operators.h"
 #include "recreator.h"
+#include "stringcompare.h"
 
 using DblCompareFunction = bool(*)(double, double);
 using IntCompareFunction = bool(*)(int32_t, int32_t);
-using StrCompareFunction = bool(*)(const std::string *, const std::string *);
+using StrCompareFunction = bool(*)(StringView, StringView);
 
 template <DblCompareFunction compare>
 void executeCompareDblDbl(Executer &executer)
@@ -60,7 +62,7 @@ void executeCompareTmpStr(Executer &executer)
     auto rhs = executer.topStr();
     executer.pop();
     auto lhs = executer.moveTopTmpStr();
-    executer.setTopIntFromBool(compare(lhs.get(), rhs));
+    executer.setTopIntFromBool(compare(StringView {*lhs}, rhs));
 }
 
 template <StrCompareFunction compare>
@@ -69,7 +71,7 @@ void executeCompareStrTmp(Executer &executer)
     auto rhs = executer.moveTopTmpStr();
     executer.pop();
     auto lhs = executer.topStr();
-    executer.setTopIntFromBool(compare(lhs, rhs.get()));
+    executer.setTopIntFromBool(compare(lhs, StringView {*rhs}));
 }
 
 template <StrCompareFunction compare>
@@ -78,7 +80,7 @@ void executeCompareTmpTmp(Executer &executer)
     auto rhs = executer.moveTopTmpStr();
     executer.pop();
     auto lhs = executer.moveTopTmpStr();
-    executer.setTopIntFromBool(compare(lhs.get(), rhs.get()));
+    executer.setTopIntFromBool(compare(StringView {*lhs}, StringView {*rhs}));
 }
 
 // ----------------------------------------
@@ -93,9 +95,9 @@ inline bool lt(int32_t lhs, int32_t rhs)
     return lhs < rhs;
 }
 
-inline bool lt(const std::string *lhs, const std::string *rhs)
+inline bool lt(StringView lhs, StringView rhs)
 {
-    return *lhs < *rhs;
+    return compareStrings(lhs, rhs) < 0;
 }
 
 OperatorCode<OpType::DblDbl> lt_dbl_dbl_code {recreateBinaryOperator, executeCompareDblDbl<lt>};
@@ -125,9 +127,9 @@ inline bool gt(int32_t lhs, int32_t rhs)
     return lhs > rhs;
 }
 
-inline bool gt(const std::string *lhs, const std::string *rhs)
+inline bool gt(StringView lhs, StringView rhs)
 {
-    return *lhs > *rhs;
+    return compareStrings(lhs, rhs) > 0;
 }
 
 OperatorCode<OpType::DblDbl> gt_dbl_dbl_code {recreateBinaryOperator, executeCompareDblDbl<gt>};
@@ -135,9 +137,9 @@ OperatorCode<OpType::IntDbl> gt_int_dbl_code {recreateBinaryOperator, executeCom
 OperatorCode<OpType::DblInt> gt_dbl_int_code {recreateBinaryOperator, executeCompareDblInt<gt>};
 OperatorCode<OpType::IntInt> gt_int_int_code {recreateBinaryOperator, executeCompareIntInt<gt>};
 OperatorCode<OpType::StrStr> gt_str_str_code {recreateBinaryOperator, executeCompareStrStr<gt>};
-OperatorCode<OpType::TmpStr> gt_tmp_str_code {recreateBinaryOperator, nullptr};
-OperatorCode<OpType::StrTmp> gt_str_tmp_code {recreateBinaryOperator, nullptr};
-OperatorCode<OpType::TmpTmp> gt_tmp_tmp_code {recreateBinaryOperator, nullptr};
+OperatorCode<OpType::TmpStr> gt_tmp_str_code {recreateBinaryOperator, executeCompareTmpStr<gt>};
+OperatorCode<OpType::StrTmp> gt_str_tmp_code {recreateBinaryOperator, executeCompareStrTmp<gt>};
+OperatorCode<OpType::TmpTmp> gt_tmp_tmp_code {recreateBinaryOperator, executeCompareTmpTmp<gt>};
 
 CompOperatorCodes gt_codes {
     Precedence::Relation, ">",
@@ -157,9 +159,9 @@ inline bool le(int32_t lhs, int32_t rhs)
     return lhs <= rhs;
 }
 
-inline bool le(const std::string *lhs, const std::string *rhs)
+inline bool le(StringView lhs, StringView rhs)
 {
-    return *lhs <= *rhs;
+    return compareStrings(lhs, rhs) <= 0;
 }
 
 OperatorCode<OpType::DblDbl> le_dbl_dbl_code {recreateBinaryOperator, executeCompareDblDbl<le>};
@@ -167,9 +169,9 @@ OperatorCode<OpType::IntDbl> le_int_dbl_code {recreateBinaryOperator, executeCom
 OperatorCode<OpType::DblInt> le_dbl_int_code {recreateBinaryOperator, executeCompareDblInt<le>};
 OperatorCode<OpType::IntInt> le_int_int_code {recreateBinaryOperator, executeCompareIntInt<le>};
 OperatorCode<OpType::StrStr> le_str_str_code {recreateBinaryOperator, executeCompareStrStr<le>};
-OperatorCode<OpType::TmpStr> le_tmp_str_code {recreateBinaryOperator, nullptr};
-OperatorCode<OpType::StrTmp> le_str_tmp_code {recreateBinaryOperator, nullptr};
-OperatorCode<OpType::TmpTmp> le_tmp_tmp_code {recreateBinaryOperator, nullptr};
+OperatorCode<OpType::TmpStr> le_tmp_str_code {recreateBinaryOperator, executeCompareTmpStr<le>};
+OperatorCode<OpType::StrTmp> le_str_tmp_code {recreateBinaryOperator, executeCompareStrTmp<le>};
+OperatorCode<OpType::TmpTmp> le_tmp_tmp_code {recreateBinaryOperator, executeCompareTmpTmp<le>};
 
 CompOperatorCodes le_codes {
     Precedence::Relation, "<=",
@@ -189,9 +191,9 @@ inline bool ge(int32_t lhs, int32_t rhs)
     return lhs >= rhs;
 }
 
-inline bool ge(const std::string *lhs, const std::string *rhs)
+inline bool ge(StringView lhs, StringView rhs)
 {
-    return *lhs >= *rhs;
+    return compareStrings(lhs, rhs) >= 0;
 }
 
 OperatorCode<OpType::DblDbl> ge_dbl_dbl_code {recreateBinaryOperator, executeCompareDblDbl<ge>};
@@ -199,9 +201,9 @@ OperatorCode<OpType::IntDbl> ge_int_dbl_code {recreateBinaryOperator, executeCom
 OperatorCode<OpType::DblInt> ge_dbl_int_code {recreateBinaryOperator, executeCompareDblInt<ge>};
 OperatorCode<OpType::IntInt> ge_int_int_code {recreateBinaryOperator, executeCompareIntInt<ge>};
 OperatorCode<OpType::StrStr> ge_str_str_code {recreateBinaryOperator, executeCompareStrStr<ge>};
-OperatorCode<OpType::TmpStr> ge_tmp_str_code {recreateBinaryOperator, nullptr};
-OperatorCode<OpType::StrTmp> ge_str_tmp_code {recreateBinaryOperator, nullptr};
-OperatorCode<OpType::TmpTmp> ge_tmp_tmp_code {recreateBinaryOperator, nullptr};
+OperatorCode<OpType::TmpStr> ge_tmp_str_code {recreateBinaryOperator, executeCompareTmpStr<ge>};
+OperatorCode<OpType::StrTmp> ge_str_tmp_code {recreateBinaryOperator, executeCompareStrTmp<ge>};
+OperatorCode<OpType::TmpTmp> ge_tmp_tmp_code {recreateBinaryOperator, executeCompareTmpTmp<ge>};
 
 CompOperatorCodes ge_codes {
     Precedence::Relation, ">=",
@@ -221,9 +223,9 @@ inline bool eq(int32_t lhs, int32_t rhs)
     return lhs == rhs;
 }
 
-inline bool eq(const std::string *lhs, const std::string *rhs)
+inline bool eq(StringView lhs, StringView rhs)
 {
-    return *lhs == *rhs;
+    return equalStrings(lhs, rhs);
 }
 
 OperatorCode<OpType::DblDbl> eq_dbl_dbl_code {recreateBinaryOperator, executeCompareDblDbl<eq>};
@@ -231,9 +233,9 @@ OperatorCode<OpType::IntDbl> eq_int_dbl_code {recreateBinaryOperator, executeCom
 OperatorCode<OpType::DblInt> eq_dbl_int_code {recreateBinaryOperator, executeCompareDblInt<eq>};
 OperatorCode<OpType::IntInt> eq_int_int_code {recreateBinaryOperator, executeCompareIntInt<eq>};
 OperatorCode<OpType::StrStr> eq_str_str_code {recreateBinaryOperator, executeCompareStrStr<eq>};
-OperatorCode<OpType::TmpStr> eq_tmp_str_code {recreateBinaryOperator, nullptr};
-OperatorCode<OpType::StrTmp> eq_str_tmp_code {recreateBinaryOperator, nullptr};
-OperatorCode<OpType::TmpTmp> eq_tmp_tmp_code {recreateBinaryOperator, nullptr};
+OperatorCode<OpType::TmpStr> eq_tmp_str_code {recreateBinaryOperator, executeCompareTmpStr<eq>};
+OperatorCode<OpType::StrTmp> eq_str_tmp_code {recreateBinaryOperator, executeCompareStrTmp<eq>};
+OperatorCode<OpType::TmpTmp> eq_tmp_tmp_code {recreateBinaryOperator, executeCompareTmpTmp<eq>};
 
 CompOperatorCodes eq_codes {
     Precedence::Equality, "=",
@@ -253,9 +255,9 @@ inline bool ne(int32_t lhs, int32_t rhs)
     return lhs != rhs;
 }
 
-inline bool ne(const std::string *lhs, const std::string *rhs)
+inline bool ne(StringView lhs, StringView rhs)
 {
-    return *lhs != *rhs;
+    return !equalStrings(lhs, rhs);
 }
 
 OperatorCode<OpType::DblDbl> ne_dbl_dbl_code {recreateBinaryOperator, executeCompareDblDbl<ne>};
@@ -263,12 +265,61 @@ OperatorCode<OpType::IntDbl> ne_int_dbl_code {recreateBinaryOperator, executeCom
 OperatorCode<OpType::DblInt> ne_dbl_int_code {recreateBinaryOperator, executeCompareDblInt<ne>};
 OperatorCode<OpType::IntInt> ne_int_int_code {recreateBinaryOperator, executeCompareIntInt<ne>};
 OperatorCode<OpType::StrStr> ne_str_str_code {recreateBinaryOperator, executeCompareStrStr<ne>};
-OperatorCode<OpType::TmpStr> ne_tmp_str_code {recreateBinaryOperator, nullptr};
-OperatorCode<OpType::StrTmp> ne_str_tmp_code {recreateBinaryOperator, nullptr};
-OperatorCode<OpType::TmpTmp> ne_tmp_tmp_code {recreateBinaryOperator, nullptr};
+OperatorCode<OpType::TmpStr> ne_tmp_str_code {recreateBinaryOperator, executeCompareTmpStr<ne>};
+OperatorCode<OpType::StrTmp> ne_str_tmp_code {recreateBinaryOperator, executeCompareStrTmp<ne>};
+OperatorCode<OpType::TmpTmp> ne_tmp_tmp_code {recreateBinaryOperator, executeCompareTmpTmp<ne>};
 
 CompOperatorCodes ne_codes {
     Precedence::Equality, "<>",
     ne_dbl_dbl_code, ne_int_dbl_code, ne_dbl_int_code, ne_int_int_code,
     ne_str_str_code, ne_tmp_str_code, ne_str_tmp_code, ne_tmp_tmp_code
 };
+
+// ----------------------------------------
+
+// fused codes for an integer constant and comparison, and an integer comparison and AND or OR
+
+extern Code const_int_code;
+extern OperatorCode<OpType::IntInt> and_code;
+extern OperatorCode<OpType::IntInt> or_code;
+
+void executeAnd(Executer &executer);
+void executeOr(Executer &executer);
+
+FusedCode const_int_lt_int_int_code {const_int_code, lt_int_int_code,
+    executeConstIntFused<executeCompareIntInt<lt>>};
+FusedCode const_int_gt_int_int_code {const_int_code, gt_int_int_code,
+    executeConstIntFused<executeCompareIntInt<gt>>};
+FusedCode const_int_le_int_int_code {const_int_code, le_int_int_code,
+    executeConstIntFused<executeCompareIntInt<le>>};
+FusedCode const_int_ge_int_int_code {const_int_code, ge_int_int_code,
+    executeConstIntFused<executeCompareIntInt<ge>>};
+FusedCode const_int_eq_int_int_code {const_int_code, eq_int_int_code,
+    executeConstIntFused<executeCompareIntInt<eq>>};
+FusedCode const_int_ne_int_int_code {const_int_code, ne_int_int_code,
+    executeConstIntFused<executeCompareIntInt<ne>>};
+
+FusedCode lt_int_int_and_code {lt_int_int_code, and_code,
+    executeFused<executeCompareIntInt<lt>, executeAnd>};
+FusedCode lt_int_int_or_code {lt_int_int_code, or_code,
+    executeFused<executeCompareIntInt<lt>, executeOr>};
+FusedCode gt_int_int_and_code {gt_int_int_code, and_code,
+    executeFused<executeCompareIntInt<gt>, executeAnd>};
+FusedCode gt_int_int_or_code {gt_int_int_code, or_code,
+    executeFused<executeCompareIntInt<gt>, executeOr>};
+FusedCode le_int_int_and_code {le_int_int_code, and_code,
+    executeFused<executeCompareIntInt<le>, executeAnd>};
+FusedCode le_int_int_or_code {le_int_int_code, or_code,
+    executeFused<executeCompareIntInt<le>, executeOr>};
+FusedCode ge_int_int_and_code {ge_int_int_code, and_code,
+    executeFused<executeCompareIntInt<ge>, executeAnd>};
+FusedCode ge_int_int_or_code {ge_int_int_code, or_code,
+    executeFused<executeCompareIntInt<ge>, executeOr>};
+FusedCode eq_int_int_and_code {eq_int_int_code, and_code,
+    executeFused<executeCompareIntInt<eq>, executeAnd>};
+FusedCode eq_int_int_or_code {eq_int_int_code, or_code,
+    executeFused<executeCompareIntInt<eq>, executeOr>};
+FusedCode ne_int_int_and_code {ne_int_int_code, and_code,
+    executeFused<executeCompareIntInt<ne>, executeAnd>};
+FusedCode ne_int_int_or_code {ne_int_int_code, or_code,
+    executeFused<executeCompareIntInt<ne>, executeOr>};
@@ -9,6 +9,7 @@
 #include "compileerror.h"
 #include "constnum.h"
 #include "executer.h"
+#include "numberformat.h"
 #include "overflow.h"
 #include "recreator.h"
 
@@ -16,7 +17,7 @@
 void recreateConstNum(Recreator &recreator)
 {
     auto number = recreator.getConstNumOperand();
-    recreator.push(number);
+    recreator.push(number.str());
 }
 
 void executeConstDbl(Executer &executer)
@@ -31,8 +32,76 @@ void executeConstInt(Executer &executer)
     executer.pushConstInt(operand);
 }
 
-Code const_dbl_code {recreateConstNum, executeConstDbl};
-Code const_int_code {recreateConstNum, executeConstInt};
+Code const_dbl_code {"ConstDbl", recreateConstNum, executeConstDbl,
+    pushes(DataType::Double()), OneOperand};
+Code const_int_code {"ConstInt", recreateConstNum, executeConstInt,
+    pushes(DataType::Integer()), OneOperand};
+
+// the long constant codes are only used for constants with an index too large for one word
+
+void recreateLongConstNum(Recreator &recreator)
+{
+    auto number = recreator.getLongConstNumOperand();
+    recreator.push(number.str());
+}
+
+void executeConstDblLong(Executer &executer)
+{
+    auto operand = executer.getLongOperand();
+    executer.pushConstDbl(operand);
+}
+
+void executeConstIntLong(Executer &executer)
+{
+    auto operand = executer.getLongOperand();
+    executer.pushConstInt(operand);
+}
+
+Code const_dbl_long_code {"ConstDblLong", recreateLongConstNum, executeConstDblLong,
+    pushes(DataType::Double()), LongOperandWords};
+Code const_int_long_code {"ConstIntLong", recreateLongConstNum, executeConstIntLong,
+    pushes(DataType::Integer()), LongOperandWords};
+
+// a folded constant is the result of an expression of constants evaluated at compile time,
+// the second operand is the folded expression, which is only used to recreate the expression
+
+void executeFoldedDbl(Executer &executer)
+{
+    auto operand = executer.getOperand();
+    executer.skipOperand();
+    executer.pushConstDbl(operand);
+}
+
+void executeFoldedInt(Executer &executer)
+{
+    auto operand = executer.getOperand();
+    executer.skipOperand();
+    executer.pushConstInt(operand);
+}
+
+Code folded_dbl_code {"FoldedDbl", recreateFoldedExpression, executeFoldedDbl,
+    pushes(DataType::Double()), TwoOperands};
+Code folded_int_code {"FoldedInt", recreateFoldedExpression, executeFoldedInt,
+    pushes(DataType::Integer()), TwoOperands};
+
+void executeFoldedDblLong(Executer &executer)
+{
+    auto operand = executer.getLongOperand();
+    executer.skipLongOperand();
+    executer.pushConstDbl(operand);
+}
+
+void executeFoldedIntLong(Executer &executer)
+{
+    auto operand = executer.getLongOperand();
+    executer.skipLongOperand();
+    executer.pushConstInt(operand);
+}
+
+Code folded_dbl_long_code {"FoldedDblLong", recreateLongFoldedExpression, executeFoldedDblLong,
+    pushes(DataType::Double()), 2 * LongOperandWords};
+Code folded_int_long_code {"FoldedIntLong", recreateLongFoldedExpression, executeFoldedIntLong,
+    pushes(DataType::Integer()), 2 * LongOperandWords};
 
 class ConstNumConverter {
 public:
@@ -62,12 +131,47 @@ ConstNumCodeInfo ConstNumDictionary::add(bool floating_point, const std::string
     return const_num_code_info;
 }
 
-bool ConstNumDictionary::convertibleToInteger(WordType index) const
+// adds a number with values that were previously converted (by a program that was saved)
+unsigned ConstNumDictionary::add(StringView number, double dbl_value, int32_t int_value)
+{
+    auto entry = Dictionary::add(number);
+    if (!entry.exists) {
+        dbl_values.push_back(dbl_value);
+        int_values.push_back(int_value);
+    }
+    return entry.operand;
+}
+
+// adds the result of an expression of constants (evaluated at compile time) with its exact
+// format as the number, so that equal results are one entry and no number needs converting
+unsigned ConstNumDictionary::add(double value)
+{
+    char number[MaximumExactDoubleLength];
+    auto length = formatExactDouble(number, value);
+    return add(StringView {number, length}, value, static_cast<int32_t>(std::lround(value)));
+}
+
+unsigned ConstNumDictionary::add(int32_t value)
+{
+    char number[MaximumIntegerLength];
+    auto length = formatInteger(number, value);
+    return add(StringView {number, length}, value, value);
+}
+
+bool ConstNumDictionary::convertibleToInteger(unsigned index) const
 {
     return withinIntegerRange(dbl_values[index]);
 }
 
-WordType ConstNumDictionary::addToDictionary(const ConstNumConverter &converter,
+Dictionary::MemoryUsage ConstNumDictionary::getMemoryUsage() const
+{
+    auto memory_usage = Dictionary::getMemoryUsage();
+    memory_usage.values = dbl_values.capacity() * sizeof(double)
+        + int_values.capacity() * sizeof(int32_t);
+    return memory_usage;
+}
+
+unsigned ConstNumDictionary::addToDictionary(const ConstNumConverter &converter,
     const std::string &number)
 {
     auto entry = Dictionary::add(number);
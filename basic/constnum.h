@@ -19,12 +19,16 @@ class ConstNumConverter;
 class ConstNumDictionary : public Dictionary {
 public:
     ConstNumCodeInfo add(bool floating_point, const std::string &number);
-    bool convertibleToInteger(WordType index) const;
+    unsigned add(StringView number, double dbl_value, int32_t int_value);
+    unsigned add(double value);
+    unsigned add(int32_t value);
+    bool convertibleToInteger(unsigned index) const;
+    MemoryUsage getMemoryUsage() const;
     const double *getDblValues() const;
     const int32_t *getIntValues() const;
 
 private:
-    WordType addToDictionary(const ConstNumConverter &converter, const std::string &number);
+    unsigned addToDictionary(const ConstNumConverter &converter, const std::string &number);
 
     std::vector<double> dbl_values;
     std::vector<int32_t> int_values;
@@ -45,7 +49,7 @@ class Code;
 
 struct ConstNumCodeInfo {
     WordType code_value;
-    WordType operand;
+    unsigned operand;
     DataType data_type;
 };
 
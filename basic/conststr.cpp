@@ -11,20 +11,16 @@
 #include "recreator.h"
 
 
-WordType ConstStrDictionary::add(const std::string &string)
+unsigned ConstStrDictionary::add(StringView string)
 {
-    auto entry = Dictionary::add(string);
-    if (!entry.exists) {
-        str_values.emplace_back(new std::string(string));
-    }
-    return entry.operand;
+    return Dictionary::add(string).operand;
 }
 
 
-void recreateConstStr(Recreator &recreator)
+void recreateQuotedString(Recreator &recreator, StringView operand)
 {
     auto string = std::string {'"'};
-    for (auto c : recreator.getConstStrOperand()) {
+    for (auto c : operand) {
         string += c;
         if (c == '"') {
             string += c;
@@ -34,10 +30,50 @@ void recreateConstStr(Recreator &recreator)
     recreator.push(string);
 }
 
+void recreateConstStr(Recreator &recreator)
+{
+    recreateQuotedString(recreator, recreator.getConstStrOperand());
+}
+
 void executeConstStr(Executer &executer)
 {
     auto operand = executer.getOperand();
     executer.pushConstStr(operand);
 }
 
-Code const_str_code {recreateConstStr, executeConstStr};
+Code const_str_code {"ConstStr", recreateConstStr, executeConstStr,
+    pushes(DataType::String()), OneOperand};
+
+void recreateLongConstStr(Recreator &recreator)
+{
+    recreateQuotedString(recreator, recreator.getLongConstStrOperand());
+}
+
+void executeConstStrLong(Executer &executer)
+{
+    auto operand = executer.getLongOperand();
+    executer.pushConstStr(operand);
+}
+
+Code const_str_long_code {"ConstStrLong", recreateLongConstStr, executeConstStrLong,
+    pushes(DataType::String()), LongOperandWords};
+
+void executeFoldedStr(Executer &executer)
+{
+    auto operand = executer.getOperand();
+    executer.skipOperand();
+    executer.pushConstStr(operand);
+}
+
+Code folded_str_code {"FoldedStr", recreateFoldedExpression, executeFoldedStr,
+    pushes(DataType::String()), TwoOperands};
+
+void executeFoldedStrLong(Executer &executer)
+{
+    auto operand = executer.getLongOperand();
+    executer.skipLongOperand();
+    executer.pushConstStr(operand);
+}
+
+Code folded_str_long_code {"FoldedStrLong", recreateLongFoldedExpression, executeFoldedStrLong,
+    pushes(DataType::String()), 2 * LongOperandWords};
@@ -8,24 +8,14 @@
 #ifndef IBC_CONSTSTR_H
 #define IBC_CONSTSTR_H
 
-#include <memory>
-
 #include "dictionary.h"
 
 
+// the executer gets the string constants from the characters and offsets of the dictionary
 class ConstStrDictionary : public Dictionary {
 public:
-    WordType add(const std::string &string);
-    const std::unique_ptr<std::string> *getStrValues() const;
-
-private:
-    std::vector<std::unique_ptr<std::string>> str_values;
+    unsigned add(StringView string);
 };
 
-inline const std::unique_ptr<std::string> *ConstStrDictionary::getStrValues() const
-{
-    return str_values.data();
-}
-
 
 #endif  // IBC_CONSTSTR_H
@@ -31,6 +31,5 @@ void recreateEnd(Recreator &recreator)
 
 void executeEnd(Executer &executer)
 {
-    (void)executer;
-    throw EndOfProgram {};
+    executer.stop();
 }
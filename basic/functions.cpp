@@ -13,6 +13,12 @@ bool FunctionCodes::argumentOptional() const
     return false;
 }
 
+// a foldable function always returns the same result for the same arguments
+bool FunctionCodes::foldable() const
+{
+    return true;
+}
+
 // ----------------------------------------
 
 MultiTypeFunctionCodes::MultiTypeFunctionCodes(const char *keyword,
@@ -20,6 +26,8 @@ MultiTypeFunctionCodes::MultiTypeFunctionCodes(const char *keyword,
     dbl_code {dbl_code},
     int_code {int_code}
 {
+    dbl_code.setResultDataType(DataType::Double());
+    int_code.setResultDataType(DataType::Integer());
     Table::addNumFunctionCodes(*this, keyword);
 }
 
@@ -33,9 +41,9 @@ DataType MultiTypeFunctionCodes::argumentDataType() const
     return {};
 }
 
-FunctionCodes::Info MultiTypeFunctionCodes::select(std::vector<DataType> argument_data_types) const
+FunctionCodes::Info MultiTypeFunctionCodes::select(DataType argument_data_type) const
 {
-    if (argument_data_types.front().isDouble()) {
+    if (argument_data_type.isDouble()) {
         return FunctionCodes::Info {dbl_code, DataType::Double()};
     } else {
         return FunctionCodes::Info {int_code, DataType::Integer()};
@@ -47,6 +55,7 @@ FunctionCodes::Info MultiTypeFunctionCodes::select(std::vector<DataType> argumen
 MathFunctionCodes::MathFunctionCodes(const char *keyword, FunctionCode<ArgType::Dbl> &code) :
     code {code}
 {
+    code.setResultDataType(DataType::Double());
     Table::addNumFunctionCodes(*this, keyword);
 }
 
@@ -60,9 +69,9 @@ DataType MathFunctionCodes::argumentDataType() const
     return DataType::Double();
 }
 
-FunctionCodes::Info MathFunctionCodes::select(std::vector<DataType> unused_data_types) const
+FunctionCodes::Info MathFunctionCodes::select(DataType unused_data_type) const
 {
-    (void)unused_data_types;
+    (void)unused_data_type;
     return FunctionCodes::Info {code, DataType::Double()};
 }
 
@@ -73,6 +82,7 @@ ConvertFunctionCodes::ConvertFunctionCodes(const char *keyword, FunctionCode<Arg
     argument_data_type {DataType::Integer()},
     return_data_type {DataType::Double()}
 {
+    code.setResultDataType(return_data_type);
     Table::addNumFunctionCodes(*this, keyword);
 }
 
@@ -81,6 +91,7 @@ ConvertFunctionCodes::ConvertFunctionCodes(const char *keyword, FunctionCode<Arg
     argument_data_type {DataType::Double()},
     return_data_type {DataType::Integer()}
 {
+    code.setResultDataType(return_data_type);
     Table::addNumFunctionCodes(*this, keyword);
 }
 
@@ -94,9 +105,9 @@ DataType ConvertFunctionCodes::argumentDataType() const
     return argument_data_type;
 }
 
-FunctionCodes::Info ConvertFunctionCodes::select(std::vector<DataType> unused_data_types) const
+FunctionCodes::Info ConvertFunctionCodes::select(DataType unused_data_type) const
 {
-    (void)unused_data_types;
+    (void)unused_data_type;
     return FunctionCodes::Info {code, return_data_type};
 }
 
@@ -107,6 +118,8 @@ RandomFunctionCodes::RandomFunctionCodes(const char *keyword,
     none_code {none_code},
     int_code {int_code}
 {
+    none_code.setResultDataType(DataType::Double());
+    int_code.setResultDataType(DataType::Integer());
     Table::addNumFunctionCodes(*this, keyword);
 }
 
@@ -120,14 +133,19 @@ bool RandomFunctionCodes::argumentOptional() const
     return true;
 }
 
+bool RandomFunctionCodes::foldable() const
+{
+    return false;
+}
+
 DataType RandomFunctionCodes::argumentDataType() const
 {
     return {};
 }
 
-FunctionCodes::Info RandomFunctionCodes::select(std::vector<DataType> argument_data_types) const
+FunctionCodes::Info RandomFunctionCodes::select(DataType argument_data_type) const
 {
-    if (argument_data_types.empty()) {
+    if (!argument_data_type) {
         return FunctionCodes::Info {none_code, DataType::Double()};
     } else {
         return FunctionCodes::Info {int_code, DataType::Integer()};
@@ -20,12 +20,35 @@ enum class ArgType {
 };
 
 
+constexpr int functionStackEffect(ArgType arg_type)
+{
+    return arg_type == ArgType::None ? PushesOperand : 0;
+}
+
+
+inline DataType functionArgumentDataType(ArgType arg_type)
+{
+    switch (arg_type) {
+    case ArgType::Dbl:
+        return DataType::Double();
+    case ArgType::Int:
+        return DataType::Integer();
+    case ArgType::None:
+        return {};
+    }
+    return {};
+}
+
+
 template <ArgType arg_type>
 class FunctionCode : public Code {
 public:
     FunctionCode(RecreateFunctionPointer recreate_function,
             ExecuteFunctionPointer execute_function) :
-        Code(recreate_function, execute_function) { }
+        Code(recreate_function, execute_function, functionStackEffect(arg_type))
+    {
+        setOperandDataTypes(functionArgumentDataType(arg_type));
+    }
 };
 
 
@@ -37,8 +60,10 @@ public:
     };
 
     virtual bool argumentOptional() const;
+    virtual bool foldable() const;
     virtual DataType argumentDataType() const = 0;
-    virtual Info select(std::vector<DataType> argument_data_types) const = 0;
+    // functions have at most one argument, the data type is empty when there is no argument
+    virtual Info select(DataType argument_data_type) const = 0;
 };
 
 
@@ -47,7 +72,7 @@ public:
     MultiTypeFunctionCodes(const char *keyword, FunctionCode<ArgType::Dbl> &dbl_code,
         FunctionCode<ArgType::Int> &int_code);
     std::vector<WordType> codeValues() const override;
-    Info select(std::vector<DataType> argument_data_types) const override;
+    Info select(DataType argument_data_type) const override;
     DataType argumentDataType() const override;
 
 private:
@@ -61,7 +86,7 @@ public:
     MathFunctionCodes(const char *keyword, FunctionCode<ArgType::Dbl> &code);
     std::vector<WordType> codeValues() const override;
     DataType argumentDataType() const override;
-    Info select(std::vector<DataType> unused_data_types) const override;
+    Info select(DataType unused_data_type) const override;
 
 private:
     FunctionCode<ArgType::Dbl> &code;
@@ -74,7 +99,7 @@ public:
     ConvertFunctionCodes(const char *keyword, FunctionCode<ArgType::Dbl> &code);
     std::vector<WordType> codeValues() const override;
     DataType argumentDataType() const override;
-    Info select(std::vector<DataType> unused_data_types) const override;
+    Info select(DataType unused_data_type) const override;
 
 private:
     Code &code;
@@ -89,8 +114,9 @@ public:
         FunctionCode<ArgType::Int> &int_code);
     std::vector<WordType> codeValues() const override;
     bool argumentOptional() const override;
+    bool foldable() const override;
     DataType argumentDataType() const override;
-    Info select(std::vector<DataType> argument_data_types) const override;
+    Info select(DataType argument_data_type) const override;
 
 
 private:
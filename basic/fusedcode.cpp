@@ -0,0 +1,81 @@
+/* vim:ts=4:sw=4:et:sts=4:
+ *
+ * Copyright 2016 Thunder422.  All rights reserved.
+ * Distributed under GNU General Public License Version 3
+ * (See accompanying file LICENSE or <http://www.gnu.org/licenses/>)
+ */
+
+#include "fusedcode.h"
+#include "recreator.h"
+
+
+std::vector<FusedCode *> &FusedCode::fusedCodes()
+{
+    static std::vector<FusedCode *> fused_codes;
+    return fused_codes;
+}
+
+std::map<FusedCode::CodeValuePair, FusedCode *> &FusedCode::fusedPairs()
+{
+    static std::map<CodeValuePair, FusedCode *> fused_pairs;
+    return fused_pairs;
+}
+
+std::map<WordType, FusedCode *> &FusedCode::fusedValues()
+{
+    static std::map<WordType, FusedCode *> fused_values;
+    return fused_values;
+}
+
+// the codes being fused may be defined in other source files and may not be constructed yet
+// when a fused code is constructed, so the fused code information is set up on first use
+// (by the initialization of a local static, which is done once even when used by many threads);
+// a fused code is named by the codes fused, so a fused code of a fused code follows it
+void FusedCode::initialize()
+{
+    static bool initialized = setupFusedCodes();
+    (void)initialized;
+}
+
+bool FusedCode::setupFusedCodes()
+{
+    for (auto fused_code : fusedCodes()) {
+        auto &first_code = fused_code->first_code;
+        auto &second_code = fused_code->second_code;
+        fused_code->setStackInfo(first_code, second_code);
+        fused_code->setName(first_code.getName() + '+' + second_code.getName());
+        CodeValuePair code_values {first_code.getValue(), second_code.getValue()};
+        fusedPairs()[code_values] = fused_code;
+        fusedValues()[fused_code->getValue()] = fused_code;
+    }
+    return true;
+}
+
+Code *FusedCode::find(WordType first_code_value, WordType second_code_value)
+{
+    initialize();
+    auto it = fusedPairs().find(CodeValuePair {first_code_value, second_code_value});
+    return it == fusedPairs().end() ? nullptr : it->second;
+}
+
+const FusedCode &FusedCode::get(WordType code_value)
+{
+    initialize();
+    return *fusedValues().at(code_value);
+}
+
+bool FusedCode::isFused(WordType code_value)
+{
+    initialize();
+    return fusedValues().count(code_value) != 0;
+}
+
+
+FusedCode::FusedCode(Code &first_code, Code &second_code,
+        ExecuteFunctionPointer execute_function) :
+    Code {recreateFusedCode, execute_function},
+    first_code {first_code},
+    second_code {second_code}
+{
+    fusedCodes().emplace_back(this);
+}
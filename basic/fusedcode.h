@@ -0,0 +1,88 @@
+/* vim:ts=4:sw=4:et:sts=4:
+ *
+ * Copyright 2016 Thunder422.  All rights reserved.
+ * Distributed under GNU General Public License Version 3
+ * (See accompanying file LICENSE or <http://www.gnu.org/licenses/>)
+ */
+
+#ifndef IBC_FUSEDCODE_H
+#define IBC_FUSEDCODE_H
+
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "code.h"
+#include "executer.h"
+
+
+// a fused code executes two codes with a single dispatch, the operands of both codes follow it;
+// only one of the two codes may generate a run error since both are at the same offset;
+// fused codes are only defined for the most common sequences reported by ibc-codestats
+// since each one takes a code value from the fixed number of labels of the executer
+
+class FusedCode : public Code {
+public:
+    static Code *find(WordType first_code_value, WordType second_code_value);
+    static const FusedCode &get(WordType code_value);
+    static bool isFused(WordType code_value);
+    static void initialize();
+
+    FusedCode(Code &first_code, Code &second_code, ExecuteFunctionPointer execute_function);
+    const Code &getFirstCode() const;
+    const Code &getSecondCode() const;
+
+private:
+    using CodeValuePair = std::pair<WordType, WordType>;
+
+    static bool setupFusedCodes();
+    static std::vector<FusedCode *> &fusedCodes();
+    static std::map<CodeValuePair, FusedCode *> &fusedPairs();
+    static std::map<WordType, FusedCode *> &fusedValues();
+
+    Code &first_code;
+    Code &second_code;
+};
+
+
+inline const Code &FusedCode::getFirstCode() const
+{
+    return first_code;
+}
+
+inline const Code &FusedCode::getSecondCode() const
+{
+    return second_code;
+}
+
+// ----------------------------------------
+
+template <ExecuteFunctionPointer execute_first, ExecuteFunctionPointer execute_second>
+void executeFused(Executer &executer)
+{
+    execute_first(executer);
+    if (executer.isRunning()) {
+        execute_second(executer);
+    }
+}
+
+// the constant operand is skipped after the second code so a run error is at the fused code
+
+template <ExecuteFunctionPointer execute_second>
+void executeConstDblFused(Executer &executer)
+{
+    executer.pushConstDbl(executer.peekOperand());
+    execute_second(executer);
+    executer.skipOperand();
+}
+
+template <ExecuteFunctionPointer execute_second>
+void executeConstIntFused(Executer &executer)
+{
+    executer.pushConstInt(executer.peekOperand());
+    execute_second(executer);
+    executer.skipOperand();
+}
+
+
+#endif  // IBC_FUSEDCODE_H
@@ -22,8 +22,7 @@ void executeAbsDbl(Executer &executer)
 void executeAbsInt(Executer &executer)
 {
     auto argument = executer.topInt();
-    if (argument < 0) {
-        checkNegativeIntegerOverflow(executer, argument);
+    if (argument < 0 && checkNegativeIntegerOverflow(executer, argument)) {
         executer.setTop(-argument);
     }
 }
@@ -69,7 +68,8 @@ void executeSqr(Executer &executer)
 {
     auto argument = executer.topDbl();
     if (argument < 0) {
-        throw RunError {"square root of negative number", executer.currentOffset()};
+        executer.setRunError("square root of negative number");
+        return;
     }
     executer.setTop(std::sqrt(argument));
 }
@@ -162,7 +162,8 @@ void executeLog(Executer &executer)
 {
     auto argument = executer.topDbl();
     if (argument <= 0) {
-        throw RunError {"logarithm of non-positive number", executer.currentOffset()};
+        executer.setRunError("logarithm of non-positive number");
+        return;
     }
     executer.setTop(std::log(argument));
 }
@@ -176,8 +177,9 @@ MathFunctionCodes log_codes {"LOG", log_code};
 void executeExp(Executer &executer)
 {
     auto result = std::exp(executer.topDbl());
-    checkForOverflow(executer, result);
-    executer.setTop(result);
+    if (checkForOverflow(executer, result)) {
+        executer.setTop(result);
+    }
 }
 
 FunctionCode<ArgType::Dbl> exp_code {recreateFunctionWithOneArgument, executeExp};
@@ -191,7 +193,8 @@ void executeCvtDbl(Executer &executer)
     executer.setTop(executer.topIntAsDbl());
 }
 
-Code cvtdbl_code {recreateNothing, executeCvtDbl};
+Code cvtdbl_code {"CvtDbl", recreateNothing, executeCvtDbl,
+    converts(DataType::Integer(), DataType::Double())};
 
 FunctionCode<ArgType::Int> cdbl_code {recreateFunctionWithOneArgument, executeCvtDbl};
 
@@ -202,8 +205,9 @@ ConvertFunctionCodes cdbl_codes {"CDBL", cdbl_code};
 void executeCvtInt(Executer &executer)
 {
     auto operand = std::round(executer.topDbl());
-    checkIntegerOverflow(executer, operand);
-    executer.setTopIntFromDouble(operand);
+    if (checkIntegerOverflow(executer, operand)) {
+        executer.setTopIntFromDouble(operand);
+    }
 }
 
 void recreateCvtInt(Recreator &recreator)
@@ -211,7 +215,8 @@ void recreateCvtInt(Recreator &recreator)
     recreator.markOperandIfError();
 }
 
-Code cvtint_code {recreateCvtInt, executeCvtInt};
+Code cvtint_code {"CvtInt", recreateCvtInt, executeCvtInt,
+    converts(DataType::Double(), DataType::Integer())};
 
 FunctionCode<ArgType::Dbl> cint_code {recreateFunctionWithOneArgument, executeCvtInt};
 
@@ -228,7 +233,8 @@ void executeRndInt(Executer &executer)
 {
     auto argument = executer.topInt();
     if (argument <= 0) {
-        throw RunError {"random function on zero or negative number", executer.currentOffset()};
+        executer.setRunError("random function on zero or negative number");
+        return;
     }
     executer.setTop(executer.getRandomNumber(argument));
 }
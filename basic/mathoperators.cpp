@@ -5,7 +5,9 @@
  * (See accompanying file LICENSE or <http://www.gnu.org/licenses/>)
  */
 
+#include "commandcode.h"
 #include "executer.h"
+#include "fusedcode.h"
 #include "operators.h"
 #include "overflow.h"
 #include "powerdblint.h"
@@ -21,8 +23,9 @@ void executeNegateDbl(Executer &executer)
 void executeNegateInt(Executer &executer)
 {
     auto operand = executer.topInt();
-    checkNegativeIntegerOverflow(executer, operand);
-    executer.setTop(-operand);
+    if (checkNegativeIntegerOverflow(executer, operand)) {
+        executer.setTop(-operand);
+    }
 }
 
 OperatorCode<OpType::Dbl> neg_dbl_code {recreateUnaryOperator, executeNegateDbl};
@@ -32,7 +35,7 @@ UnaryOperatorCodes neg_codes {Precedence::Negate, "-", neg_dbl_code, neg_int_cod
 
 // ----------------------------------------
 
-inline void validatePowerResult(double x, double result, Executer &executer);
+inline bool validatePowerResult(double x, double result, Executer &executer);
 inline void calculatePowerDblDbl(Executer &executer, double x, double y);
 
 void executeExponentialDblDbl(Executer &executer)
@@ -54,21 +57,21 @@ void executeExponentialIntDbl(Executer &executer)
 inline void calculatePowerDblDbl(Executer &executer, double x, double y)
 {
     auto result = std::pow(x, y);
-    validatePowerResult(x, result, executer);
-    executer.setTop(result);
+    if (validatePowerResult(x, result, executer)) {
+        executer.setTop(result);
+    }
 }
 
-inline void validatePowerResult(double x, double result, Executer &executer)
+inline bool validatePowerResult(double x, double result, Executer &executer)
 {
     if (std::isnan(result)) {
-        throw RunError {"domain error (non-integer exponent)", executer.currentOffset()};
+        executer.setRunError("domain error (non-integer exponent)");
+        return false;
     } else if (result == HUGE_VAL) {
-        if (x == 0) {
-            throw RunError {"divide by zero", executer.currentOffset()};
-        } else {
-            throw RunError {"overflow", executer.currentOffset()};
-        }
+        executer.setRunError(x == 0 ? "divide by zero" : "overflow");
+        return false;
     }
+    return true;
 }
 
 void executeExponentialDblInt(Executer &executer)
@@ -132,8 +135,9 @@ inline void doDoubleMultiply(Executer &executer, double rhs)
 inline void multiplyAndCheckResult(Executer &executer, double lhs, double rhs)
 {
     auto result = lhs * rhs;
-    checkDoubleOverflow(executer, result);
-    executer.setTop(result);
+    if (checkDoubleOverflow(executer, result)) {
+        executer.setTop(result);
+    }
 }
 
 void executeMultiplyIntInt(Executer &executer)
@@ -142,8 +146,9 @@ void executeMultiplyIntInt(Executer &executer)
     executer.pop();
     auto result = int64_t{executer.topInt()};
     result *= rhs;
-    checkIntegerOverflow(executer, result);
-    executer.setTopIntFromInt64(result);
+    if (checkIntegerOverflow(executer, result)) {
+        executer.setTopIntFromInt64(result);
+    }
 }
 
 OperatorCode<OpType::DblDbl> mul_dbl_dbl_code {recreateBinaryOperator, executeMultiplyDblDbl};
@@ -159,66 +164,81 @@ NumOperatorCodes mul_codes {
 // ----------------------------------------
 
 template <typename T>
-void checkDivideByZero(Executer &executer, T rhs)
+bool checkDivideByZero(Executer &executer, T rhs)
 {
     if (rhs == 0) {
-        throw RunError {"divide by zero", executer.currentOffset()};
+        executer.setRunError("divide by zero");
+        return false;
     }
+    return true;
 }
 
-inline double popDoubleDivisor(Executer &executer);
-inline int32_t popIntegerDivisor(Executer &executer);
+inline bool popDoubleDivisor(Executer &executer, double &rhs);
+inline bool popIntegerDivisor(Executer &executer, int32_t &rhs);
 inline void divideAndCheckResult(Executer &executer, double lhs, double rhs);
 
 void executeDivideDblDbl(Executer &executer)
 {
-    auto rhs = popDoubleDivisor(executer);
-    auto lhs = executer.topDbl();
-    divideAndCheckResult(executer, lhs, rhs);
+    double rhs;
+    if (popDoubleDivisor(executer, rhs)) {
+        auto lhs = executer.topDbl();
+        divideAndCheckResult(executer, lhs, rhs);
+    }
 }
 
 void executeDivideIntDbl(Executer &executer)
 {
-    auto rhs = popDoubleDivisor(executer);
-    auto lhs = executer.topIntAsDbl();
-    divideAndCheckResult(executer, lhs, rhs);
+    double rhs;
+    if (popDoubleDivisor(executer, rhs)) {
+        auto lhs = executer.topIntAsDbl();
+        divideAndCheckResult(executer, lhs, rhs);
+    }
 }
 
-inline double popDoubleDivisor(Executer &executer)
+inline bool popDoubleDivisor(Executer &executer, double &rhs)
 {
-    auto rhs = executer.topDbl();
-    checkDivideByZero(executer, rhs);
+    rhs = executer.topDbl();
+    if (!checkDivideByZero(executer, rhs)) {
+        return false;
+    }
     executer.pop();
-    return rhs;
+    return true;
 }
 
 void executeDivideDblInt(Executer &executer)
 {
-    auto rhs = static_cast<double>(popIntegerDivisor(executer));
-    auto lhs = executer.topDbl();
-    auto result = lhs / rhs;
-    executer.setTop(result);
+    int32_t rhs;
+    if (popIntegerDivisor(executer, rhs)) {
+        auto lhs = executer.topDbl();
+        auto result = lhs / rhs;
+        executer.setTop(result);
+    }
 }
 
 inline void divideAndCheckResult(Executer &executer, double lhs, double rhs)
 {
     auto result = lhs / rhs;
-    checkDoubleOverflow(executer, result);
-    executer.setTop(result);
+    if (checkDoubleOverflow(executer, result)) {
+        executer.setTop(result);
+    }
 }
 
 void executeDivideIntInt(Executer &executer)
 {
-    auto rhs = popIntegerDivisor(executer);
-    executer.setTop(executer.topInt() / rhs);
+    int32_t rhs;
+    if (popIntegerDivisor(executer, rhs)) {
+        executer.setTop(executer.topInt() / rhs);
+    }
 }
 
-inline int32_t popIntegerDivisor(Executer &executer)
+inline bool popIntegerDivisor(Executer &executer, int32_t &rhs)
 {
-    auto rhs = executer.topInt();
-    checkDivideByZero(executer, rhs);
+    rhs = executer.topInt();
+    if (!checkDivideByZero(executer, rhs)) {
+        return false;
+    }
     executer.pop();
-    return rhs;
+    return true;
 }
 
 OperatorCode<OpType::DblDbl> div_dbl_dbl_code {recreateBinaryOperator, executeDivideDblDbl};
@@ -235,11 +255,14 @@ NumOperatorCodes div_codes {
 
 void executeIntegerDivide(Executer &executer)
 {
-    auto rhs = popDoubleDivisor(executer);
-    auto lhs = executer.topDbl();
-    auto result = lhs / rhs;
-    checkIntegerOverflow(executer, result);
-    executer.setTopIntFromDouble(result);
+    double rhs;
+    if (popDoubleDivisor(executer, rhs)) {
+        auto lhs = executer.topDbl();
+        auto result = lhs / rhs;
+        if (checkIntegerOverflow(executer, result)) {
+            executer.setTopIntFromDouble(result);
+        }
+    }
 }
 
 OperatorCode<OpType::DblDbl> int_div_code {recreateBinaryOperator, executeIntegerDivide};
@@ -250,29 +273,37 @@ IntDivOperatorCode int_div_codes {Precedence::IntDivide, "\\", int_div_code};
 
 void executeModuloDblDbl(Executer &executer)
 {
-    auto rhs = popDoubleDivisor(executer);
-    auto lhs = executer.topDbl();
-    executer.setTop(std::fmod(lhs, rhs));
+    double rhs;
+    if (popDoubleDivisor(executer, rhs)) {
+        auto lhs = executer.topDbl();
+        executer.setTop(std::fmod(lhs, rhs));
+    }
 }
 
 void executeModuloIntDbl(Executer &executer)
 {
-    auto rhs = popDoubleDivisor(executer);
-    auto lhs = executer.topIntAsDbl();
-    executer.setTop(std::fmod(lhs, rhs));
+    double rhs;
+    if (popDoubleDivisor(executer, rhs)) {
+        auto lhs = executer.topIntAsDbl();
+        executer.setTop(std::fmod(lhs, rhs));
+    }
 }
 
 void executeModuloDblInt(Executer &executer)
 {
-    auto rhs = static_cast<double>(popIntegerDivisor(executer));
-    auto lhs = executer.topDbl();
-    executer.setTop(std::fmod(lhs, rhs));
+    int32_t rhs;
+    if (popIntegerDivisor(executer, rhs)) {
+        auto lhs = executer.topDbl();
+        executer.setTop(std::fmod(lhs, static_cast<double>(rhs)));
+    }
 }
 
 void executeModuloIntInt(Executer &executer)
 {
-    auto rhs = popIntegerDivisor(executer);
-    executer.setTop(executer.topInt() % rhs);
+    int32_t rhs;
+    if (popIntegerDivisor(executer, rhs)) {
+        executer.setTop(executer.topInt() % rhs);
+    }
 }
 
 OperatorCode<OpType::DblDbl> mod_dbl_dbl_code {recreateBinaryOperator, executeModuloDblDbl};
@@ -292,8 +323,9 @@ void executeAddDblDbl(Executer &executer)
     auto rhs = executer.topDbl();
     executer.pop();
     auto result = executer.topDbl() + rhs;
-    checkDoubleOverflow(executer, result);
-    executer.setTop(result);
+    if (checkDoubleOverflow(executer, result)) {
+        executer.setTop(result);
+    }
 }
 
 void executeAddIntDbl(Executer &executer)
@@ -316,8 +348,9 @@ void executeAddIntInt(Executer &executer)
     executer.pop();
     auto result = int64_t{executer.topInt()};
     result += rhs;
-    checkIntegerOverflow(executer, result);
-    executer.setTopIntFromInt64(result);
+    if (checkIntegerOverflow(executer, result)) {
+        executer.setTopIntFromInt64(result);
+    }
 }
 
 OperatorCode<OpType::DblDbl> add_dbl_dbl_code {recreateBinaryOperator, executeAddDblDbl};
@@ -330,8 +363,8 @@ void executeCatStrStr(Executer &executer)
     auto rhs = executer.topStr();
     executer.pop();
 
-    executer.setTop(*executer.topStr());
-    *executer.topTmpStr() += *rhs;
+    executer.setTop(executer.topStr());
+    executer.topTmpStr()->append(rhs.data(), rhs.length());
 }
 
 void executeCatTmpStr(Executer &executer)
@@ -339,19 +372,17 @@ void executeCatTmpStr(Executer &executer)
     auto rhs = executer.topStr();
     executer.pop();
 
-    *executer.topTmpStr() += *rhs;
+    executer.topTmpStr()->append(rhs.data(), rhs.length());
 }
 
 void executeCatStrTmp(Executer &executer)
 {
-    auto rhs_result = executer.topTmpStr();
+    auto result = executer.topTmpStr();
     executer.pop();
 
-    auto lhs_rhs = std::string{*executer.topStr()};
-    std::swap(lhs_rhs, *rhs_result);
-
-    executer.setTop(rhs_result);
-    *executer.topTmpStr() += lhs_rhs;
+    auto lhs = executer.topStr();
+    result->insert(0, lhs.data(), lhs.length());
+    executer.setTop(result);
 }
 
 void executeCatTmpTmp(Executer &executer)
@@ -367,10 +398,53 @@ OperatorCode<OpType::TmpStr> cat_tmp_str_code {recreateBinaryOperator, executeCa
 OperatorCode<OpType::StrTmp> cat_str_tmp_code {recreateBinaryOperator, executeCatStrTmp};
 OperatorCode<OpType::TmpTmp> cat_tmp_tmp_code {recreateBinaryOperator, executeCatTmpTmp};
 
-NumStrOperatorCodes add_codes {
+// a chain of concatenations is one code that reserves the length of the result once and copies
+// each operand once (instead of growing the result one operand at a time), the result is the
+// first operand when it is a temporary string; temporary string operands are released
+
+StringView chainOperand(Executer &executer, const Executer::StackItem &operand, bool temporary)
+{
+    return temporary ? StringView {*operand.tmp_value} : executer.constStr(operand.str_operand);
+}
+
+void executeCatStrings(Executer &executer)
+{
+    auto operand_count = executer.getOperand();
+    auto temporaries = executer.getOperand();
+    auto operands = executer.topItems(operand_count);
+
+    std::string::size_type length = 0;
+    for (unsigned index = 0; index < operand_count; ++index) {
+        length += chainOperand(executer, operands[index],
+            isChainOperandTemporary(temporaries, index)).length();
+    }
+    unsigned index = 0;
+    std::string *result;
+    if (isChainOperandTemporary(temporaries, index)) {
+        result = operands[index++].tmp_value;
+    } else {
+        result = executer.acquireTmpStr();
+    }
+    result->reserve(length);
+    for (; index < operand_count; ++index) {
+        auto temporary = isChainOperandTemporary(temporaries, index);
+        auto operand = chainOperand(executer, operands[index], temporary);
+        result->append(operand.data(), operand.length());
+        if (temporary) {
+            executer.releaseTmpStr(operands[index].tmp_value);
+        }
+    }
+    executer.pop(operand_count - 1);
+    executer.setTop(result);
+}
+
+Code cat_strings_code {"CatStrings", recreateBinaryOperatorChain, executeCatStrings,
+    PopsChainOperands, TwoOperands};
+
+AddOperatorCodes add_codes {
     Precedence::Summation, "+",
     add_dbl_dbl_code, add_int_dbl_code, add_dbl_int_code, add_int_int_code,
-    cat_str_str_code, cat_tmp_str_code, cat_str_tmp_code, cat_tmp_tmp_code
+    cat_str_str_code, cat_tmp_str_code, cat_str_tmp_code, cat_tmp_tmp_code, cat_strings_code
 };
 
 // ----------------------------------------
@@ -380,8 +454,9 @@ void executeSubtractDblDbl(Executer &executer)
     auto rhs = executer.topDbl();
     executer.pop();
     auto result = executer.topDbl() - rhs;
-    checkDoubleOverflow(executer, result);
-    executer.setTop(result);
+    if (checkDoubleOverflow(executer, result)) {
+        executer.setTop(result);
+    }
 }
 
 void executeSubtractIntDbl(Executer &executer)
@@ -404,8 +479,9 @@ void executeSubtractIntInt(Executer &executer)
     executer.pop();
     auto result = int64_t{executer.topInt()};
     result -= rhs;
-    checkIntegerOverflow(executer, result);
-    executer.setTopIntFromInt64(result);
+    if (checkIntegerOverflow(executer, result)) {
+        executer.setTopIntFromInt64(result);
+    }
 }
 
 OperatorCode<OpType::DblDbl> sub_dbl_dbl_code {recreateBinaryOperator, executeSubtractDblDbl};
@@ -417,3 +493,76 @@ NumOperatorCodes sub_codes {
     Precedence::Summation, "-",
     sub_dbl_dbl_code, sub_int_dbl_code, sub_dbl_int_code, sub_int_int_code
 };
+
+// ----------------------------------------
+
+// fused codes for a constant and arithmetic operator, and an operator and print item (and PRINT)
+
+extern Code const_dbl_code;
+extern Code const_int_code;
+extern CommandCode print_code;
+extern Code print_dbl_code;
+extern Code print_int_code;
+
+void executePrint(Executer &executer);
+void executePrintDbl(Executer &executer);
+void executePrintInt(Executer &executer);
+
+FusedCode const_dbl_exp_dbl_dbl_code {const_dbl_code, exp_dbl_dbl_code,
+    executeConstDblFused<executeExponentialDblDbl>};
+FusedCode const_int_exp_dbl_int_code {const_int_code, exp_dbl_int_code,
+    executeConstIntFused<executeExponentialDblInt>};
+FusedCode const_int_exp_int_int_code {const_int_code, exp_int_int_code,
+    executeConstIntFused<executeExponentialIntInt>};
+FusedCode const_dbl_mul_dbl_dbl_code {const_dbl_code, mul_dbl_dbl_code,
+    executeConstDblFused<executeMultiplyDblDbl>};
+FusedCode const_int_mul_int_int_code {const_int_code, mul_int_int_code,
+    executeConstIntFused<executeMultiplyIntInt>};
+FusedCode const_dbl_div_dbl_dbl_code {const_dbl_code, div_dbl_dbl_code,
+    executeConstDblFused<executeDivideDblDbl>};
+FusedCode const_int_div_int_int_code {const_int_code, div_int_int_code,
+    executeConstIntFused<executeDivideIntInt>};
+FusedCode const_int_mod_int_int_code {const_int_code, mod_int_int_code,
+    executeConstIntFused<executeModuloIntInt>};
+FusedCode const_dbl_add_dbl_dbl_code {const_dbl_code, add_dbl_dbl_code,
+    executeConstDblFused<executeAddDblDbl>};
+FusedCode const_int_add_int_int_code {const_int_code, add_int_int_code,
+    executeConstIntFused<executeAddIntInt>};
+FusedCode const_dbl_sub_dbl_dbl_code {const_dbl_code, sub_dbl_dbl_code,
+    executeConstDblFused<executeSubtractDblDbl>};
+FusedCode const_int_sub_int_int_code {const_int_code, sub_int_int_code,
+    executeConstIntFused<executeSubtractIntInt>};
+
+FusedCode exp_int_int_print_int_code {exp_int_int_code, print_int_code,
+    executeFused<executeExponentialIntInt, executePrintInt>};
+FusedCode mul_dbl_dbl_print_dbl_code {mul_dbl_dbl_code, print_dbl_code,
+    executeFused<executeMultiplyDblDbl, executePrintDbl>};
+FusedCode mul_int_int_print_int_code {mul_int_int_code, print_int_code,
+    executeFused<executeMultiplyIntInt, executePrintInt>};
+FusedCode div_dbl_dbl_print_dbl_code {div_dbl_dbl_code, print_dbl_code,
+    executeFused<executeDivideDblDbl, executePrintDbl>};
+FusedCode add_dbl_dbl_print_dbl_code {add_dbl_dbl_code, print_dbl_code,
+    executeFused<executeAddDblDbl, executePrintDbl>};
+FusedCode add_int_int_print_int_code {add_int_int_code, print_int_code,
+    executeFused<executeAddIntInt, executePrintInt>};
+FusedCode sub_dbl_dbl_print_dbl_code {sub_dbl_dbl_code, print_dbl_code,
+    executeFused<executeSubtractDblDbl, executePrintDbl>};
+FusedCode sub_int_int_print_int_code {sub_int_int_code, print_int_code,
+    executeFused<executeSubtractIntInt, executePrintInt>};
+
+FusedCode exp_int_int_print_int_print_code {exp_int_int_print_int_code, print_code,
+    executeFused<executeFused<executeExponentialIntInt, executePrintInt>, executePrint>};
+FusedCode mul_dbl_dbl_print_dbl_print_code {mul_dbl_dbl_print_dbl_code, print_code,
+    executeFused<executeFused<executeMultiplyDblDbl, executePrintDbl>, executePrint>};
+FusedCode mul_int_int_print_int_print_code {mul_int_int_print_int_code, print_code,
+    executeFused<executeFused<executeMultiplyIntInt, executePrintInt>, executePrint>};
+FusedCode div_dbl_dbl_print_dbl_print_code {div_dbl_dbl_print_dbl_code, print_code,
+    executeFused<executeFused<executeDivideDblDbl, executePrintDbl>, executePrint>};
+FusedCode add_dbl_dbl_print_dbl_print_code {add_dbl_dbl_print_dbl_code, print_code,
+    executeFused<executeFused<executeAddDblDbl, executePrintDbl>, executePrint>};
+FusedCode add_int_int_print_int_print_code {add_int_int_print_int_code, print_code,
+    executeFused<executeFused<executeAddIntInt, executePrintInt>, executePrint>};
+FusedCode sub_dbl_dbl_print_dbl_print_code {sub_dbl_dbl_print_dbl_code, print_code,
+    executeFused<executeFused<executeSubtractDblDbl, executePrintDbl>, executePrint>};
+FusedCode sub_int_int_print_int_print_code {sub_int_int_print_int_code, print_code,
+    executeFused<executeFused<executeSubtractIntInt, executePrintInt>, executePrint>};
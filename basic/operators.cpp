@@ -8,11 +8,20 @@
 #include "operators.h"
 
 
+Code *OperatorCodes::chainCode() const
+{
+    return nullptr;
+}
+
+// ----------------------------------------
+
 UnaryOperatorCodes::UnaryOperatorCodes(Precedence precedence, const char *keyword,
         OperatorCode<OpType::Dbl> &dbl_code, OperatorCode<OpType::Int> &int_code) :
     dbl_code {dbl_code},
     int_code {int_code}
 {
+    dbl_code.setResultDataType(DataType::Double());
+    int_code.setResultDataType(DataType::Integer());
     Table::addOperatorCodes(precedence, *this, keyword);
 }
 
@@ -41,6 +50,10 @@ NumCodes::NumCodes(OperatorCode<OpType::DblDbl> &dbl_dbl_code,
     dbl_int_code {dbl_int_code},
     int_int_code {int_int_code}
 {
+    dbl_dbl_code.setResultDataType(DataType::Double());
+    int_dbl_code.setResultDataType(DataType::Double());
+    dbl_int_code.setResultDataType(DataType::Double());
+    int_int_code.setResultDataType(DataType::Integer());
 }
 
 OperatorCodes::Info NumCodes::select(DataType lhs_data_type, DataType rhs_data_type) const
@@ -94,6 +107,10 @@ StrCodes::StrCodes(OperatorCode<OpType::StrStr> &str_str_code,
     str_tmp_code {str_tmp_code},
     tmp_tmp_code {tmp_tmp_code}
 {
+    str_str_code.setResultDataType(DataType::TmpStr());
+    tmp_str_code.setResultDataType(DataType::TmpStr());
+    str_tmp_code.setResultDataType(DataType::TmpStr());
+    tmp_tmp_code.setResultDataType(DataType::TmpStr());
 }
 
 OperatorCodes::Info StrCodes::select(DataType lhs_data_type, DataType rhs_data_type) const
@@ -153,6 +170,7 @@ IntDivOperatorCode::IntDivOperatorCode(Precedence precedence, const char *keywor
         OperatorCode<OpType::DblDbl> &code) :
     code {code}
 {
+    code.setResultDataType(DataType::Integer());
     Table::addOperatorCodes(precedence, *this, keyword);
 }
 
@@ -174,6 +192,7 @@ NotOperatorCodes::NotOperatorCodes(Precedence precedence, const char *keyword,
         OperatorCode<OpType::Int> &code) :
     code {code}
 {
+    code.setResultDataType(DataType::Integer());
     Table::addOperatorCodes(precedence, *this, keyword);
 }
 
@@ -196,6 +215,7 @@ LogicOperatorCodes::LogicOperatorCodes(Precedence precedence, const char *keywor
         OperatorCode<OpType::IntInt> &code) :
     code {code}
 {
+    code.setResultDataType(DataType::Integer());
     Table::addOperatorCodes(precedence, *this, keyword);
 }
 
@@ -214,6 +234,49 @@ std::vector<WordType> LogicOperatorCodes::codeValues() const
 
 // ----------------------------------------
 
+// the concatenation code is named when defined since the codes of the keyword are named when
+// the keyword is added to the table, which is before this class is constructed
+AddOperatorCodes::AddOperatorCodes(Precedence precedence, const char *keyword,
+        OperatorCode<OpType::DblDbl> &dbl_dbl_code, OperatorCode<OpType::IntDbl> &int_dbl_code,
+        OperatorCode<OpType::DblInt> &dbl_int_code, OperatorCode<OpType::IntInt> &int_int_code,
+        OperatorCode<OpType::StrStr> &str_str_code, OperatorCode<OpType::TmpStr> &tmp_str_code,
+        OperatorCode<OpType::StrTmp> &str_tmp_code, OperatorCode<OpType::TmpTmp> &tmp_tmp_code,
+        Code &cat_strings_code) :
+    NumStrOperatorCodes {precedence, keyword, dbl_dbl_code, int_dbl_code, dbl_int_code,
+        int_int_code, str_str_code, tmp_str_code, str_tmp_code, tmp_tmp_code},
+    cat_strings_code {cat_strings_code}
+{
+    cat_strings_code.setResultDataType(DataType::TmpStr());
+}
+
+std::vector<WordType> AddOperatorCodes::codeValues() const
+{
+    auto code_values = NumStrOperatorCodes::codeValues();
+    code_values.push_back(cat_strings_code.getValue());
+    return code_values;
+}
+
+Code *AddOperatorCodes::chainCode() const
+{
+    return &cat_strings_code;
+}
+
+// ----------------------------------------
+
+// the result of a comparison is an integer for any operands
+CompOperatorCodes::CompOperatorCodes(Precedence precedence, const char *keyword,
+        OperatorCode<OpType::DblDbl> &dbl_dbl_code, OperatorCode<OpType::IntDbl> &int_dbl_code,
+        OperatorCode<OpType::DblInt> &dbl_int_code, OperatorCode<OpType::IntInt> &int_int_code,
+        OperatorCode<OpType::StrStr> &str_str_code, OperatorCode<OpType::TmpStr> &tmp_str_code,
+        OperatorCode<OpType::StrTmp> &str_tmp_code, OperatorCode<OpType::TmpTmp> &tmp_tmp_code) :
+    NumStrOperatorCodes {precedence, keyword, dbl_dbl_code, int_dbl_code, dbl_int_code,
+        int_int_code, str_str_code, tmp_str_code, str_tmp_code, tmp_tmp_code}
+{
+    for (auto code_value : codeValues()) {
+        Code::getCode(code_value)->setResultDataType(DataType::Integer());
+    }
+}
+
 OperatorCodes::Info CompOperatorCodes::select(DataType lhs_data_type, DataType rhs_data_type) const
 {
     auto info = NumStrOperatorCodes::select(lhs_data_type, rhs_data_type);
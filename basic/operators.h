@@ -8,6 +8,8 @@
 #ifndef IBC_OPERATORS_H
 #define IBC_OPERATORS_H
 
+#include <limits>
+
 #include "code.h"
 #include "codes.h"
 #include "table.h"
@@ -27,12 +29,66 @@ enum class OpType {
 };
 
 
+constexpr int operatorStackEffect(OpType op_type)
+{
+    return op_type == OpType::Dbl || op_type == OpType::Int ? 0 : PopsOperand;
+}
+
+
+inline DataType operatorLhsDataType(OpType op_type)
+{
+    switch (op_type) {
+    case OpType::Dbl:
+    case OpType::DblDbl:
+    case OpType::DblInt:
+        return DataType::Double();
+    case OpType::Int:
+    case OpType::IntDbl:
+    case OpType::IntInt:
+        return DataType::Integer();
+    case OpType::StrStr:
+    case OpType::StrTmp:
+        return DataType::String();
+    case OpType::TmpStr:
+    case OpType::TmpTmp:
+        return DataType::TmpStr();
+    }
+    return {};
+}
+
+// a unary operator only has a left hand side operand
+inline DataType operatorRhsDataType(OpType op_type)
+{
+    switch (op_type) {
+    case OpType::Dbl:
+    case OpType::Int:
+        return {};
+    case OpType::DblDbl:
+    case OpType::IntDbl:
+        return DataType::Double();
+    case OpType::DblInt:
+    case OpType::IntInt:
+        return DataType::Integer();
+    case OpType::StrStr:
+    case OpType::TmpStr:
+        return DataType::String();
+    case OpType::StrTmp:
+    case OpType::TmpTmp:
+        return DataType::TmpStr();
+    }
+    return {};
+}
+
+
 template <OpType op_type>
 class OperatorCode : public Code {
 public:
     OperatorCode(RecreateFunctionPointer recreate_function,
             ExecuteFunctionPointer execute_function) :
-        Code(recreate_function, execute_function) { }
+        Code(recreate_function, execute_function, operatorStackEffect(op_type))
+    {
+        setOperandDataTypes(operatorLhsDataType(op_type), operatorRhsDataType(op_type));
+    }
 };
 
 
@@ -44,8 +100,21 @@ public:
     };
 
     virtual Info select(DataType lhs_data_type, DataType rhs_data_type = {}) const = 0;
+    virtual Code *chainCode() const;
 };
 
+
+// a chain code is one code for a chain of the same operator with string operands, the operands
+// of the code are the number of operands of the chain and a word with a bit set for each operand
+// that is a temporary string (the bit of the first operand is the low bit)
+
+constexpr unsigned MaximumChainOperands = std::numeric_limits<WordType>::digits;
+
+inline bool isChainOperandTemporary(WordType temporaries, unsigned operand_index)
+{
+    return (temporaries >> operand_index & 1) != 0;
+}
+
 class UnaryOperatorCodes : public OperatorCodes {
 public:
     UnaryOperatorCodes(Precedence precedence, const char *keyword,
@@ -124,9 +193,29 @@ private:
 };
 
 
+class AddOperatorCodes : public NumStrOperatorCodes {
+public:
+    AddOperatorCodes(Precedence precedence, const char *keyword,
+        OperatorCode<OpType::DblDbl> &dbl_dbl_code, OperatorCode<OpType::IntDbl> &int_dbl_code,
+        OperatorCode<OpType::DblInt> &dbl_int_code, OperatorCode<OpType::IntInt> &int_int_code,
+        OperatorCode<OpType::StrStr> &str_str_code, OperatorCode<OpType::TmpStr> &tmp_str_code,
+        OperatorCode<OpType::StrTmp> &str_tmp_code, OperatorCode<OpType::TmpTmp> &tmp_tmp_code,
+        Code &cat_strings_code);
+    std::vector<WordType> codeValues() const override;
+    Code *chainCode() const override;
+
+private:
+    Code &cat_strings_code;
+};
+
+
 class CompOperatorCodes : public NumStrOperatorCodes {
 public:
-    using NumStrOperatorCodes::NumStrOperatorCodes;
+    CompOperatorCodes(Precedence precedence, const char *keyword,
+        OperatorCode<OpType::DblDbl> &dbl_dbl_code, OperatorCode<OpType::IntDbl> &int_dbl_code,
+        OperatorCode<OpType::DblInt> &dbl_int_code, OperatorCode<OpType::IntInt> &int_int_code,
+        OperatorCode<OpType::StrStr> &str_str_code, OperatorCode<OpType::TmpStr> &tmp_str_code,
+        OperatorCode<OpType::StrTmp> &str_tmp_code, OperatorCode<OpType::TmpTmp> &tmp_tmp_code);
     Info select(DataType lhs_data_type, DataType rhs_data_type) const override;
 };
 
@@ -12,7 +12,6 @@
 #include <limits>
 
 #include "executer.h"
-#include "runerror.h"
 
 
 inline bool withinIntegerRange(double value)
@@ -28,33 +27,44 @@ inline bool withinIntegerRange(int64_t value)
         && value <= std::numeric_limits<int32_t>::max();
 }
 
+// the check functions return false after setting a run error on the executer,
+// the execute function must then return without using the value
+
 template <typename T>
-inline void checkIntegerOverflow(Executer &executer, T result)
+inline bool checkIntegerOverflow(Executer &executer, T result)
 {
     if (!withinIntegerRange(result)) {
-        throw RunError {"overflow", executer.currentOffset()};
+        executer.setRunError("overflow");
+        return false;
     }
+    return true;
 }
 
-inline void checkNegativeIntegerOverflow(Executer &executer, int32_t value)
+inline bool checkNegativeIntegerOverflow(Executer &executer, int32_t value)
 {
     if (value == std::numeric_limits<int32_t>::min()) {
-        throw RunError {"overflow", executer.currentOffset()};
+        executer.setRunError("overflow");
+        return false;
     }
+    return true;
 }
 
-inline void checkDoubleOverflow(Executer &executer, double result)
+inline bool checkDoubleOverflow(Executer &executer, double result)
 {
     if (std::fabs(result) > std::numeric_limits<double>::max()) {
-        throw RunError {"overflow", executer.currentOffset()};
+        executer.setRunError("overflow");
+        return false;
     }
+    return true;
 }
 
-inline void checkForOverflow(Executer &executer, double result)
+inline bool checkForOverflow(Executer &executer, double result)
 {
     if (result == HUGE_VAL) {
-        throw RunError {"overflow", executer.currentOffset()};
+        executer.setRunError("overflow");
+        return false;
     }
+    return true;
 }
 
 
@@ -12,9 +12,11 @@
 
 #include "executer.h"
 #include "overflow.h"
-#include "runerror.h"
 
 
+// a run error is set on the executer for a divide by zero or an overflow,
+// in which case the result returned is not used
+
 struct PowerDblInt {
     PowerDblInt(Executer &executer, double x, int32_t y);
     double operator()();
@@ -60,7 +62,8 @@ inline double PowerDblInt::multiplyForPositiveExponent()
 inline double PowerDblInt::divideForNegativeExponent()
 {
     if (x == 0) {
-        throw RunError {"divide by zero", executer.currentOffset()};
+        executer.setRunError("divide by zero");
+        return 0;
     }
     auto result = 1.0;
     while (++y <= 0) {
@@ -12,9 +12,11 @@
 #include <limits>
 
 #include "executer.h"
-#include "runerror.h"
 
 
+// a run error is set on the executer for a divide by zero or an overflow,
+// in which case the result returned is not used
+
 struct PowerIntInt {
     PowerIntInt(Executer &executer, int32_t x, int32_t y);
     int32_t operator()();
@@ -28,8 +30,8 @@ private:
     int32_t calculateForNegativeValue();
     int32_t multiplyNegativeValue();
     int32_t useDoublePowerForNegativeValue();
-    template <typename T> void checkPostiveOverflow(T result);
-    template <typename T> void checkAnyOverflow(T result);
+    template <typename T> bool checkPostiveOverflow(T result);
+    template <typename T> bool checkAnyOverflow(T result);
 
     Executer &executer;
     int32_t x;
@@ -47,7 +49,8 @@ inline int32_t PowerIntInt::operator()()
 {
     if (y < 0) {
         if (x == 0) {
-            throw RunError {"divide by zero", executer.currentOffset()};
+            executer.setRunError("divide by zero");
+            return 0;
         }
         return calculateNegativeExponent();
     }
@@ -81,7 +84,9 @@ inline int32_t PowerIntInt::multiplyPositiveValue()
     auto result = 1ll;
     for (int i = 0; i < y; ++i) {
         result *= x;
-        checkPostiveOverflow(result);
+        if (!checkPostiveOverflow(result)) {
+            return 0;
+        }
     }
     return static_cast<int32_t>(result);
 }
@@ -89,8 +94,7 @@ inline int32_t PowerIntInt::multiplyPositiveValue()
 inline int32_t PowerIntInt::useDoublePowerForPositiveValue()
 {
     auto result = std::pow(x, y);
-    checkPostiveOverflow(result);
-    return static_cast<int32_t>(result);
+    return checkPostiveOverflow(result) ? static_cast<int32_t>(result) : 0;
 }
 
 inline int32_t PowerIntInt::calculateForNegativeValue()
@@ -104,7 +108,9 @@ inline int32_t PowerIntInt::multiplyNegativeValue()
     auto result = 1ll;
     for (int i = 0; i < y; ++i) {
         result *= x;
-        checkAnyOverflow(result);
+        if (!checkAnyOverflow(result)) {
+            return 0;
+        }
     }
     return static_cast<int32_t>(result);
 }
@@ -112,25 +118,28 @@ inline int32_t PowerIntInt::multiplyNegativeValue()
 inline int32_t PowerIntInt::useDoublePowerForNegativeValue()
 {
     auto result = std::pow(x, y);
-    checkAnyOverflow(result);
-    return static_cast<int32_t>(result);
+    return checkAnyOverflow(result) ? static_cast<int32_t>(result) : 0;
 }
 
 template <typename T>
-inline void PowerIntInt::checkPostiveOverflow(T result)
+inline bool PowerIntInt::checkPostiveOverflow(T result)
 {
     if (result > std::numeric_limits<int32_t>::max()) {
-        throw RunError {"overflow", executer.currentOffset()};
+        executer.setRunError("overflow");
+        return false;
     }
+    return true;
 }
 
 template <typename T>
-inline void PowerIntInt::checkAnyOverflow(T result)
+inline bool PowerIntInt::checkAnyOverflow(T result)
 {
     if (result > std::numeric_limits<int32_t>::max()
             || result < std::numeric_limits<int32_t>::min()) {
-        throw RunError {"overflow", executer.currentOffset()};
+        executer.setRunError("overflow");
+        return false;
     }
+    return true;
 }
 
 
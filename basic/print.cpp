@@ -10,6 +10,7 @@
 #include "commandcode.h"
 #include "compiler.h"
 #include "executer.h"
+#include "fusedcode.h"
 #include "programcode.h"
 #include "recreator.h"
 
@@ -23,10 +24,10 @@ void executePrintStr(Executer &executer);
 void executePrintTmp(Executer &executer);
 
 CommandCode print_code {"PRINT", compilePrint, recreatePrint, executePrint};
-Code print_dbl_code {recreateNothing, executePrintDbl};
-Code print_int_code {recreateNothing, executePrintInt};
-Code print_str_code {recreateNothing, executePrintStr};
-Code print_tmp_code {recreateNothing, executePrintTmp};
+Code print_dbl_code {"PrintDbl", recreateNothing, executePrintDbl, pops(DataType::Double())};
+Code print_int_code {"PrintInt", recreateNothing, executePrintInt, pops(DataType::Integer())};
+Code print_str_code {"PrintStr", recreateNothing, executePrintStr, pops(DataType::String())};
+Code print_tmp_code {"PrintTmp", recreateNothing, executePrintTmp, pops(DataType::TmpStr())};
 
 
 void compilePrint(Compiler &compiler)
@@ -53,24 +54,24 @@ void recreatePrint(Recreator &recreator)
 
 void executePrint(Executer &executer)
 {
-    executer.output() << std::endl;
+    executer.outputNewLine();
 }
 
 void executePrintInt(Executer &executer)
 {
-    executer.output() << executer.topInt();
+    executer.output().writeInteger(executer.topInt());
     executer.pop();
 }
 
 void executePrintDbl(Executer &executer)
 {
-    executer.output() << executer.topDbl();
+    executer.output().writeDouble(executer.topDbl());
     executer.pop();
 }
 
 void executePrintStr(Executer &executer)
 {
-    executer.output() << *executer.topStr();
+    executer.output() << executer.topStr();
     executer.pop();
 }
 
@@ -80,3 +81,29 @@ void executePrintTmp(Executer &executer)
     executer.output() << *operand;
     executer.pop();
 }
+
+// ----------------------------------------
+
+// fused codes for a print item and PRINT, and a constant and a print item (and PRINT)
+
+extern Code const_dbl_code;
+extern Code const_int_code;
+
+FusedCode print_dbl_print_code {print_dbl_code, print_code,
+    executeFused<executePrintDbl, executePrint>};
+FusedCode print_int_print_code {print_int_code, print_code,
+    executeFused<executePrintInt, executePrint>};
+FusedCode print_str_print_code {print_str_code, print_code,
+    executeFused<executePrintStr, executePrint>};
+FusedCode print_tmp_print_code {print_tmp_code, print_code,
+    executeFused<executePrintTmp, executePrint>};
+
+FusedCode const_dbl_print_dbl_code {const_dbl_code, print_dbl_code,
+    executeConstDblFused<executePrintDbl>};
+FusedCode const_int_print_int_code {const_int_code, print_int_code,
+    executeConstIntFused<executePrintInt>};
+
+FusedCode const_dbl_print_dbl_print_code {const_dbl_print_dbl_code, print_code,
+    executeFused<executeConstDblFused<executePrintDbl>, executePrint>};
+FusedCode const_int_print_int_print_code {const_int_print_int_code, print_code,
+    executeFused<executeConstIntFused<executePrintInt>, executePrint>};
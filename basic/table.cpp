@@ -5,8 +5,10 @@
  * (See accompanying file LICENSE or <http://www.gnu.org/licenses/>)
  */
 
-#include <map>
-#include <unordered_map>
+#include <algorithm>
+#include <array>
+#include <string>
+#include <vector>
 
 #include "cistring.h"
 #include "functions.h"
@@ -14,32 +16,78 @@
 #include "table.h"
 
 
+constexpr auto PrecedenceCount = static_cast<std::size_t>(Precedence::Imp) + 1;
+
+// the information is added during static initialization, which is frozen into the lookup table
+// by the first lookup; the lookup table is only read so that threads can share it
+
+class LookupTable;
+
 class TableInfo {
 public:
     static TableInfo &getInstance();
+    static const LookupTable &getLookupTable();
     void addOperatorData(Precedence precedence, OperatorCodes &codes, const char *keyword);
     void addNumFunctionData(FunctionCodes &codes, const char *keyword);
-    Precedence getPrecedence(WordType code_value) const;
-    const char *getKeyword(WordType code_value) const;
-    OperatorCodes *operatorCodes(Precedence precedence);
-    OperatorCodes *operatorCodes(Precedence precedence, char operator_char);
-    OperatorCodes *operatorCodes(Precedence precedence, const ci_string &word);
-    ComparisonOperator comparisonOperatorData(const std::string &keyword);
-    FunctionCodes *numFunctionCodes(const ci_string &word);
 
 private:
+    friend class LookupTable;
+
     struct OperatorData {
+        Precedence precedence;
         OperatorCodes &codes;
         const char *keyword;
     };
+    struct FunctionData {
+        FunctionCodes &codes;
+        const char *keyword;
+    };
 
     TableInfo() { }
+    static void nameCodes(const Codes &codes, const std::string &name);
+
+    std::vector<OperatorData> operator_data;
+    std::vector<FunctionData> num_function_data;
+};
 
-    std::unordered_map<WordType, Precedence> precedences;
-    std::unordered_map<WordType, const char *> keywords;
-    std::multimap<Precedence, OperatorData> operator_data;
-    std::map<std::string, ComparisonOperator> comparison_operator_data;
-    std::map<ci_string, FunctionCodes &> num_function_codes;
+// the precedence and keyword of each code are in arrays indexed by code value, and the keywords
+// are in a perfect hash table (no two keywords hash to the same slot), where the hash is of the
+// lower case characters so that words are looked up without case conversion or allocation
+
+class LookupTable {
+public:
+    explicit LookupTable(const TableInfo &table_info);
+    Precedence getPrecedence(WordType code_value) const;
+    const char *getKeyword(WordType code_value) const;
+    const char *findKeyword(WordType code_value) const;
+    OperatorCodes *operatorCodes(Precedence precedence) const;
+    OperatorCodes *operatorCodes(Precedence precedence, char operator_char) const;
+    OperatorCodes *operatorCodes(Precedence precedence, ci_string_view word) const;
+    ComparisonOperator comparisonOperator(const std::string &keyword) const;
+    FunctionCodes *numFunctionCodes(ci_string_view word) const;
+
+private:
+    struct KeywordEntry {
+        const char *keyword {nullptr};
+        std::size_t length {0};
+        std::array<OperatorCodes *, PrecedenceCount> operator_codes {{}};
+        ComparisonOperator comparison_operator;
+        FunctionCodes *function_codes {nullptr};
+    };
+
+    static bool equalsKeyword(const char *word, std::size_t length, const KeywordEntry &slot);
+    KeywordEntry &addKeyword(std::vector<KeywordEntry> &entries, const char *keyword);
+    void createHashTable(const std::vector<KeywordEntry> &entries);
+    bool fillSlots(const std::vector<KeywordEntry> &entries);
+    void createSymbolSlots();
+    const KeywordEntry *find(const char *word, std::size_t length) const;
+
+    std::vector<Precedence> precedences;
+    std::vector<const char *> keywords;
+    std::array<OperatorCodes *, PrecedenceCount> first_operator_codes {{}};
+    std::vector<KeywordEntry> slots;
+    unsigned seed {0};
+    std::array<const KeywordEntry *, 256> symbol_slots {{}};
 };
 
 // ------------------------------------------------------------
@@ -56,37 +104,42 @@ void Table::addNumFunctionCodes(FunctionCodes &codes, const char *keyword)
 
 const char *Table::getKeyword(WordType code_value)
 {
-    return TableInfo::getInstance().getKeyword(code_value);
+    return TableInfo::getLookupTable().getKeyword(code_value);
+}
+
+const char *Table::findKeyword(WordType code_value)
+{
+    return TableInfo::getLookupTable().findKeyword(code_value);
 }
 
 Precedence Table::getPrecedence(WordType code_value)
 {
-    return TableInfo::getInstance().getPrecedence(code_value);
+    return TableInfo::getLookupTable().getPrecedence(code_value);
 }
 
 OperatorCodes *Table::operatorCodes(Precedence precedence)
 {
-    return TableInfo::getInstance().operatorCodes(precedence);
+    return TableInfo::getLookupTable().operatorCodes(precedence);
 }
 
 OperatorCodes *Table::operatorCodes(Precedence precedence, char operator_char)
 {
-    return TableInfo::getInstance().operatorCodes(precedence, operator_char);
+    return TableInfo::getLookupTable().operatorCodes(precedence, operator_char);
 }
 
-OperatorCodes *Table::operatorCodes(Precedence precedence, const ci_string &word)
+OperatorCodes *Table::operatorCodes(Precedence precedence, ci_string_view word)
 {
-    return TableInfo::getInstance().operatorCodes(precedence, word);
+    return TableInfo::getLookupTable().operatorCodes(precedence, word);
 }
 
 ComparisonOperator Table::comparisonOperator(const std::string &keyword)
 {
-    return TableInfo::getInstance().comparisonOperatorData(keyword);
+    return TableInfo::getLookupTable().comparisonOperator(keyword);
 }
 
-FunctionCodes *Table::numFunctionCodes(const ci_string &word)
+FunctionCodes *Table::numFunctionCodes(ci_string_view word)
 {
-    return TableInfo::getInstance().numFunctionCodes(word);
+    return TableInfo::getLookupTable().numFunctionCodes(word);
 }
 
 // ------------------------------------------------------------
@@ -97,81 +150,178 @@ TableInfo &TableInfo::getInstance()
     return precedence_info;
 }
 
-Precedence TableInfo::getPrecedence(WordType code_value) const
+inline const LookupTable &TableInfo::getLookupTable()
 {
-    return precedences.at(code_value);
+    static const LookupTable lookup_table {getInstance()};
+    return lookup_table;
 }
 
-const char *TableInfo::getKeyword(WordType code_value) const
+// the precedence is part of the name of an operator code since the same keyword is the operator
+// of different precedences (like negate and subtract)
+void TableInfo::addOperatorData(Precedence precedence, OperatorCodes &codes, const char *keyword)
 {
-    return keywords.at(code_value);
+    operator_data.push_back(OperatorData {precedence, codes, keyword});
+    auto name = std::string {keyword} + '@' + std::to_string(static_cast<int>(precedence));
+    nameCodes(codes, name);
 }
 
-OperatorCodes *TableInfo::operatorCodes(Precedence precedence)
+void TableInfo::addNumFunctionData(FunctionCodes &codes, const char *keyword)
 {
-    auto iterators = operator_data.equal_range(precedence);
-    auto &operator_data = iterators.first->second;
-    return &operator_data.codes;
+    num_function_data.push_back(FunctionData {codes, keyword});
+    nameCodes(codes, keyword);
 }
 
-OperatorCodes *TableInfo::operatorCodes(Precedence precedence, char operator_char)
+// the codes of a keyword are named by the keyword and the position of the code
+void TableInfo::nameCodes(const Codes &codes, const std::string &name)
 {
-    auto iterators = operator_data.equal_range(precedence);
-    for (auto iterator = iterators.first; iterator != iterators.second; ++iterator) {
-        auto &operator_data = iterator->second;
-        if (operator_char == operator_data.keyword[0]) {
-            return &operator_data.codes;
-        }
+    unsigned index = 0;
+    for (auto code_value : codes.codeValues()) {
+        Code::getCode(code_value)->setName(name + '#' + std::to_string(index++));
     }
-    return nullptr;
 }
 
-OperatorCodes *TableInfo::operatorCodes(Precedence precedence, const ci_string &word)
+// ------------------------------------------------------------
+
+LookupTable::LookupTable(const TableInfo &table_info) :
+    precedences(Code::getCodeCount(), Precedence::Operand),
+    keywords(Code::getCodeCount(), nullptr)
 {
-    auto iterators = operator_data.equal_range(precedence);
-    for (auto iterator = iterators.first; iterator != iterators.second; ++iterator) {
-        auto &operator_data = iterator->second;
-        if (word == operator_data.keyword) {
-            return &operator_data.codes;
+    std::vector<KeywordEntry> entries;
+    for (auto &data : table_info.operator_data) {
+        auto precedence_index = static_cast<std::size_t>(data.precedence);
+        if (!first_operator_codes[precedence_index]) {
+            first_operator_codes[precedence_index] = &data.codes;
+        }
+        for (auto code_value : data.codes.codeValues()) {
+            precedences[code_value] = data.precedence;
+            keywords[code_value] = data.keyword;
+        }
+        auto &entry = addKeyword(entries, data.keyword);
+        entry.operator_codes[precedence_index] = &data.codes;
+        if (data.precedence == Precedence::Relation || data.precedence == Precedence::Equality) {
+            entry.comparison_operator = ComparisonOperator {&data.codes, data.precedence};
         }
     }
-    return nullptr;
+    for (auto &data : table_info.num_function_data) {
+        for (auto code_value : data.codes.codeValues()) {
+            keywords[code_value] = data.keyword;
+        }
+        addKeyword(entries, data.keyword).function_codes = &data.codes;
+    }
+    createHashTable(entries);
 }
 
-ComparisonOperator TableInfo::comparisonOperatorData(const std::string &keyword)
+inline bool LookupTable::equalsKeyword(const char *word, std::size_t length,
+    const KeywordEntry &slot)
 {
-    auto iterator = comparison_operator_data.find(keyword);
-    if (iterator == comparison_operator_data.end()) {
-        return ComparisonOperator {};
-    } else {
-        return iterator->second;
-    }
+    return slot.keyword && slot.length == length && equalLowerCase(word, slot.keyword, length);
 }
 
-FunctionCodes *TableInfo::numFunctionCodes(const ci_string &word)
+LookupTable::KeywordEntry &LookupTable::addKeyword(std::vector<KeywordEntry> &entries,
+    const char *keyword)
 {
-    auto iterator = num_function_codes.find(word);
-    return iterator != num_function_codes.end() ? &iterator->second : nullptr;
+    ci_string ci_keyword {keyword};
+    for (auto &entry : entries) {
+        if (ci_keyword == entry.keyword) {
+            return entry;
+        }
+    }
+    entries.emplace_back();
+    entries.back().keyword = keyword;
+    entries.back().length = ci_keyword.length();
+    return entries.back();
 }
 
-// --------------------
-
-void TableInfo::addOperatorData(Precedence precedence, OperatorCodes &codes, const char *keyword)
+// the seed is searched for (with a larger table when no seed works) until every keyword is in a
+// slot by itself, which only takes a few tries since the table is at least twice the keywords
+void LookupTable::createHashTable(const std::vector<KeywordEntry> &entries)
 {
-    operator_data.emplace(precedence, OperatorData{codes, keyword});
-    for (auto code_value : codes.codeValues()) {
-        precedences[code_value] = precedence;
-        keywords[code_value] = keyword;
+    auto size = std::size_t {1};
+    while (size < 2 * entries.size()) {
+        size *= 2;
     }
-    if (precedence == Precedence::Relation || precedence == Precedence::Equality) {
-        comparison_operator_data.emplace(keyword, ComparisonOperator{&codes, precedence});
+    for (;; size *= 2) {
+        slots.resize(size);
+        for (seed = 0; seed < 1000; ++seed) {
+            if (fillSlots(entries)) {
+                createSymbolSlots();
+                return;
+            }
+        }
     }
 }
 
-void TableInfo::addNumFunctionData(FunctionCodes &codes, const char *keyword)
+// one character keywords (the symbol operators) are looked up directly by character
+void LookupTable::createSymbolSlots()
 {
-    num_function_codes.emplace(keyword, codes);
-    for (auto code_value : codes.codeValues()) {
-        keywords[code_value] = keyword;
+    for (auto &slot : slots) {
+        if (slot.length == 1) {
+            symbol_slots[static_cast<unsigned char>(slot.keyword[0])] = &slot;
+        }
+    }
+}
+
+bool LookupTable::fillSlots(const std::vector<KeywordEntry> &entries)
+{
+    std::fill(slots.begin(), slots.end(), KeywordEntry {});
+    for (auto &entry : entries) {
+        auto &slot = slots[hashLowerCase(entry.keyword, entry.length, seed) & (slots.size() - 1)];
+        if (slot.keyword) {
+            return false;
+        }
+        slot = entry;
     }
+    return true;
+}
+
+inline const LookupTable::KeywordEntry *LookupTable::find(const char *word,
+    std::size_t length) const
+{
+    auto &slot = slots[hashLowerCase(word, length, seed) & (slots.size() - 1)];
+    return equalsKeyword(word, length, slot) ? &slot : nullptr;
+}
+
+// the code values come from program words, so a value that is not a code throws
+inline Precedence LookupTable::getPrecedence(WordType code_value) const
+{
+    return precedences.at(code_value);
+}
+
+inline const char *LookupTable::getKeyword(WordType code_value) const
+{
+    return keywords.at(code_value);
+}
+
+inline const char *LookupTable::findKeyword(WordType code_value) const
+{
+    return code_value < keywords.size() ? keywords[code_value] : nullptr;
+}
+
+inline OperatorCodes *LookupTable::operatorCodes(Precedence precedence) const
+{
+    return first_operator_codes[static_cast<std::size_t>(precedence)];
+}
+
+inline OperatorCodes *LookupTable::operatorCodes(Precedence precedence, char operator_char) const
+{
+    auto entry = symbol_slots[static_cast<unsigned char>(operator_char)];
+    return entry ? entry->operator_codes[static_cast<std::size_t>(precedence)] : nullptr;
+}
+
+inline OperatorCodes *LookupTable::operatorCodes(Precedence precedence, ci_string_view word) const
+{
+    auto entry = find(word.data(), word.length());
+    return entry ? entry->operator_codes[static_cast<std::size_t>(precedence)] : nullptr;
+}
+
+inline ComparisonOperator LookupTable::comparisonOperator(const std::string &keyword) const
+{
+    auto entry = find(keyword.data(), keyword.length());
+    return entry ? entry->comparison_operator : ComparisonOperator {};
+}
+
+inline FunctionCodes *LookupTable::numFunctionCodes(ci_string_view word) const
+{
+    auto entry = find(word.data(), word.length());
+    return entry ? entry->function_codes : nullptr;
 }
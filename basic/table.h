@@ -39,12 +39,13 @@ struct Table {
     static void addOperatorCodes(Precedence precedence, OperatorCodes &codes, const char *keyword);
     static void addNumFunctionCodes(FunctionCodes &codes, const char *keyword);
     static const char *getKeyword(WordType code_value);
+    static const char *findKeyword(WordType code_value);
     static Precedence getPrecedence(WordType code_value);
     static OperatorCodes *operatorCodes(Precedence precedence);
     static OperatorCodes *operatorCodes(Precedence precedence, char operator_char);
-    static OperatorCodes *operatorCodes(Precedence precedence, const ci_string &word);
+    static OperatorCodes *operatorCodes(Precedence precedence, ci_string_view word);
     static ComparisonOperator comparisonOperator(const std::string &keyword);
-    static FunctionCodes *numFunctionCodes(const ci_string &word);
+    static FunctionCodes *numFunctionCodes(ci_string_view word);
 };
 
 
@@ -0,0 +1,51 @@
+/* vim:ts=4:sw=4:et:sts=4:
+ *
+ * Copyright 2016 Thunder422.  All rights reserved.
+ * Distributed under GNU General Public License Version 3
+ * (See accompanying file LICENSE or <http://www.gnu.org/licenses/>)
+ */
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+
+class Benchmark {
+public:
+    Benchmark(const std::string &name, unsigned iterations);
+    template <typename Function> double operator()(Function function) const;
+
+private:
+    std::string name;
+    unsigned iterations;
+};
+
+inline Benchmark::Benchmark(const std::string &name, unsigned iterations) :
+    name {name},
+    iterations {iterations}
+{
+}
+
+template <typename Function>
+inline double Benchmark::operator()(Function function) const
+{
+    using Clock = std::chrono::steady_clock;
+
+    auto start = Clock::now();
+    for (unsigned i = 0; i < iterations; ++i) {
+        function();
+    }
+    std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+
+    auto per_iteration = elapsed.count() / iterations;
+    std::cout << std::left << std::setw(56) << name << std::right << std::setw(14)
+        << std::fixed << std::setprecision(1) << per_iteration << " ns/iteration" << std::endl;
+    return per_iteration;
+}
+
+
+#endif  // BENCHMARK_H
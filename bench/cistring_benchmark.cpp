@@ -0,0 +1,77 @@
+/* vim:ts=4:sw=4:et:sts=4:
+ *
+ * Copyright 2016 Thunder422.  All rights reserved.
+ * Distributed under GNU General Public License Version 3
+ * (See accompanying file LICENSE or <http://www.gnu.org/licenses/>)
+ */
+
+#include <cctype>
+#include <vector>
+
+#include "benchmark.h"
+#include "cistring.h"
+
+
+// the comparison of case insensitive strings using the locale (before the ASCII conversion)
+int compareToLower(const char *s1, const char *s2, std::size_t n)
+{
+    while (n-- != 0) {
+        auto c1 = std::tolower(*s1++);
+        auto c2 = std::tolower(*s2++);
+        if (c1 != c2) {
+            return c1 < c2 ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+void printThroughput(std::size_t length, double nanoseconds_per_compare)
+{
+    std::cout << std::left << std::setw(56) << "compare throughput" << std::right
+        << std::setw(14) << std::setprecision(0) << length * 1e3 / nanoseconds_per_compare
+        << " MB/second" << std::endl;
+}
+
+void benchmarkCompare(const std::string &name, const ci_string &string1,
+    const ci_string &string2, unsigned iterations)
+{
+    // the volatile pointer keeps the inline comparison from being moved out of the loop
+    const ci_string *volatile pointer1 = &string1;
+    auto length = string1.length();
+    unsigned long bytes = 0;
+    auto time = Benchmark {name + " (ci_string)", iterations}([&pointer1, &string2, &bytes]() {
+        bytes += *pointer1 == string2 ? pointer1->length() : 0;
+    });
+    printThroughput(length, time);
+    time = Benchmark {name + " (std::tolower)", iterations}([&pointer1, &string2, &bytes]() {
+        bytes += compareToLower(pointer1->data(), string2.data(), string2.length()) == 0
+            ? pointer1->length() : 0;
+    });
+    printThroughput(length, time);
+    if (bytes == 0) {
+        std::cout << bytes << std::endl;  // keeps the loops from being optimized away
+    }
+}
+
+
+int main()
+{
+    benchmarkCompare("compare keywords", "Print", "PRINT", 10000000);
+    benchmarkCompare("compare long words", "Randomize_Every_Word_Of_This_Line",
+        "RANDOMIZE_EVERY_WORD_OF_THIS_LINE", 10000000);
+    std::string long_string(4096, 'x');
+    benchmarkCompare("compare 4k strings", long_string.c_str(),
+        std::string(4096, 'X').c_str(), 100000);
+
+    std::vector<std::string> words {"Print", "abs", "RND", "Imp", "Eqv", "frac", "Mod", "sqr"};
+    uint32_t hash = 0;
+    Benchmark {"hash keywords (x1000)", 1000}([&words, &hash]() {
+        for (unsigned i = 0; i < 1000; ++i) {
+            auto &word = words[i % words.size()];
+            hash += hashLowerCase(word.data(), word.length(), hash);
+        }
+    });
+    if (hash == 0) {
+        std::cout << hash << std::endl;  // keeps the loop from being optimized away
+    }
+}
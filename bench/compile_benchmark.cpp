@@ -0,0 +1,116 @@
+/* vim:ts=4:sw=4:et:sts=4:
+ *
+ * Copyright 2016 Thunder422.  All rights reserved.
+ * Distributed under GNU General Public License Version 3
+ * (See accompanying file LICENSE or <http://www.gnu.org/licenses/>)
+ */
+
+#include <sstream>
+
+#include "benchmark.h"
+#include "cistring.h"
+#include "programerror.h"
+#include "programunit.h"
+#include "table.h"
+
+
+constexpr unsigned LineCount = 10000;
+constexpr unsigned LargeLineCount = 100000;
+
+
+// lines with many operators, functions and comparisons (the keywords looked up in the table)
+std::string generateSource()
+{
+    std::ostringstream source;
+    for (unsigned i = 0; i < LineCount; ++i) {
+        auto number = i % 1000;
+        switch (i % 4) {
+        case 0:
+            source << "PRINT ABS(-" << number << ") + SGN(" << number << ") * INT(2.5) - "
+                << number << " \\ 7 ^ 2\n";
+            break;
+        case 1:
+            source << "print sqr(" << number << ") / cos(1.5) + sin(0.5) - atn(" << number
+                << ") + frac(2.5)\n";
+            break;
+        case 2:
+            source << "PRINT (" << number << " < 500) AND (" << number << " >= 2) OR NOT "
+                << number << " <> 7 XOR 1 EQV 0 IMP 1\n";
+            break;
+        case 3:
+            source << "Print " << number << " Mod 7 = 1 Or Fix(" << number << ") <= 3\n";
+            break;
+        }
+    }
+    return source.str();
+}
+
+// long lines of mostly numbers, strings and white space (the characters the lexer reads)
+std::string generateLargeSource()
+{
+    std::ostringstream source;
+    for (unsigned i = 0; i < LargeLineCount; ++i) {
+        auto number = i % 1000;
+        if (i % 2 == 0) {
+            source << "PRINT   " << number << ".25 * 2.5E3  /  (0.5 + " << number
+                << ")  -  12345.678  +  -" << number << "\n";
+        } else {
+            source << "print  \"some text " << number << "\"  +  \"more text\"  +  "
+                << "\"\"\"quoted\"\"\"\n";
+        }
+    }
+    return source.str();
+}
+
+void printLinesPerSecond(unsigned line_count, double nanoseconds_per_compile)
+{
+    std::cout << std::left << std::setw(56) << "compile throughput" << std::right
+        << std::setw(14) << std::setprecision(0) << line_count * 1e9 / nanoseconds_per_compile
+        << " lines/second" << std::endl;
+}
+
+
+int main()
+{
+    auto source = generateSource();
+
+    auto compile_time = Benchmark {"compile 10k keyword heavy lines", 20}([&source]() {
+        std::istringstream iss {source};
+        ProgramUnit program;
+        program.compile(iss);
+    });
+    printLinesPerSecond(LineCount, compile_time);
+
+    std::istringstream iss {source};
+    ProgramUnit program;
+    program.compile(iss);
+    Benchmark {"recreate 10k keyword heavy lines", 20}([&program]() {
+        std::ostringstream oss;
+        program.recreate(oss);
+    });
+
+    ci_string function {"frac"};
+    ci_string word_operator {"Imp"};
+    unsigned found = 0;
+    Benchmark {"table lookups of functions and operators (x1000)", 1000}(
+        [&function, &word_operator, &found]() {
+            for (unsigned i = 0; i < 1000; ++i) {
+                found += Table::numFunctionCodes(function) != nullptr;
+                found += Table::operatorCodes(Precedence::Imp, word_operator) != nullptr;
+                found += Table::operatorCodes(Precedence::Summation, '-') != nullptr;
+                found += Table::comparisonOperator("<=").codes != nullptr;
+            }
+        });
+
+    auto large_source = generateLargeSource();
+    auto large_compile_time = Benchmark {"compile 100k line program", 3}([&large_source]() {
+        std::istringstream iss {large_source};
+        ProgramUnit program;
+        program.compile(iss);
+    });
+    printLinesPerSecond(LargeLineCount, large_compile_time);
+
+    if (found == 0) {
+        std::cout << found << std::endl;  // keeps the loops from being optimized away
+    }
+}
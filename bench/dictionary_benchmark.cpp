@@ -0,0 +1,145 @@
+/* vim:ts=4:sw=4:et:sts=4:
+ *
+ * Copyright 2016 Thunder422.  All rights reserved.
+ * Distributed under GNU General Public License Version 3
+ * (See accompanying file LICENSE or <http://www.gnu.org/licenses/>)
+ */
+
+#include <cstdlib>
+#include <new>
+#include <unordered_map>
+#include <vector>
+
+#include "benchmark.h"
+#include "dictionary.h"
+#include "programunit.h"
+
+
+constexpr unsigned ConstantCount = 1000000;
+
+
+// the global allocation functions are replaced to measure the memory allocated by each
+// dictionary (the size of an allocation is kept in front of it)
+
+std::size_t allocated_bytes = 0;
+
+void *operator new(std::size_t size)
+{
+    if (auto memory = static_cast<std::max_align_t *>(std::malloc(sizeof(std::max_align_t)
+            + size))) {
+        *reinterpret_cast<std::size_t *>(memory) = size;
+        allocated_bytes += size;
+        return memory + 1;
+    }
+    throw std::bad_alloc {};
+}
+
+void operator delete(void *memory) noexcept
+{
+    if (memory) {
+        auto block = static_cast<std::max_align_t *>(memory) - 1;
+        allocated_bytes -= *reinterpret_cast<std::size_t *>(block);
+        std::free(block);
+    }
+}
+
+
+// the dictionary before the arena (a node for each string, which is returned by copy)
+class NodeDictionary {
+public:
+    unsigned add(const std::string &string);
+    std::string get(unsigned index) const;
+
+private:
+    using KeyMap = std::unordered_map<std::string, unsigned>;
+
+    KeyMap key_map;
+    std::vector<KeyMap::iterator> key_iterator;
+};
+
+unsigned NodeDictionary::add(const std::string &string)
+{
+    auto iterator = key_map.find(string);
+    if (iterator != key_map.end()) {
+        return iterator->second;
+    }
+    auto index = key_map.size();
+    key_iterator.emplace_back(key_map.emplace(string, index).first);
+    return index;
+}
+
+std::string NodeDictionary::get(unsigned index) const
+{
+    return key_iterator[index]->first;
+}
+
+
+// the dictionary with the same interface as the node dictionary
+class ArenaDictionary : public Dictionary {
+public:
+    unsigned add(const std::string &string);
+};
+
+unsigned ArenaDictionary::add(const std::string &string)
+{
+    return Dictionary::add(string).operand;
+}
+
+
+std::vector<std::string> generateConstants()
+{
+    std::vector<std::string> constants;
+    constants.reserve(ConstantCount);
+    for (unsigned i = 0; i < ConstantCount; ++i) {
+        constants.emplace_back("constant " + std::to_string(i * 7919u));
+    }
+    return constants;
+}
+
+void printMemory(const std::string &name, std::size_t bytes)
+{
+    std::cout << std::left << std::setw(56) << name << std::right << std::setw(14)
+        << bytes / 1024 << " KiB (" << std::setprecision(1) << double(bytes) / ConstantCount
+        << " bytes/constant)" << std::endl;
+}
+
+template <typename DictionaryType>
+void benchmarkDictionary(const std::string &name, const std::vector<std::string> &constants)
+{
+    auto bytes = allocated_bytes;
+    DictionaryType dictionary;
+    Benchmark {name + " insert 1M constants", 1}([&dictionary, &constants]() {
+        for (auto &constant : constants) {
+            dictionary.add(constant);
+        }
+    });
+    printMemory(name + " memory", allocated_bytes - bytes);
+
+    std::size_t length = 0;
+    Benchmark {name + " look up 1M constants", 1}([&dictionary, &constants, &length]() {
+        for (auto &constant : constants) {
+            length += dictionary.get(dictionary.add(constant)).length();
+        }
+    });
+    if (length == 0) {
+        std::cout << length << std::endl;  // keeps the loop from being optimized away
+    }
+}
+
+
+int main()
+{
+    auto constants = generateConstants();
+
+    benchmarkDictionary<NodeDictionary>("node", constants);
+    benchmarkDictionary<ArenaDictionary>("arena", constants);
+
+    ProgramUnit program;
+    for (auto &constant : constants) {
+        program.addConstantString(constant);
+    }
+    auto memory_usage = program.getConstantStringMemoryUsage();
+    printMemory("arena memory reported by the dictionary", memory_usage.total()
+        - memory_usage.values);
+    printMemory("string constant values for the executer", memory_usage.values);
+}
@@ -0,0 +1,97 @@
+/* vim:ts=4:sw=4:et:sts=4:
+ *
+ * Copyright 2016 Thunder422.  All rights reserved.
+ * Distributed under GNU General Public License Version 3
+ * (See accompanying file LICENSE or <http://www.gnu.org/licenses/>)
+ */
+
+#include <sstream>
+#include <utility>
+
+#include "benchmark.h"
+#include "compiledprogram.h"
+#include "executer.h"
+#include "programerror.h"
+#include "programunit.h"
+
+
+std::string nestedExpression(const std::string &operand, const std::string &op, unsigned depth)
+{
+    std::string expression;
+    for (unsigned i = 0; i < depth; ++i) {
+        expression += operand + op + '(';
+    }
+    expression += operand;
+    expression.append(depth, ')');
+    return expression;
+}
+
+std::string flatExpression(const std::string &operand, const std::string &op, unsigned length)
+{
+    std::string expression = operand;
+    for (unsigned i = 0; i < length; ++i) {
+        expression += op + operand;
+    }
+    return expression;
+}
+
+void benchmarkProgram(const std::string &name, const std::string &line, unsigned lines)
+{
+    std::ostringstream source;
+    for (unsigned i = 0; i < lines; ++i) {
+        source << "PRINT " << line << '\n';
+    }
+    std::istringstream iss {source.str()};
+    ProgramUnit program;
+    program.compile(iss);
+
+    Benchmark {name, 2000}([&program]() {
+        std::ostringstream oss;
+        program.run(oss, OutputBuffering::Full);
+    });
+
+    program.fuseCode();
+    Benchmark {name + " (fused)", 2000}([&program]() {
+        std::ostringstream oss;
+        program.run(oss, OutputBuffering::Full);
+    });
+
+    Benchmark {name + " (fused, table dispatch)", 2000}([&program]() {
+        std::ostringstream oss;
+        program.run(oss, OutputBuffering::Full, Dispatch::Table);
+    });
+}
+
+void benchmarkRunOverhead()
+{
+    std::istringstream iss {"PRINT 1\n"};
+    ProgramUnit program;
+    program.compile(iss);
+
+    Benchmark {"trivial program run (program unit)", 20000}([&program]() {
+        std::ostringstream oss;
+        program.run(oss, OutputBuffering::Full);
+    });
+
+    auto compiled_program = std::move(program).seal();
+    std::ostringstream unused_oss;
+    auto executer = compiled_program.createExecuter(unused_oss);
+    Benchmark {"trivial program run (sealed program, reused executer)", 20000}(
+        [&compiled_program, &executer]() {
+            std::ostringstream oss;
+            compiled_program.run(executer, oss, OutputBuffering::Full);
+        });
+}
+
+int main()
+{
+    benchmarkRunOverhead();
+    benchmarkProgram("trivial program", "1", 1);
+    benchmarkProgram("nested integer add (depth 64)", nestedExpression("1", "+", 64), 16);
+    benchmarkProgram("nested double multiply (depth 64)", nestedExpression("1.0", "*", 64), 16);
+    benchmarkProgram("nested mixed add (depth 64)", nestedExpression("2", "+1.5-", 32), 16);
+    benchmarkProgram("flat integer add (length 128)", flatExpression("1", "+", 128), 16);
+    benchmarkProgram("nested string concatenate (depth 16)",
+        nestedExpression("\"ab\"", "+", 16), 16);
+    benchmarkProgram("flat string concatenate (length 64)", flatExpression("\"ab\"", "+", 64), 16);
+}
@@ -0,0 +1,104 @@
+/* vim:ts=4:sw=4:et:sts=4:
+ *
+ * Copyright 2016 Thunder422.  All rights reserved.
+ * Distributed under GNU General Public License Version 3
+ * (See accompanying file LICENSE or <http://www.gnu.org/licenses/>)
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include "benchmark.h"
+#include "mappedprogram.h"
+#include "programerror.h"
+#include "programimage.h"
+#include "programunit.h"
+
+
+constexpr unsigned LineCount = 100000;
+
+
+// the constants repeat so that the constant dictionaries stay within their limits
+std::string generateSource()
+{
+    std::ostringstream source;
+    for (unsigned i = 0; i < LineCount; ++i) {
+        auto number = i % 1000;
+        switch (i % 4) {
+        case 0:
+            source << "PRINT " << number << " + 2 * 3.5 - " << number << " / 7\n";
+            break;
+        case 1:
+            source << "PRINT \"line\" + \"" << number << "\";\n";
+            break;
+        case 2:
+            source << "PRINT ABS(-" << number << "), " << number << " MOD 7\n";
+            break;
+        case 3:
+            source << "PRINT (" << number << " < 500) AND (" << number << " >= 2) OR 1\n";
+            break;
+        }
+    }
+    return source.str();
+}
+
+// compiled the same as ibc compiles a program
+void compile(ProgramUnit &program, const std::string &source)
+{
+    std::istringstream iss {source};
+    program.setConstantFolding(true);
+    program.compile(iss);
+    program.fuseCode();
+}
+
+
+int main()
+{
+    auto source = generateSource();
+    auto source_hash = ProgramImage::hashSource(source);
+    ProgramUnit program;
+    compile(program, source);
+    std::ostringstream image;
+    ProgramImage::save(image, program, source_hash);
+    auto image_string = image.str();
+    std::cout << LineCount << " lines: " << source.size() << " source bytes, "
+        << image_string.size() << " image bytes" << std::endl;
+
+    Benchmark {"cold compile of 100k lines", 5}([&source]() {
+        ProgramUnit program;
+        compile(program, source);
+    });
+    Benchmark {"hash of 100k line source", 5}([&source]() {
+        ProgramImage::hashSource(source);
+    });
+    Benchmark {"save image of 100k lines", 5}([&program, source_hash]() {
+        std::ostringstream oss;
+        ProgramImage::save(oss, program, source_hash);
+    });
+    Benchmark {"load image of 100k lines", 5}([&image_string, source_hash]() {
+        std::istringstream iss {image_string};
+        ProgramUnit program;
+        program.setConstantFolding(true);
+        ProgramImage::load(iss, program, source_hash);
+    });
+
+    std::string image_file_name {"image_benchmark.ibc"};
+    {
+        std::ofstream ofs {image_file_name, std::ios::binary};
+        ofs << image_string;
+    }
+    Benchmark {"map image of 100k lines (run in place)", 5}([&image_file_name, source_hash]() {
+        MappedProgram mapped_program {image_file_name, source_hash, true};
+        if (!mapped_program.runsInPlace()) {
+            std::cerr << "image not mapped" << std::endl;
+        }
+    });
+    Benchmark {"map image of 100k lines and load program unit", 5}(
+        [&image_file_name, source_hash]() {
+            MappedProgram mapped_program {image_file_name, source_hash, true};
+            ProgramUnit program;
+            mapped_program.load(program);
+        });
+    std::remove(image_file_name.c_str());
+}
@@ -0,0 +1,89 @@
+/* vim:ts=4:sw=4:et:sts=4:
+ *
+ * Copyright 2016 Thunder422.  All rights reserved.
+ * Distributed under GNU General Public License Version 3
+ * (See accompanying file LICENSE or <http://www.gnu.org/licenses/>)
+ */
+
+#include <cmath>
+#include <random>
+#include <sstream>
+#include <vector>
+
+#include "benchmark.h"
+#include "numberformat.h"
+#include "programerror.h"
+#include "programunit.h"
+
+
+constexpr unsigned ValueCount = 1000;
+
+
+std::size_t format(char *buffer, int32_t value)
+{
+    return formatInteger(buffer, value);
+}
+
+std::size_t format(char *buffer, double value)
+{
+    return formatDouble(buffer, value);
+}
+
+template <typename T>
+void benchmarkFormat(const std::string &name, const std::vector<T> &values)
+{
+    Benchmark {name + " (stream)", 200}([&values]() {
+        std::ostringstream oss;
+        for (auto value : values) {
+            oss << value;
+        }
+    });
+    Benchmark {name + " (formatter)", 200}([&values]() {
+        std::string output;
+        char buffer[MaximumDoubleLength];
+        for (auto value : values) {
+            output.append(buffer, format(buffer, value));
+        }
+    });
+}
+
+void benchmarkPrint(const std::string &name, const std::string &item, unsigned lines)
+{
+    std::ostringstream source;
+    for (unsigned i = 0; i < lines; ++i) {
+        source << "PRINT " << item << '\n';
+    }
+    std::istringstream iss {source.str()};
+    ProgramUnit program;
+    program.compile(iss);
+
+    Benchmark {name, 2000}([&program]() {
+        std::ostringstream oss;
+        program.run(oss, OutputBuffering::Full);
+    });
+}
+
+int main()
+{
+    std::mt19937 generator {1};
+    std::uniform_int_distribution<int32_t> integer {-1000000, 1000000};
+    std::uniform_real_distribution<double> fixed {-1000.0, 1000.0};
+    std::uniform_real_distribution<double> mantissa {1.0, 10.0};
+    std::uniform_int_distribution<int> exponent {-30, 30};
+
+    std::vector<int32_t> integers;
+    std::vector<double> fixed_doubles;
+    std::vector<double> exponent_doubles;
+    for (unsigned i = 0; i < ValueCount; ++i) {
+        integers.push_back(integer(generator));
+        fixed_doubles.push_back(fixed(generator));
+        exponent_doubles.push_back(mantissa(generator) * std::pow(10.0, exponent(generator)));
+    }
+    std::string count = " (" + std::to_string(ValueCount) + " values)";
+    benchmarkFormat("format integers" + count, integers);
+    benchmarkFormat("format fixed doubles" + count, fixed_doubles);
+    benchmarkFormat("format exponent doubles" + count, exponent_doubles);
+
+    benchmarkPrint("print integers (100 lines)", "-123456", 100);
+    benchmarkPrint("print doubles (100 lines)", "-2.45", 100);
+}
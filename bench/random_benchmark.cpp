@@ -0,0 +1,76 @@
+/* vim:ts=4:sw=4:et:sts=4:
+ *
+ * Copyright 2016 Thunder422.  All rights reserved.
+ * Distributed under GNU General Public License Version 3
+ * (See accompanying file LICENSE or <http://www.gnu.org/licenses/>)
+ */
+
+#include <sstream>
+#include <utility>
+
+#include "benchmark.h"
+#include "compiledprogram.h"
+#include "programerror.h"
+#include "programunit.h"
+#include "randomgenerator.h"
+
+
+constexpr unsigned NumberCount = 1000;
+
+
+void benchmarkGenerator(const std::string &name, RandomEngine engine)
+{
+    auto generator = RandomGenerator::create(engine);
+    double sum = 0;
+    Benchmark {"RND" + name, 1000}([&generator, &sum]() {
+        for (unsigned i = 0; i < NumberCount; ++i) {
+            sum += generator->getNumber();
+        }
+    });
+    Benchmark {"RND(6)" + name, 1000}([&generator, &sum]() {
+        for (unsigned i = 0; i < NumberCount; ++i) {
+            sum += generator->getNumber(6);
+        }
+    });
+    if (sum < 0) {
+        std::cout << sum << std::endl;  // keeps the loops from being optimized away
+    }
+}
+
+void benchmarkProgram(const std::string &name, RandomEngine engine, const std::string &term)
+{
+    std::ostringstream source;
+    for (unsigned line = 0; line < 16; ++line) {
+        source << "PRINT " << term;
+        for (unsigned i = 1; i < 64; ++i) {
+            source << '+' << term;
+        }
+        source << '\n';
+    }
+    std::istringstream iss {source.str()};
+    ProgramUnit program;
+    program.compile(iss);
+    auto compiled_program = std::move(program).seal();
+    std::ostringstream unused_oss;
+    auto executer = compiled_program.createExecuter(unused_oss, OutputBuffering::Full);
+    executer.setRandomGenerator(engine);
+
+    Benchmark {"program of 1024 " + term + name, 1000}([&compiled_program, &executer]() {
+        std::ostringstream oss;
+        compiled_program.run(executer, oss, OutputBuffering::Full);
+    });
+}
+
+int main()
+{
+    std::string count = " x" + std::to_string(NumberCount);
+    benchmarkGenerator(count + " (standard)", RandomEngine::Standard);
+    benchmarkGenerator(count + " (mersenne twister)", RandomEngine::MersenneTwister);
+    benchmarkGenerator(count + " (xoshiro)", RandomEngine::Xoshiro);
+
+    for (auto term : {"RND", "RND(6)"}) {
+        benchmarkProgram(" (standard)", RandomEngine::Standard, term);
+        benchmarkProgram(" (mersenne twister)", RandomEngine::MersenneTwister, term);
+        benchmarkProgram(" (xoshiro)", RandomEngine::Xoshiro, term);
+    }
+}
@@ -0,0 +1,79 @@
+/* vim:ts=4:sw=4:et:sts=4:
+ *
+ * Copyright 2016 Thunder422.  All rights reserved.
+ * Distributed under GNU General Public License Version 3
+ * (See accompanying file LICENSE or <http://www.gnu.org/licenses/>)
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include "benchmark.h"
+#include "mappedfile.h"
+#include "programerror.h"
+#include "programunit.h"
+
+
+constexpr unsigned LineCount = 250000;
+
+
+// a generated program of several megabytes
+std::string generateSource()
+{
+    std::ostringstream source;
+    for (unsigned i = 0; i < LineCount; ++i) {
+        auto number = i % 1000;
+        switch (i % 4) {
+        case 0:
+            source << "PRINT " << number << " + 2 * 3.5 - " << number << " / 7\n";
+            break;
+        case 1:
+            source << "PRINT \"line\" + \"" << number << "\"\n";
+            break;
+        case 2:
+            source << "PRINT ABS(-" << number << ") + " << number << " MOD 7\n";
+            break;
+        case 3:
+            source << "PRINT (" << number << " < 500) AND (" << number << " >= 2) OR 1\n";
+            break;
+        }
+    }
+    return source.str();
+}
+
+void printMegabytesPerSecond(std::size_t size, double nanoseconds_per_compile)
+{
+    std::cout << std::left << std::setw(56) << "compile throughput" << std::right
+        << std::setw(14) << std::setprecision(1) << size * 1e3 / nanoseconds_per_compile
+        << " MB/second" << std::endl;
+}
+
+
+int main()
+{
+    auto source = generateSource();
+    std::string file_name {"source_benchmark.bas"};
+    {
+        std::ofstream ofs {file_name};
+        ofs << source;
+    }
+    std::cout << LineCount << " lines: " << source.size() << " source bytes" << std::endl;
+
+    auto stream_time = Benchmark {"compile source file read a line at a time", 5}(
+        [&file_name]() {
+            std::ifstream ifs {file_name};
+            ProgramUnit program;
+            program.compile(ifs);
+        });
+    printMegabytesPerSecond(source.size(), stream_time);
+
+    auto mapped_time = Benchmark {"compile mapped source file", 5}([&file_name]() {
+        MappedFile mapped_source {file_name};
+        ProgramUnit program;
+        program.compile(mapped_source.data(), mapped_source.size());
+    });
+    printMegabytesPerSecond(source.size(), mapped_time);
+
+    std::remove(file_name.c_str());
+}
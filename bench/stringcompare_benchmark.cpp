@@ -0,0 +1,69 @@
+/* vim:ts=4:sw=4:et:sts=4:
+ *
+ * Copyright 2016 Thunder422.  All rights reserved.
+ * Distributed under GNU General Public License Version 3
+ * (See accompanying file LICENSE or <http://www.gnu.org/licenses/>)
+ */
+
+#include "benchmark.h"
+#include "stringcompare.h"
+
+
+const char *kernelName(StringCompareKernel kernel)
+{
+    switch (kernel) {
+    case StringCompareKernel::Scalar:
+        return "scalar";
+    case StringCompareKernel::Sse2:
+        return "sse2";
+    case StringCompareKernel::Avx2:
+        return "avx2";
+    }
+    return "";
+}
+
+// the strings only differ in the last character so that every character is compared
+unsigned benchmarkLength(std::size_t length, StringCompareKernel kernel)
+{
+    std::string lhs(length, 'x');
+    auto rhs = lhs;
+    rhs.back() = 'y';
+    auto iterations = static_cast<unsigned>(std::max<std::size_t>(16 * 1024 * 1024 / length, 16));
+    iterations = std::min(iterations, 1000000u);
+    auto suffix = " (" + std::to_string(length) + " bytes, " + kernelName(kernel) + ")";
+
+    unsigned count = 0;
+    setStringCompareKernel(kernel);
+    Benchmark {"equal" + suffix, iterations}([&lhs, &rhs, &count]() {
+        count += equalStrings(lhs, rhs);
+    });
+    Benchmark {"less than" + suffix, iterations}([&lhs, &rhs, &count]() {
+        count += compareStrings(lhs, rhs) < 0;
+    });
+    if (kernel == StringCompareKernel::Scalar) {
+        // the volatile pointer keeps the inline comparison from being moved out of the loop
+        const std::string *volatile lhs_pointer = &lhs;
+        auto std_suffix = " (" + std::to_string(length) + " bytes, std::string)";
+        Benchmark {"less than" + std_suffix, iterations}([&lhs_pointer, &rhs, &count]() {
+            count += *lhs_pointer < rhs;
+        });
+    }
+    return count;
+}
+
+
+int main()
+{
+    unsigned count = 0;
+    for (std::size_t length = 1; length <= 1024 * 1024; length *= 16) {
+        for (auto kernel : {StringCompareKernel::Scalar, StringCompareKernel::Sse2,
+                StringCompareKernel::Avx2}) {
+            if (isStringCompareKernelSupported(kernel)) {
+                count += benchmarkLength(length, kernel);
+            }
+        }
+    }
+    if (count == 0) {
+        std::cout << count << std::endl;  // keeps the comparisons from being optimized away
+    }
+}
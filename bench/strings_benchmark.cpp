@@ -0,0 +1,68 @@
+/* vim:ts=4:sw=4:et:sts=4:
+ *
+ * Copyright 2016 Thunder422.  All rights reserved.
+ * Distributed under GNU General Public License Version 3
+ * (See accompanying file LICENSE or <http://www.gnu.org/licenses/>)
+ */
+
+#include <sstream>
+
+#include "benchmark.h"
+#include "programerror.h"
+#include "programunit.h"
+
+
+// a chain of concatenations is compiled to one instruction
+std::string chainExpression(const std::string &operand, unsigned length)
+{
+    std::string expression = operand;
+    for (unsigned i = 1; i < length; ++i) {
+        expression += '+' + operand;
+    }
+    return expression;
+}
+
+// the parentheses end each chain, so each concatenation is a binary instruction
+std::string pairwiseExpression(const std::string &operand, unsigned length)
+{
+    std::string expression(length - 1, '(');
+    expression += operand;
+    for (unsigned i = 1; i < length; ++i) {
+        expression += '+' + operand + ')';
+    }
+    return expression;
+}
+
+void benchmarkConcatenation(const std::string &name, const std::string &expression)
+{
+    std::ostringstream source;
+    for (unsigned i = 0; i < 16; ++i) {
+        source << "PRINT " << expression << '\n';
+    }
+    std::istringstream iss {source.str()};
+    ProgramUnit program;
+    program.compile(iss);
+
+    Benchmark {name, 2000}([&program]() {
+        std::ostringstream oss;
+        program.run(oss, OutputBuffering::Full);
+    });
+}
+
+
+int main()
+{
+    std::string short_operand {"\"ab\""};
+    std::string long_operand {"\"" + std::string(40, 'x') + "\""};
+    for (auto length : {4u, 16u, 64u}) {
+        auto suffix = " (length " + std::to_string(length) + ")";
+        benchmarkConcatenation("pairwise short strings" + suffix,
+            pairwiseExpression(short_operand, length));
+        benchmarkConcatenation("chained short strings" + suffix,
+            chainExpression(short_operand, length));
+        benchmarkConcatenation("pairwise long strings" + suffix,
+            pairwiseExpression(long_operand, length));
+        benchmarkConcatenation("chained long strings" + suffix,
+            chainExpression(long_operand, length));
+    }
+}
@@ -8,10 +8,24 @@
 #ifndef IBC_CISTRING_H
 #define IBC_CISTRING_H
 
-#include <cctype>
-#include <iostream>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
 #include <string>
 
+#include "stringview.h"
+
+
+// case insensitive characters are compared as lower case ASCII (words are ASCII), which is
+// converted without a locale and without branches; characters that are not ASCII are unchanged
+
+char lowerCase(char c);
+uint64_t lowerCase8(uint64_t characters);  // eight characters at a time
+uint32_t hashLowerCase(const char *s, std::size_t n, uint32_t seed = 0);
+bool equalLowerCase(const char *s1, const char *s2, std::size_t n);
+
+
 struct ci_char_traits : public std::char_traits<char> {
     static bool eq(char c1, char c2);
     static bool lt(char c1, char c2);
@@ -20,23 +34,89 @@ struct ci_char_traits : public std::char_traits<char> {
     static const char *find(const char *s, int n, char c);
 };
 
+inline char lowerCase(char c)
+{
+    auto upper = static_cast<unsigned char>(c - 'A') < 26;
+    return static_cast<char>(c | (upper << 5));
+}
+
+// the high bit of each byte is set for the upper case letters (characters from 'A' to 'Z'
+// without the high bit, plus 0x80 - 'A' overflows into the high bit but plus 0x7f - 'Z' does
+// not), which is shifted to the case bit
+inline uint64_t lowerCase8(uint64_t characters)
+{
+    constexpr uint64_t Ones = UINT64_C(0x0101010101010101);
+    constexpr uint64_t HighBits = Ones * 0x80;
+
+    auto ascii = characters & ~HighBits;
+    auto at_least_a = ascii + Ones * (0x80 - 'A');
+    auto after_z = ascii + Ones * (0x7f - 'Z');
+    auto upper = (at_least_a ^ after_z) & ~characters & HighBits;
+    return characters | (upper >> 2);
+}
+
+// FNV-1a of the lower case characters
+inline uint32_t hashLowerCase(const char *s, std::size_t n, uint32_t seed)
+{
+    uint32_t hash = 2166136261u ^ seed;
+    while (n-- != 0) {
+        hash ^= static_cast<unsigned char>(lowerCase(*s++));
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+inline bool equalLowerCase(const char *s1, const char *s2, std::size_t n)
+{
+    for (; n >= sizeof(uint64_t); n -= sizeof(uint64_t)) {
+        uint64_t word1;
+        uint64_t word2;
+        std::memcpy(&word1, s1, sizeof(uint64_t));
+        std::memcpy(&word2, s2, sizeof(uint64_t));
+        if (lowerCase8(word1) != lowerCase8(word2)) {
+            return false;
+        }
+        s1 += sizeof(uint64_t);
+        s2 += sizeof(uint64_t);
+    }
+    while (n-- != 0) {
+        if (lowerCase(*s1++) != lowerCase(*s2++)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 inline bool ci_char_traits::eq(char c1, char c2)
 {
-    return std::tolower(c1) == std::tolower(c2);
+    return lowerCase(c1) == lowerCase(c2);
 }
 
 inline bool ci_char_traits::lt(char c1, char c2)
 {
-    return std::tolower(c1) < std::tolower(c2);
+    return static_cast<unsigned char>(lowerCase(c1)) < static_cast<unsigned char>(lowerCase(c2));
 }
 
 inline bool ci_char_traits::gt(char c1, char c2)
 {
-    return std::tolower(c1) > std::tolower(c2);
+    return static_cast<unsigned char>(lowerCase(c1)) > static_cast<unsigned char>(lowerCase(c2));
 }
 
+// equal characters are skipped eight at a time, then the first character that is not equal
+// determines the result
 inline int ci_char_traits::compare(const char *s1, const char *s2, size_t n)
 {
+    for (; n >= sizeof(uint64_t); n -= sizeof(uint64_t)) {
+        uint64_t word1;
+        uint64_t word2;
+        std::memcpy(&word1, s1, sizeof(uint64_t));
+        std::memcpy(&word2, s2, sizeof(uint64_t));
+        if (lowerCase8(word1) != lowerCase8(word2)) {
+            break;
+        }
+        s1 += sizeof(uint64_t);
+        s2 += sizeof(uint64_t);
+    }
     while (n-- != 0) {
         if (lt(*s1, *s2)) {
             return -1;
@@ -52,7 +132,8 @@ inline int ci_char_traits::compare(const char *s1, const char *s2, size_t n)
 
 inline const char *ci_char_traits::find(const char *s, int n, char c)
 {
-    while (n-- > 0 && !eq(*s, c)) {
+    auto lower_c = lowerCase(c);
+    while (n-- > 0 && lowerCase(*s) != lower_c) {
         ++s;
     }
     return n >= 0 ? s : 0;
@@ -62,6 +143,12 @@ inline const char *ci_char_traits::find(const char *s, int n, char c)
 typedef std::basic_string<char, ci_char_traits> ci_string;
 
 
+// a case insensitive view of characters that are not owned (like a word of a source line),
+// so that a word can be looked up without copying it into a string
+
+using ci_string_view = BasicStringView<ci_char_traits>;
+
+
 inline bool operator==(const ci_string &lhs, const std::string &rhs)
 {
     return lhs == rhs.c_str();
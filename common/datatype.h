@@ -18,6 +18,8 @@ public:
 
     DataType();
     explicit operator bool() const;
+    bool operator==(DataType other) const;
+    bool operator!=(DataType other) const;
     bool isDouble() const;
     bool isInteger() const;
     bool isString() const;
@@ -75,6 +77,16 @@ inline DataType::operator bool() const
     return value != Enum::Null;
 }
 
+inline bool DataType::operator==(DataType other) const
+{
+    return value == other.value;
+}
+
+inline bool DataType::operator!=(DataType other) const
+{
+    return value != other.value;
+}
+
 inline bool DataType::isDouble() const
 {
     return value == Enum::Double;
@@ -5,37 +5,104 @@
  * (See accompanying file LICENSE or <http://www.gnu.org/licenses/>)
  */
 
+#include <cstring>
+#include <limits>
+
 #include "dictionary.h"
 
-Dictionary::Dictionary()
+
+constexpr std::size_t InitialHashTableSize = 16;
+constexpr uint32_t EmptySlot = 0;
+
+
+Dictionary::Dictionary() :
+    offsets {0},
+    slots(InitialHashTableSize, EmptySlot)
+{
+}
+
+Dictionary::Entry Dictionary::add(StringView string)
+{
+    auto string_hash = hash(string.data(), string.length());
+    auto &slot = findSlot(string.data(), string.length(), string_hash);
+    if (slot != EmptySlot) {
+        return Entry {slot - 1, true};
+    }
+    auto index = addEntry(string, string_hash);
+    slot = index + 1;
+    if (2 * size() > slots.size()) {
+        growHashTable();
+    }
+    return Entry {index, false};
+}
+
+// FNV-1a
+uint32_t Dictionary::hash(const char *string, std::size_t length)
 {
+    uint32_t string_hash = 2166136261u;
+    while (length-- != 0) {
+        string_hash ^= static_cast<unsigned char>(*string++);
+        string_hash *= 16777619u;
+    }
+    return string_hash;
 }
 
-Dictionary::Entry Dictionary::add(const std::string &string)
+// returns the slot of the entry, or the empty slot where the entry would be added
+uint32_t &Dictionary::findSlot(const char *string, std::size_t length, uint32_t string_hash)
 {
-    auto key_map_entry = addToKeyMap(string);
-    auto entry = addToKeyIteratorVector(key_map_entry);
-    return entry;
+    auto mask = slots.size() - 1;
+    for (auto slot_index = string_hash & mask; ; slot_index = (slot_index + 1) & mask) {
+        auto &slot = slots[slot_index];
+        if (slot == EmptySlot) {
+            return slot;
+        }
+        auto index = slot - 1;
+        if (hashes[index] == string_hash && offsets[index + 1] - offsets[index] == length
+                && std::memcmp(characters.data() + offsets[index], string, length) == 0) {
+            return slot;
+        }
+    }
 }
 
-Dictionary::KeyMapEntry Dictionary::addToKeyMap(const std::string &string)
+// the index plus one of the last entry must fit in a slot, as must the offset of its end
+unsigned Dictionary::addEntry(StringView string, uint32_t string_hash)
 {
-    auto index = static_cast<WordType>(key_map.size());
-    auto emplace_result = key_map.emplace(string, index);
-    return KeyMapEntry {emplace_result.first, !emplace_result.second};
+    constexpr auto MaximumOffset = std::numeric_limits<uint32_t>::max();
+
+    auto index = size();
+    if (index >= MaximumLongOperand || string.length() > MaximumOffset - characters.size()) {
+        throw FullError {};
+    }
+    characters.insert(characters.end(), string.begin(), string.end());
+    offsets.push_back(characters.size());
+    hashes.push_back(string_hash);
+    return index;
 }
 
-Dictionary::Entry Dictionary::addToKeyIteratorVector(const Dictionary::KeyMapEntry &key_map_entry)
+// the table is kept at most half full so that the probe sequences stay short
+void Dictionary::growHashTable()
 {
-    if (!key_map_entry.key_exists) {
-        key_iterator.emplace_back(key_map_entry.iterator);
+    std::vector<uint32_t> old_slots(2 * slots.size(), EmptySlot);
+    slots.swap(old_slots);
+    auto mask = slots.size() - 1;
+    for (auto slot : old_slots) {
+        if (slot != EmptySlot) {
+            auto slot_index = hashes[slot - 1] & mask;
+            while (slots[slot_index] != EmptySlot) {
+                slot_index = (slot_index + 1) & mask;
+            }
+            slots[slot_index] = slot;
+        }
     }
-    auto entry_value = key_map_entry.iterator->second;
-    auto operand = entry_value.index;
-    return Entry {operand, key_map_entry.key_exists};
 }
 
-std::string Dictionary::get(WordType index) const
+Dictionary::MemoryUsage Dictionary::getMemoryUsage() const
 {
-    return key_iterator[index]->first;
+    return MemoryUsage {
+        size(),
+        characters.capacity() * sizeof(char),
+        offsets.capacity() * sizeof(uint32_t) + hashes.capacity() * sizeof(uint32_t),
+        slots.capacity() * sizeof(uint32_t),
+        0
+    };
 }
@@ -8,46 +8,84 @@
 #ifndef IBC_DICTIONARY_H
 #define IBC_DICTIONARY_H
 
-#include <unordered_map>
+#include <cstdint>
+#include <string>
 #include <vector>
 
+#include "stringview.h"
 #include "wordtype.h"
 
 
+// the characters of the entries are one after another in one array (an arena), and the entries
+// are found with an open addressing hash table of entry indexes (linear probing), so an entry
+// only needs the offset of its characters and its hash (which is compared before the characters
+// and is used to place the entries when the table grows); the view of an entry (and the arrays
+// of the characters and offsets) is valid until another entry is added
+
 class Dictionary {
 public:
     struct Entry {
-        WordType operand;
+        unsigned operand;
         bool exists;
     };
 
+    struct MemoryUsage {
+        unsigned entry_count;
+        std::size_t characters;     // bytes allocated for each part of the dictionary
+        std::size_t entries;
+        std::size_t hash_table;
+        std::size_t values;         // of the entries (by a derived dictionary)
+
+        std::size_t total() const;
+    };
+
+    // thrown when there is no index for another entry
+    struct FullError { };
+
     Dictionary();
-    Entry add(const std::string &string);
-    std::string get(WordType index) const;
+    Entry add(StringView string);
+    StringView get(unsigned index) const;
+    unsigned size() const;
+    const char *getCharacters() const;
+    const uint32_t *getOffsets() const;
+    MemoryUsage getMemoryUsage() const;
 
 private:
-    struct EntryValue {
-        EntryValue(WordType index);
+    static uint32_t hash(const char *string, std::size_t length);
+    uint32_t &findSlot(const char *string, std::size_t length, uint32_t string_hash);
+    unsigned addEntry(StringView string, uint32_t string_hash);
+    void growHashTable();
 
-        WordType index;
-    };
+    std::vector<char> characters;
+    std::vector<uint32_t> offsets;      // of each entry, then of the end of the last entry
+    std::vector<uint32_t> hashes;
+    std::vector<uint32_t> slots;        // index of an entry plus one
+};
 
-    using KeyMap = std::unordered_map<std::string, EntryValue>;
-    struct KeyMapEntry {
-        KeyMap::iterator iterator;
-        bool key_exists;
-    };
-    Dictionary::KeyMapEntry addToKeyMap(const std::string &string);
-    Entry addToKeyIteratorVector(const Dictionary::KeyMapEntry &key_map_entry);
 
-    KeyMap key_map;
-    std::vector<KeyMap::iterator> key_iterator;
-};
+inline StringView Dictionary::get(unsigned index) const
+{
+    return StringView {characters.data() + offsets[index], offsets[index + 1] - offsets[index]};
+}
 
+inline unsigned Dictionary::size() const
+{
+    return hashes.size();
+}
+
+inline const char *Dictionary::getCharacters() const
+{
+    return characters.data();
+}
+
+inline const uint32_t *Dictionary::getOffsets() const
+{
+    return offsets.data();
+}
 
-inline Dictionary::EntryValue::EntryValue(WordType index) :
-    index {index}
+inline std::size_t Dictionary::MemoryUsage::total() const
 {
+    return characters + entries + hash_table + values;
 }
 
 
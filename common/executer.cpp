@@ -11,33 +11,82 @@
 #include "executer.h"
 
 
-std::default_random_engine random_number_generator;
-
-
 Executer::Executer(const WordType *code, const double *const_dbl_values,
-        const int32_t *const_int_values, const std::unique_ptr<std::string> *const_str_values,
-        std::ostream &os) :
+        const int32_t *const_int_values, const char *const_str_characters,
+        const uint32_t *const_str_offsets, unsigned stack_size, std::ostream &os,
+        OutputBuffering buffering, Dispatch dispatch) :
     code {code},
     execute_functions {Code::getExecuteFunctions()},
+    dispatch {dispatch},
     const_dbl_values {const_dbl_values},
     const_int_values {const_int_values},
-    const_str_values {const_str_values},
-    os {os}
+    const_str_characters {const_str_characters},
+    const_str_offsets {const_str_offsets},
+    buffered_output {new BufferedOutput {os, buffering}},
+    string_pool {stack_size},
+    random_generator {RandomGenerator::create(RandomEngine::Standard)}
 {
+    allocateStack(stack_size);
     reset();
 }
 
+void Executer::allocateStack(unsigned stack_size)
+{
+    constexpr std::size_t CacheLineSize = 64;
+
+    // the first item is never used so that the top pointer always points to a valid item
+    auto size = (std::size_t {stack_size} + 1) * sizeof(StackItem);
+    auto space = size + CacheLineSize;
+    stack_storage.reset(new char[space]);
+    void *storage = stack_storage.get();
+    stack_base = static_cast<StackItem *>(std::align(CacheLineSize, size, storage, space));
+    stack_capacity = stack_size;
+}
+
+// the executer can be reused for other code (with constants that may have moved as they were
+// added to), the stack is only allocated again when it needs to be larger
+void Executer::setCode(const WordType *code, const double *const_dbl_values,
+    const int32_t *const_int_values, const char *const_str_characters,
+    const uint32_t *const_str_offsets, unsigned stack_size)
+{
+    this->code = code;
+    this->const_dbl_values = const_dbl_values;
+    this->const_int_values = const_int_values;
+    this->const_str_characters = const_str_characters;
+    this->const_str_offsets = const_str_offsets;
+    if (stack_size > stack_capacity) {
+        allocateStack(stack_size);
+    }
+    reset();
+}
+
+void Executer::setDispatch(Dispatch dispatch)
+{
+    this->dispatch = dispatch;
+}
+
 void Executer::run()
 {
     reset();
-    for (;;) {
-        executeOneCode();
+    if (dispatch == Dispatch::Labels && Code::getCodeCount() <= MaximumLabelCodes) {
+        runWithLabels();
+    } else {
+        runWithTable();
     }
+    if (!hasRunError() && !stackEmpty()) {
+        setRunError("BUG: value stack not empty at end of program");
+    }
+    buffered_output->flush();
 }
 
 void Executer::reset()
 {
     program_counter = const_cast<WordType *>(code);
+    stack_top = stack_base;
+    string_pool.releaseAll();
+    random_generator->seed(random_seed);
+    running = true;
+    run_error_message = nullptr;
 }
 
 void Executer::executeOneCode()
@@ -46,27 +95,129 @@ void Executer::executeOneCode()
     execute_functions[code_value](*this);
 }
 
+void Executer::runWithTable()
+{
+    while (running) {
+        executeOneCode();
+    }
+}
+
+// there is a label for each possible code value, which calls the execute function of the code
+// and jumps to the label of the next code; label addresses and computed gotos are extensions;
+// the code is not translated to label addresses first since the execute functions are defined
+// with their codes (so each label still calls one), and the label is found from the code value
+// as fast as from a translated copy, which would need to be rebuilt whenever the code is set
+
+#if defined(__GNUC__)
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+
+#define IBC_CODES_4(m, a, b, c) m(a, b, c, 0) m(a, b, c, 1) m(a, b, c, 2) m(a, b, c, 3)
+#define IBC_CODES_16(m, a, b) \
+    IBC_CODES_4(m, a, b, 0) IBC_CODES_4(m, a, b, 1) IBC_CODES_4(m, a, b, 2) IBC_CODES_4(m, a, b, 3)
+#define IBC_CODES_64(m, a) \
+    IBC_CODES_16(m, a, 0) IBC_CODES_16(m, a, 1) IBC_CODES_16(m, a, 2) IBC_CODES_16(m, a, 3)
+#define IBC_CODES_256(m) \
+    IBC_CODES_64(m, 0) IBC_CODES_64(m, 1) IBC_CODES_64(m, 2) IBC_CODES_64(m, 3)
+
+#define IBC_CODE_LABEL(a, b, c, d) &&code_##a##b##c##d,
+#define IBC_CODE_DISPATCH(a, b, c, d) \
+    code_##a##b##c##d: \
+        execute_functions[a * 64 + b * 16 + c * 4 + d](*this); \
+        goto *(running ? labels[*program_counter++] : &&stopped);
+
+static_assert(Executer::MaximumLabelCodes == 256, "one label is generated for each code value");
+
+void Executer::runWithLabels()
+{
+    static void *const labels[MaximumLabelCodes] = {IBC_CODES_256(IBC_CODE_LABEL)};
+
+    goto *labels[*program_counter++];
+    IBC_CODES_256(IBC_CODE_DISPATCH)
+stopped:
+    return;
+}
+
+#undef IBC_CODE_DISPATCH
+#undef IBC_CODE_LABEL
+#undef IBC_CODES_256
+#undef IBC_CODES_64
+#undef IBC_CODES_16
+#undef IBC_CODES_4
+
+#pragma GCC diagnostic pop
+
+#else
+
+void Executer::runWithLabels()
+{
+    runWithTable();
+}
+
+#endif
+
 unsigned Executer::currentOffset() const
 {
     return program_counter - code - 1;
 }
 
-std::ostream &Executer::output()
+void Executer::setRunError(const char *message)
 {
-    return os;
+    run_error_message = message;
+    run_error_offset = currentOffset();
+    stop();
+}
+
+bool Executer::hasRunError() const
+{
+    return run_error_message != nullptr;
+}
+
+RunError Executer::getRunError() const
+{
+    return RunError {run_error_message, run_error_offset};
+}
+
+BufferedOutput &Executer::output()
+{
+    return *buffered_output;
+}
+
+// the output of each run can go to a different stream
+void Executer::setOutput(std::ostream &os, OutputBuffering buffering)
+{
+    buffered_output->setStream(os, buffering);
+}
+
+void Executer::outputNewLine()
+{
+    buffered_output->newLine();
 }
 
 bool Executer::stackEmpty() const
 {
-    return stack.empty();
+    return stack_top == stack_base;
+}
+
+// each run starts with the seed so that the random numbers of every run are the same
+void Executer::setRandomGenerator(RandomEngine engine, uint64_t seed)
+{
+    random_generator = RandomGenerator::create(engine, seed);
+    random_seed = seed;
 }
 
 double Executer::getRandomNumber()
 {
-    return uniform_distribution(random_number_generator);
+    return random_generator->getNumber();
 }
 
 int32_t Executer::getRandomNumber(int32_t limit)
 {
-    return std::uniform_int_distribution<int>{1, limit}(random_number_generator);
+    return random_generator->getNumber(limit);
+}
+
+StringPool::Statistics Executer::getStringPoolStatistics() const
+{
+    return string_pool.getStatistics();
 }
@@ -10,125 +10,213 @@
 
 #include <iosfwd>
 #include <memory>
-#include <random>
-#include <stack>
 
 #include "code.h"
+#include "outputbuffer.h"
+#include "randomgenerator.h"
+#include "runerror.h"
+#include "stringpool.h"
+#include "stringview.h"
 #include "wordtype.h"
 
 
-using tmp_string = std::unique_ptr<std::string>;
+using tmp_string = std::unique_ptr<std::string, TmpStringReleaser>;
+
+// the codes are dispatched through the table of execute functions, or by jumping to a label for
+// each code value (when the compiler supports label addresses, otherwise the table is used), so
+// each code has its own jump to the next code that is predicted separately
+enum class Dispatch {
+    Table,
+    Labels
+};
 
 class Executer {
 public:
     struct StackItem {
         StackItem(double dbl_value);
         StackItem(int32_t int_value);
-        StackItem(const std::string *str_value);
 
         union {
             double dbl_value;
             int32_t int_value;
-            const std::string *str_value;
+            unsigned str_operand;       // of a string constant
             std::string *tmp_value;
         };
     };
 
-    Executer(const WordType *code, const double *const_dbl_values, const int32_t *const_int_values,
-        const std::unique_ptr<std::string> *const_str_values, std::ostream &os);
+    // the string constants are the characters between the offsets of each constant
+    Executer(const WordType *code, const double *const_dbl_values,
+        const int32_t *const_int_values, const char *const_str_characters,
+        const uint32_t *const_str_offsets, unsigned stack_size, std::ostream &os,
+        OutputBuffering buffering, Dispatch dispatch = Dispatch::Labels);
+    void setCode(const WordType *code, const double *const_dbl_values,
+        const int32_t *const_int_values, const char *const_str_characters,
+        const uint32_t *const_str_offsets, unsigned stack_size);
+    static constexpr unsigned MaximumLabelCodes = 256;  // or the table is used
+
+    void setDispatch(Dispatch dispatch);
     void run();
     void executeOneCode();
     unsigned currentOffset() const;
+    void stop();
+    bool isRunning() const;
+    void setRunError(const char *message);
+    bool hasRunError() const;
+    RunError getRunError() const;
 
     WordType getOperand();
+    unsigned getLongOperand();
+    WordType peekOperand() const;
+    void skipOperand();
+    void skipLongOperand();
     template <typename T> void push(T value);
-    void pushConstDbl(WordType operand);
-    void pushConstInt(WordType operand);
-    void pushConstStr(WordType operand);
+    void pushConstDbl(unsigned operand);
+    void pushConstInt(unsigned operand);
+    void pushConstStr(unsigned operand);
+    StringView constStr(unsigned operand) const;
     double topDbl() const;
     int32_t topInt() const;
-    const std::string *topStr() const;
+    StringView topStr() const;
     std::string *topTmpStr() const;
     tmp_string moveTopTmpStr();
     template <typename T> T top() const;
     double topIntAsDbl() const;
+    StackItem *topItems(unsigned count) const;
+    std::string *acquireTmpStr();
+    void releaseTmpStr(std::string *string);
     void pop();
+    void pop(unsigned count);
     void setTop(double value);
     void setTop(int32_t value);
     void setTopIntFromInt64(int64_t value);
     void setTopIntFromDouble(double value);
     void setTopIntFromBool(bool value);
     void setTop(std::string *value);
-    void setTop(const std::string &value);
-    std::ostream &output();
+    void setTop(StringView value);
+    void setOutput(std::ostream &os, OutputBuffering buffering);
+    BufferedOutput &output();
+    void outputNewLine();
     bool stackEmpty() const;
+    void setRandomGenerator(RandomEngine engine, uint64_t seed = RandomGenerator::DefaultSeed);
     double getRandomNumber();
     int32_t getRandomNumber(int32_t limit);
+    StringPool::Statistics getStringPoolStatistics() const;
 
 private:
     void reset();
+    void allocateStack(unsigned stack_size);
+    void runWithTable();
+    void runWithLabels();
 
     const WordType *code;
     const ExecuteFunctionPointer *execute_functions;
+    Dispatch dispatch;
     const double *const_dbl_values;
     const int32_t *const_int_values;
-    const std::unique_ptr<std::string> *const_str_values;
+    const char *const_str_characters;
+    const uint32_t *const_str_offsets;
 
     WordType *program_counter;
-    std::stack<StackItem> stack;
-    std::ostream &os;
-    std::uniform_real_distribution<double> uniform_distribution {0.0, 1.0};
+    std::unique_ptr<char[]> stack_storage;
+    StackItem *stack_base;
+    StackItem *stack_top;
+    unsigned stack_capacity;
+    bool running;
+    const char *run_error_message;
+    unsigned run_error_offset;
+    std::unique_ptr<BufferedOutput> buffered_output;
+    StringPool string_pool;
+    std::unique_ptr<RandomGenerator> random_generator;
+    uint64_t random_seed {RandomGenerator::DefaultSeed};
 };
 
+inline void Executer::stop()
+{
+    running = false;
+}
+
+inline bool Executer::isRunning() const
+{
+    return running;
+}
+
 inline WordType Executer::getOperand()
 {
     return *program_counter++;
 }
 
+inline unsigned Executer::getLongOperand()
+{
+    auto low_word = *program_counter++;
+    return longOperand(low_word, *program_counter++);
+}
+
+inline WordType Executer::peekOperand() const
+{
+    return *program_counter;
+}
+
+inline void Executer::skipOperand()
+{
+    ++program_counter;
+}
+
+inline void Executer::skipLongOperand()
+{
+    program_counter += LongOperandWords;
+}
+
 template <typename T>
 inline void Executer::push(T value)
 {
-    stack.emplace(value);
+    *++stack_top = StackItem {value};
 }
 
-inline void Executer::pushConstDbl(WordType operand)
+inline void Executer::pushConstDbl(unsigned operand)
 {
-    stack.emplace(const_dbl_values[operand]);
+    push(const_dbl_values[operand]);
 }
 
-inline void Executer::pushConstInt(WordType operand)
+inline void Executer::pushConstInt(unsigned operand)
 {
-    stack.emplace(const_int_values[operand]);
+    push(const_int_values[operand]);
 }
 
-inline void Executer::pushConstStr(WordType operand)
+inline void Executer::pushConstStr(unsigned operand)
 {
-    stack.emplace(const_str_values[operand].get());
+    ++stack_top;
+    stack_top->str_operand = operand;
+}
+
+inline StringView Executer::constStr(unsigned operand) const
+{
+    auto offset = const_str_offsets[operand];
+    return StringView {const_str_characters + offset, const_str_offsets[operand + 1] - offset};
 }
 
 inline double Executer::topDbl() const
 {
-    return stack.top().dbl_value;
+    return stack_top->dbl_value;
 }
 
 inline int32_t Executer::topInt() const
 {
-    return stack.top().int_value;
+    return stack_top->int_value;
 }
 
-inline const std::string *Executer::topStr() const
+inline StringView Executer::topStr() const
 {
-    return stack.top().str_value;
+    return constStr(stack_top->str_operand);
 }
 
 inline std::string *Executer::topTmpStr() const
 {
-    return stack.top().tmp_value;
+    return stack_top->tmp_value;
 }
 
 inline tmp_string Executer::moveTopTmpStr()
 {
-    return tmp_string{stack.top().tmp_value};
+    return tmp_string {stack_top->tmp_value, TmpStringReleaser {&string_pool}};
 }
 
 template <>
@@ -148,44 +236,66 @@ inline double Executer::topIntAsDbl() const
     return static_cast<double>(topInt());
 }
 
+// returns the first of the items on the top of the stack
+inline Executer::StackItem *Executer::topItems(unsigned count) const
+{
+    return stack_top - (count - 1);
+}
+
+inline std::string *Executer::acquireTmpStr()
+{
+    return string_pool.acquire();
+}
+
+inline void Executer::releaseTmpStr(std::string *string)
+{
+    string_pool.release(string);
+}
+
 inline void Executer::pop()
 {
-    stack.pop();
+    --stack_top;
+}
+
+inline void Executer::pop(unsigned count)
+{
+    stack_top -= count;
 }
 
 inline void Executer::setTop(double value)
 {
-    stack.top().dbl_value = value;
+    stack_top->dbl_value = value;
 }
 
 inline void Executer::setTop(int32_t value)
 {
-    stack.top().int_value = value;
+    stack_top->int_value = value;
 }
 
 inline void Executer::setTopIntFromInt64(int64_t value)
 {
-    stack.top().int_value = static_cast<int32_t>(value);
+    stack_top->int_value = static_cast<int32_t>(value);
 }
 
 inline void Executer::setTopIntFromDouble(double value)
 {
-    stack.top().int_value = static_cast<int32_t>(value);
+    stack_top->int_value = static_cast<int32_t>(value);
 }
 
 inline void Executer::setTopIntFromBool(bool value)
 {
-    stack.top().int_value = value ? -1 : 0;
+    stack_top->int_value = value ? -1 : 0;
 }
 
 inline void Executer::setTop(std::string *value)
 {
-    stack.top().str_value = value;
+    stack_top->tmp_value = value;
 }
 
-inline void Executer::setTop(const std::string &value)
+inline void Executer::setTop(StringView value)
 {
-    stack.top().tmp_value = new std::string{value};
+    stack_top->tmp_value = string_pool.acquire();
+    stack_top->tmp_value->assign(value.data(), value.length());
 }
 
 
@@ -199,13 +309,5 @@ inline Executer::StackItem::StackItem(int32_t int_value) :
 {
 }
 
-inline Executer::StackItem::StackItem(const std::string *str_value) :
-    str_value {str_value}
-{
-}
-
-
-struct EndOfProgram { };
-
 
 #endif  // IBC_EXECUTER_H
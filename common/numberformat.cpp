@@ -0,0 +1,149 @@
+/* vim:ts=4:sw=4:et:sts=4:
+ *
+ * Copyright 2016 Thunder422.  All rights reserved.
+ * Distributed under GNU General Public License Version 3
+ * (See accompanying file LICENSE or <http://www.gnu.org/licenses/>)
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include "numberformat.h"
+
+
+static const char digit_pairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+// writes the digits from the end of the buffer two at a time, returns the first digit
+static char *formatDigits(char *end, uint32_t value)
+{
+    while (value >= 100) {
+        auto pair = digit_pairs + value % 100 * 2;
+        value /= 100;
+        *--end = pair[1];
+        *--end = pair[0];
+    }
+    if (value >= 10) {
+        auto pair = digit_pairs + value * 2;
+        *--end = pair[1];
+        *--end = pair[0];
+    } else {
+        *--end = '0' + value;
+    }
+    return end;
+}
+
+std::size_t formatInteger(char *buffer, int32_t value)
+{
+    char digits[MaximumIntegerLength];
+    auto end = digits + MaximumIntegerLength;
+    auto magnitude = value < 0 ? 0u - static_cast<uint32_t>(value) : value;
+    auto begin = formatDigits(end, magnitude);
+    if (value < 0) {
+        *--begin = '-';
+    }
+    std::memcpy(buffer, begin, end - begin);
+    return end - begin;
+}
+
+// ----------------------------------------
+
+static const double powers_of_ten[] = {
+    1e-4, 1e-3, 1e-2, 1e-1, 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9
+};
+
+static double powerOfTen(int exponent)
+{
+    return powers_of_ten[exponent + 4];
+}
+
+// formats values that are shown without an exponent (1e-4 <= |value| < 1e6) by scaling the
+// value to a six digit integer; the scale (1 to 1e9) is exact, but the multiply by a large scale
+// can round, so the scaled value can be off by a rounding error, which only matters near halfway
+// between two six digit integers: returns zero when the value is within 1e-6 of halfway (far
+// more than the error) so that snprintf() rounds it, or when the rounding carries into a seventh
+// digit
+static std::size_t formatFixedDouble(char *buffer, double value)
+{
+    constexpr int SignificantDigits = 6;
+
+    auto magnitude = std::fabs(value);
+    int exponent = SignificantDigits - 1;
+    while (exponent > -4 && magnitude < powerOfTen(exponent)) {
+        --exponent;
+    }
+    auto scaled = magnitude * powerOfTen(SignificantDigits - 1 - exponent);
+    auto integer = std::floor(scaled);
+    auto fraction = scaled - integer;
+    if (std::fabs(fraction - 0.5) < 1e-6) {
+        return 0;
+    }
+    auto digits = static_cast<uint32_t>(integer) + (fraction > 0.5);
+    if (digits < 100000 || digits > 999999) {
+        return 0;
+    }
+
+    char digit_buffer[SignificantDigits];
+    formatDigits(digit_buffer + SignificantDigits, digits);
+    auto significant = SignificantDigits;
+    while (significant > exponent + 1 && digit_buffer[significant - 1] == '0') {
+        --significant;
+    }
+
+    auto output = buffer;
+    if (value < 0) {
+        *output++ = '-';
+    }
+    if (exponent < 0) {
+        *output++ = '0';
+        *output++ = '.';
+        for (int zeros = -exponent - 1; zeros > 0; --zeros) {
+            *output++ = '0';
+        }
+        std::memcpy(output, digit_buffer, significant);
+        output += significant;
+    } else {
+        std::memcpy(output, digit_buffer, exponent + 1);
+        output += exponent + 1;
+        if (significant > exponent + 1) {
+            *output++ = '.';
+            std::memcpy(output, digit_buffer + exponent + 1, significant - exponent - 1);
+            output += significant - exponent - 1;
+        }
+    }
+    return output - buffer;
+}
+
+std::size_t formatDouble(char *buffer, double value)
+{
+    if (value == 0) {
+        auto output = buffer;
+        if (std::signbit(value)) {
+            *output++ = '-';
+        }
+        *output++ = '0';
+        return output - buffer;
+    }
+    auto magnitude = std::fabs(value);
+    if (magnitude >= 1e-4 && magnitude < 1e6) {
+        if (auto length = formatFixedDouble(buffer, value)) {
+            return length;
+        }
+    }
+    return std::snprintf(buffer, MaximumDoubleLength, "%g", value);
+}
+
+std::size_t formatExactDouble(char *buffer, double value)
+{
+    return std::snprintf(buffer, MaximumExactDoubleLength, "%.17g", value);
+}
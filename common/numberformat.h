@@ -0,0 +1,28 @@
+/* vim:ts=4:sw=4:et:sts=4:
+ *
+ * Copyright 2016 Thunder422.  All rights reserved.
+ * Distributed under GNU General Public License Version 3
+ * (See accompanying file LICENSE or <http://www.gnu.org/licenses/>)
+ */
+
+#ifndef IBC_NUMBERFORMAT_H
+#define IBC_NUMBERFORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+
+
+// formats numbers exactly as the default format of an output stream (six significant digits
+// for doubles) without the stream, the number of characters put in the buffer is returned;
+// the exact format of a double has enough digits (17) to convert back to the same value
+
+constexpr std::size_t MaximumIntegerLength = 11;  // -2147483648
+constexpr std::size_t MaximumDoubleLength = 24;
+constexpr std::size_t MaximumExactDoubleLength = 25;  // -2.2250738585072014e-308 and a null
+
+std::size_t formatInteger(char *buffer, int32_t value);
+std::size_t formatDouble(char *buffer, double value);
+std::size_t formatExactDouble(char *buffer, double value);
+
+
+#endif  // IBC_NUMBERFORMAT_H
@@ -0,0 +1,81 @@
+/* vim:ts=4:sw=4:et:sts=4:
+ *
+ * Copyright 2016 Thunder422.  All rights reserved.
+ * Distributed under GNU General Public License Version 3
+ * (See accompanying file LICENSE or <http://www.gnu.org/licenses/>)
+ */
+
+#include "outputbuffer.h"
+
+
+OutputBuffer::OutputBuffer(std::ostream &os, OutputBuffering buffering) :
+    os {&os},
+    buffering {buffering}
+{
+}
+
+void OutputBuffer::setStream(std::ostream &os, OutputBuffering buffering)
+{
+    writeBuffer();
+    this->os = &os;
+    this->buffering = buffering;
+}
+
+// the buffer is not allocated until there is output (executers evaluating constant
+// expressions never output anything)
+OutputBuffer::int_type OutputBuffer::overflow(int_type ch)
+{
+    if (buffer) {
+        writeBuffer();
+    } else {
+        buffer.reset(new char[BufferSize]);
+        setp(buffer.get(), buffer.get() + BufferSize);
+    }
+    if (traits_type::eq_int_type(ch, traits_type::eof())) {
+        return traits_type::not_eof(ch);
+    }
+    *pptr() = traits_type::to_char_type(ch);
+    pbump(1);
+    return ch;
+}
+
+// the stream is only used when there is output, since the stream of a previous run may be gone
+int OutputBuffer::sync()
+{
+    writeBuffer();
+    if (!unflushed) {
+        return 0;
+    }
+    unflushed = false;
+    return os->flush() ? 0 : -1;
+}
+
+void OutputBuffer::writeBuffer()
+{
+    if (pptr() != pbase()) {
+        os->write(pbase(), pptr() - pbase());
+        unflushed = true;
+        setp(buffer.get(), buffer.get() + BufferSize);
+    }
+}
+
+// ----------------------------------------
+
+BufferedOutput::BufferedOutput(std::ostream &os, OutputBuffering buffering) :
+    std::ostream {nullptr},
+    output_buffer {os, buffering}
+{
+    rdbuf(&output_buffer);
+}
+
+BufferedOutput::~BufferedOutput()
+{
+    flush();
+}
+
+void BufferedOutput::setStream(std::ostream &os, OutputBuffering buffering)
+{
+    flush();
+    output_buffer.setStream(os, buffering);
+    clear();
+}
@@ -0,0 +1,92 @@
+/* vim:ts=4:sw=4:et:sts=4:
+ *
+ * Copyright 2016 Thunder422.  All rights reserved.
+ * Distributed under GNU General Public License Version 3
+ * (See accompanying file LICENSE or <http://www.gnu.org/licenses/>)
+ */
+
+#ifndef IBC_OUTPUTBUFFER_H
+#define IBC_OUTPUTBUFFER_H
+
+#include <memory>
+#include <ostream>
+#include <streambuf>
+
+#include "numberformat.h"
+
+
+enum class OutputBuffering {
+    Line,
+    Full
+};
+
+
+// holds the output of an executer until the buffer is full, until the end of a line when line
+// buffered or until flushed, and then writes it to the output stream with a single write
+
+class OutputBuffer : public std::streambuf {
+public:
+    OutputBuffer(std::ostream &os, OutputBuffering buffering);
+    void setStream(std::ostream &os, OutputBuffering buffering);
+    OutputBuffering getBuffering() const;
+
+protected:
+    int_type overflow(int_type ch) override;
+    int sync() override;
+
+private:
+    void writeBuffer();
+
+    static constexpr std::size_t BufferSize = 8192;
+
+    std::ostream *os;
+    OutputBuffering buffering;
+    std::unique_ptr<char[]> buffer;
+    bool unflushed {false};
+};
+
+
+class BufferedOutput : public std::ostream {
+public:
+    BufferedOutput(std::ostream &os, OutputBuffering buffering);
+    ~BufferedOutput();
+    void setStream(std::ostream &os, OutputBuffering buffering);
+    void newLine();
+    void writeInteger(int32_t value);
+    void writeDouble(double value);
+
+private:
+    OutputBuffer output_buffer;
+};
+
+
+inline OutputBuffering OutputBuffer::getBuffering() const
+{
+    return buffering;
+}
+
+inline void BufferedOutput::newLine()
+{
+    put('\n');
+    if (output_buffer.getBuffering() == OutputBuffering::Line) {
+        flush();
+    }
+}
+
+// numbers are formatted directly instead of through the stream, which would set up a sentry
+// and get the number formatting facet of the locale for every number
+
+inline void BufferedOutput::writeInteger(int32_t value)
+{
+    char buffer[MaximumIntegerLength];
+    output_buffer.sputn(buffer, formatInteger(buffer, value));
+}
+
+inline void BufferedOutput::writeDouble(double value)
+{
+    char buffer[MaximumDoubleLength];
+    output_buffer.sputn(buffer, formatDouble(buffer, value));
+}
+
+
+#endif  // IBC_OUTPUTBUFFER_H
@@ -0,0 +1,131 @@
+/* vim:ts=4:sw=4:et:sts=4:
+ *
+ * Copyright 2016 Thunder422.  All rights reserved.
+ * Distributed under GNU General Public License Version 3
+ * (See accompanying file LICENSE or <http://www.gnu.org/licenses/>)
+ */
+
+#include <random>
+
+#include "randomgenerator.h"
+
+
+// the standard engines use the standard distributions so that their numbers are the same as
+// they have always been
+
+template <typename Engine>
+class StandardRandomGenerator : public RandomGenerator {
+public:
+    StandardRandomGenerator(uint64_t seed);
+    void seed(uint64_t seed) override;
+    double getNumber() override;
+    int32_t getNumber(int32_t limit) override;
+
+private:
+    Engine engine;
+    std::uniform_real_distribution<double> distribution {0.0, 1.0};
+};
+
+template <typename Engine>
+StandardRandomGenerator<Engine>::StandardRandomGenerator(uint64_t seed) :
+    engine {static_cast<typename Engine::result_type>(seed)}
+{
+}
+
+template <typename Engine>
+void StandardRandomGenerator<Engine>::seed(uint64_t seed)
+{
+    engine.seed(static_cast<typename Engine::result_type>(seed));
+    distribution.reset();
+}
+
+template <typename Engine>
+double StandardRandomGenerator<Engine>::getNumber()
+{
+    return distribution(engine);
+}
+
+template <typename Engine>
+int32_t StandardRandomGenerator<Engine>::getNumber(int32_t limit)
+{
+    return std::uniform_int_distribution<int32_t> {1, limit}(engine);
+}
+
+// ----------------------------------------
+
+class XoshiroRandomGenerator : public RandomGenerator {
+public:
+    XoshiroRandomGenerator(uint64_t seed);
+    void seed(uint64_t seed) override;
+    double getNumber() override;
+    int32_t getNumber(int32_t limit) override;
+
+private:
+    Xoshiro256 engine;
+};
+
+XoshiroRandomGenerator::XoshiroRandomGenerator(uint64_t seed) :
+    engine {seed}
+{
+}
+
+void XoshiroRandomGenerator::seed(uint64_t seed)
+{
+    engine.seed(seed);
+}
+
+// the upper 53 bits fill the mantissa of the double
+double XoshiroRandomGenerator::getNumber()
+{
+    return (engine() >> 11) * (1.0 / (UINT64_C(1) << 53));
+}
+
+// multiplies a 32-bit random number by the limit and takes the upper 32 bits, rejecting the
+// few numbers that would make some results more likely than others (Lemire's method)
+int32_t XoshiroRandomGenerator::getNumber(int32_t limit)
+{
+    auto range = static_cast<uint32_t>(limit);
+    auto product = (engine() >> 32) * range;
+    if (static_cast<uint32_t>(product) < range) {
+        auto threshold = (0u - range) % range;
+        while (static_cast<uint32_t>(product) < threshold) {
+            product = (engine() >> 32) * range;
+        }
+    }
+    return static_cast<int32_t>(product >> 32) + 1;
+}
+
+// ----------------------------------------
+
+std::unique_ptr<RandomGenerator> RandomGenerator::create(RandomEngine engine, uint64_t seed)
+{
+    switch (engine) {
+    case RandomEngine::Standard:
+        return std::unique_ptr<RandomGenerator> {
+            new StandardRandomGenerator<std::default_random_engine> {seed}};
+    case RandomEngine::MersenneTwister:
+        return std::unique_ptr<RandomGenerator> {
+            new StandardRandomGenerator<std::mt19937> {seed}};
+    case RandomEngine::Xoshiro:
+        return std::unique_ptr<RandomGenerator> {new XoshiroRandomGenerator {seed}};
+    }
+    return nullptr;
+}
+
+// ----------------------------------------
+
+Xoshiro256::Xoshiro256(uint64_t seed)
+{
+    this->seed(seed);
+}
+
+void Xoshiro256::seed(uint64_t seed)
+{
+    for (auto &word : state) {
+        seed += UINT64_C(0x9e3779b97f4a7c15);
+        auto z = seed;
+        z = (z ^ (z >> 30)) * UINT64_C(0xbf58476d1ce4e5b9);
+        z = (z ^ (z >> 27)) * UINT64_C(0x94d049bb133111eb);
+        word = z ^ (z >> 31);
+    }
+}
@@ -0,0 +1,89 @@
+/* vim:ts=4:sw=4:et:sts=4:
+ *
+ * Copyright 2016 Thunder422.  All rights reserved.
+ * Distributed under GNU General Public License Version 3
+ * (See accompanying file LICENSE or <http://www.gnu.org/licenses/>)
+ */
+
+#ifndef IBC_RANDOMGENERATOR_H
+#define IBC_RANDOMGENERATOR_H
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+
+
+enum class RandomEngine {
+    Standard,       // std::default_random_engine
+    MersenneTwister,
+    Xoshiro
+};
+
+
+// the random numbers of an executer, the state is owned by the executer so that programs can
+// be run on multiple threads, and seeding makes the numbers of a run reproducible
+
+class RandomGenerator {
+public:
+    static constexpr uint64_t DefaultSeed = 1;
+
+    static std::unique_ptr<RandomGenerator> create(RandomEngine engine,
+        uint64_t seed = DefaultSeed);
+
+    virtual ~RandomGenerator() = default;
+    virtual void seed(uint64_t seed) = 0;
+    virtual double getNumber() = 0;                     // 0 <= number < 1
+    virtual int32_t getNumber(int32_t limit) = 0;       // 1 <= number <= limit
+};
+
+
+// xoshiro256++ by Blackman and Vigna, which is much faster than the standard engines,
+// seeded using splitmix64 as recommended by the authors
+
+class Xoshiro256 {
+public:
+    using result_type = uint64_t;
+
+    explicit Xoshiro256(uint64_t seed = RandomGenerator::DefaultSeed);
+    void seed(uint64_t seed);
+    result_type operator()();
+    static constexpr result_type min();
+    static constexpr result_type max();
+
+private:
+    static uint64_t rotateLeft(uint64_t value, int count);
+
+    uint64_t state[4];
+};
+
+
+inline Xoshiro256::result_type Xoshiro256::operator()()
+{
+    auto result = rotateLeft(state[0] + state[3], 23) + state[0];
+    auto t = state[1] << 17;
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+    state[2] ^= t;
+    state[3] = rotateLeft(state[3], 45);
+    return result;
+}
+
+inline constexpr Xoshiro256::result_type Xoshiro256::min()
+{
+    return 0;
+}
+
+inline constexpr Xoshiro256::result_type Xoshiro256::max()
+{
+    return std::numeric_limits<result_type>::max();
+}
+
+inline uint64_t Xoshiro256::rotateLeft(uint64_t value, int count)
+{
+    return (value << count) | (value >> (64 - count));
+}
+
+
+#endif  // IBC_RANDOMGENERATOR_H
@@ -6,8 +6,10 @@
  */
 
 #include <stack>
+#include <vector>
 
 #include "commandcode.h"
+#include "fusedcode.h"
 #include "programcode.h"
 #include "programerror.h"
 #include "programreader.h"
@@ -21,16 +23,22 @@ public:
     RecreatorImpl(const ProgramUnit &program, ProgramReader program_reader, unsigned error_offset);
 
     std::string &&recreate() override;
-    std::string getConstNumOperand() const override;
-    std::string getConstStrOperand() const override;
+    StringView getConstNumOperand() const override;
+    StringView getConstStrOperand() const override;
+    StringView getLongConstNumOperand() const override;
+    StringView getLongConstStrOperand() const override;
     void addCommandKeyword(CommandCode command_code) override;
     void push(const std::string &operand) override;
 
     void recreateUnaryOperator() override;
     void recreateBinaryOperator() override;
+    void recreateBinaryOperatorChain() override;
     void recreateFunctionWithNoArguments() override;
     void recreateFunctionWithOneArgument() override;
     void markOperandIfError() override;
+    void recreateFusedCode() override;
+    void recreateFoldedExpression() override;
+    void recreateLongFoldedExpression() override;
 
 private:
     struct StackItem {
@@ -44,6 +52,8 @@ private:
 
     void setAtErrorOffset();
     void recreateOneCode();
+    void recreateCode(const Code &code);
+    void recreateFoldedExpression(unsigned folded_expression);
     std::string &&moveTopString();
     void prependKeyword(CommandCode command_code);
     Precedence topPrecedence() const;
@@ -113,6 +123,9 @@ std::string &&RecreatorImpl::recreate()
         setAtErrorOffset();
         recreateOneCode();
     }
+    if (stack.empty()) {
+        stack.emplace("", Precedence::Operand);  // a blank line has no code
+    }
     return moveTopString();
 }
 
@@ -123,23 +136,39 @@ void RecreatorImpl::setAtErrorOffset()
 
 void RecreatorImpl::recreateOneCode()
 {
-    auto code = program_reader.getInstruction();
-    code_value = code->getValue();
-    code->recreate(*this);
+    recreateCode(*program_reader.getInstruction());
+}
+
+void RecreatorImpl::recreateCode(const Code &code)
+{
+    code_value = code.getValue();
+    code.recreate(*this);
 }
 
-std::string RecreatorImpl::getConstNumOperand() const
+StringView RecreatorImpl::getConstNumOperand() const
 {
     auto operand = program_reader.getOperand();
     return program.getConstantNumber(operand);
 }
 
-std::string RecreatorImpl::getConstStrOperand() const
+StringView RecreatorImpl::getConstStrOperand() const
 {
     auto operand = program_reader.getOperand();
     return program.getConstantString(operand);
 }
 
+StringView RecreatorImpl::getLongConstNumOperand() const
+{
+    auto operand = program_reader.getLongOperand();
+    return program.getConstantNumber(operand);
+}
+
+StringView RecreatorImpl::getLongConstStrOperand() const
+{
+    auto operand = program_reader.getLongOperand();
+    return program.getConstantString(operand);
+}
+
 void RecreatorImpl::addCommandKeyword(CommandCode command_code)
 {
     if (stack.empty()) {
@@ -283,6 +312,25 @@ void RecreatorImpl::recreateBinaryOperator()
     setTopUnaryOperatorPrecedence(rhs.unary_operator_precedence);
 }
 
+// a chain is recreated as the operator applied to each operand in turn (the codes the chain
+// replaced), the second operand of the code (the temporary operands) is not needed
+void RecreatorImpl::recreateBinaryOperatorChain()
+{
+    auto operand_count = program_reader.getOperand();
+    program_reader.getOperand();
+
+    std::vector<StackItem> rhs_operands;
+    for (unsigned count = 1; count < operand_count; ++count) {
+        rhs_operands.push_back(stack.top());
+        pop();
+    }
+    while (!rhs_operands.empty()) {
+        stack.push(rhs_operands.back());
+        rhs_operands.pop_back();
+        recreateBinaryOperator();
+    }
+}
+
 void RecreatorImpl::appendLeftOperand(Precedence operator_precedence)
 {
     auto lhs_precedence = topPrecedence();
@@ -352,6 +400,38 @@ void RecreatorImpl::markOperandIfError()
     markErrorEnd();
 }
 
+// both codes are at the error offset of the fused code, but only one can mark an error
+void RecreatorImpl::recreateFusedCode()
+{
+    auto &fused_code = FusedCode::get(code_value);
+    recreateCode(fused_code.getFirstCode());
+    recreateCode(fused_code.getSecondCode());
+}
+
+// a folded constant is recreated from the codes of the expression it was folded from,
+// which never contain the error offset since a folded expression cannot cause an error
+void RecreatorImpl::recreateFoldedExpression()
+{
+    program_reader.getOperand();
+    recreateFoldedExpression(program_reader.getOperand());
+}
+
+void RecreatorImpl::recreateLongFoldedExpression()
+{
+    program_reader.getLongOperand();
+    recreateFoldedExpression(program_reader.getLongOperand());
+}
+
+void RecreatorImpl::recreateFoldedExpression(unsigned folded_expression)
+{
+    auto line_reader = program_reader;
+    program_reader = program.createFoldedExpressionReader(folded_expression);
+    while (program_reader.hasMoreCode()) {
+        recreateOneCode();
+    }
+    program_reader = line_reader;
+}
+
 // ------------------------------------------------------------
 
 void recreateUnaryOperator(Recreator &recreator)
@@ -364,6 +444,11 @@ void recreateBinaryOperator(Recreator &recreator)
     recreator.recreateBinaryOperator();
 }
 
+void recreateBinaryOperatorChain(Recreator &recreator)
+{
+    recreator.recreateBinaryOperatorChain();
+}
+
 void recreateFunctionWithNoArguments(Recreator &recreator)
 {
     recreator.recreateFunctionWithNoArguments();
@@ -378,3 +463,18 @@ void recreateNothing(Recreator &recreator)
 {
     (void)recreator;
 }
+
+void recreateFusedCode(Recreator &recreator)
+{
+    recreator.recreateFusedCode();
+}
+
+void recreateFoldedExpression(Recreator &recreator)
+{
+    recreator.recreateFoldedExpression();
+}
+
+void recreateLongFoldedExpression(Recreator &recreator)
+{
+    recreator.recreateLongFoldedExpression();
+}
@@ -11,6 +11,8 @@
 #include <memory>
 #include <string>
 
+#include "stringview.h"
+
 
 class CommandCode;
 class ProgramReader;
@@ -24,24 +26,34 @@ public:
     virtual ~Recreator() = default;
 
     virtual std::string &&recreate() = 0;
-    virtual std::string getConstNumOperand() const = 0;
-    virtual std::string getConstStrOperand() const = 0;
+    virtual StringView getConstNumOperand() const = 0;
+    virtual StringView getConstStrOperand() const = 0;
+    virtual StringView getLongConstNumOperand() const = 0;
+    virtual StringView getLongConstStrOperand() const = 0;
     virtual void addCommandKeyword(CommandCode command_code) = 0;
     virtual void push(const std::string &operand) = 0;
 
     virtual void recreateUnaryOperator() = 0;
     virtual void recreateBinaryOperator() = 0;
+    virtual void recreateBinaryOperatorChain() = 0;
     virtual void recreateFunctionWithNoArguments() = 0;
     virtual void recreateFunctionWithOneArgument() = 0;
     virtual void markOperandIfError() = 0;
+    virtual void recreateFusedCode() = 0;
+    virtual void recreateFoldedExpression() = 0;
+    virtual void recreateLongFoldedExpression() = 0;
 };
 
 
 void recreateUnaryOperator(Recreator &recreator);
 void recreateBinaryOperator(Recreator &recreator);
+void recreateBinaryOperatorChain(Recreator &recreator);
 void recreateFunctionWithNoArguments(Recreator &recreator);
 void recreateFunctionWithOneArgument(Recreator &recreator);
 void recreateNothing(Recreator &recreator);
+void recreateFusedCode(Recreator &recreator);
+void recreateFoldedExpression(Recreator &recreator);
+void recreateLongFoldedExpression(Recreator &recreator);
 
 
 #endif  // IBC_RECREATOR_H
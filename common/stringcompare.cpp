@@ -0,0 +1,181 @@
+/* vim:ts=4:sw=4:et:sts=4:
+ *
+ * Copyright 2016 Thunder422.  All rights reserved.
+ * Distributed under GNU General Public License Version 3
+ * (See accompanying file LICENSE or <http://www.gnu.org/licenses/>)
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+#include "stringcompare.h"
+
+
+using MismatchFunction = std::size_t (*)(const char *, const char *, std::size_t);
+
+// eight characters are compared at a time, the lowest set bit of the difference of the words of
+// little endian processors is in the first character that is not equal
+
+std::size_t scalarMismatchOffset(const char *lhs, const char *rhs, std::size_t length)
+{
+    std::size_t offset = 0;
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    for (; offset + sizeof(uint64_t) <= length; offset += sizeof(uint64_t)) {
+        uint64_t lhs_word;
+        uint64_t rhs_word;
+        std::memcpy(&lhs_word, lhs + offset, sizeof(uint64_t));
+        std::memcpy(&rhs_word, rhs + offset, sizeof(uint64_t));
+        if (auto difference = lhs_word ^ rhs_word) {
+            return offset + __builtin_ctzll(difference) / 8;
+        }
+    }
+#endif
+    while (offset < length && lhs[offset] == rhs[offset]) {
+        ++offset;
+    }
+    return offset;
+}
+
+#if defined(__x86_64__)
+
+// SSE2 is part of every x86-64 processor; four blocks are compared for each test of the masks
+// (the bits of a mask are set for the characters that are equal), only the blocks of a
+// mismatch are searched for its first character
+
+std::size_t sse2BlockMismatchOffset(const char *lhs, const char *rhs)
+{
+    auto lhs_block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(lhs));
+    auto rhs_block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(rhs));
+    auto mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(lhs_block, rhs_block)));
+    return __builtin_ctz(~mask);
+}
+
+std::size_t sse2MismatchOffset(const char *lhs, const char *rhs, std::size_t length)
+{
+    constexpr std::size_t BlockSize = sizeof(__m128i);
+
+    auto equalBlock = [lhs, rhs](std::size_t offset) {
+        auto lhs_block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(lhs + offset));
+        auto rhs_block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(rhs + offset));
+        return _mm_cmpeq_epi8(lhs_block, rhs_block);
+    };
+    std::size_t offset = 0;
+    for (; offset + 4 * BlockSize <= length; offset += 4 * BlockSize) {
+        auto equal = _mm_and_si128(
+            _mm_and_si128(equalBlock(offset), equalBlock(offset + BlockSize)),
+            _mm_and_si128(equalBlock(offset + 2 * BlockSize), equalBlock(offset + 3 * BlockSize)));
+        if (_mm_movemask_epi8(equal) != 0xffff) {
+            break;
+        }
+    }
+    for (; offset + BlockSize <= length; offset += BlockSize) {
+        auto block_offset = sse2BlockMismatchOffset(lhs + offset, rhs + offset);
+        if (block_offset < BlockSize) {
+            return offset + block_offset;
+        }
+    }
+    return offset + scalarMismatchOffset(lhs + offset, rhs + offset, length - offset);
+}
+
+__attribute__((target("avx2")))
+std::size_t avx2MismatchOffset(const char *lhs, const char *rhs, std::size_t length)
+{
+    constexpr std::size_t BlockSize = sizeof(__m256i);
+
+    auto equalBlock = [lhs, rhs](std::size_t offset) __attribute__((target("avx2"))) {
+        auto lhs_block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(lhs + offset));
+        auto rhs_block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(rhs + offset));
+        return _mm256_cmpeq_epi8(lhs_block, rhs_block);
+    };
+    std::size_t offset = 0;
+    for (; offset + 4 * BlockSize <= length; offset += 4 * BlockSize) {
+        auto equal = _mm256_and_si256(
+            _mm256_and_si256(equalBlock(offset), equalBlock(offset + BlockSize)),
+            _mm256_and_si256(equalBlock(offset + 2 * BlockSize),
+                equalBlock(offset + 3 * BlockSize)));
+        if (_mm256_movemask_epi8(equal) != -1) {
+            break;
+        }
+    }
+    for (; offset + BlockSize <= length; offset += BlockSize) {
+        auto mask = static_cast<unsigned>(_mm256_movemask_epi8(equalBlock(offset)));
+        if (mask != ~0u) {
+            return offset + __builtin_ctz(~mask);
+        }
+    }
+    return offset + sse2MismatchOffset(lhs + offset, rhs + offset, length - offset);
+}
+
+#endif
+
+// ----------------------------------------
+
+MismatchFunction getMismatchFunction(StringCompareKernel kernel)
+{
+    switch (kernel) {
+#if defined(__x86_64__)
+    case StringCompareKernel::Sse2:
+        return sse2MismatchOffset;
+    case StringCompareKernel::Avx2:
+        return avx2MismatchOffset;
+#endif
+    default:
+        return scalarMismatchOffset;
+    }
+}
+
+// the static initialization of the library may run before the processor features are detected
+StringCompareKernel getBestKernel()
+{
+#if defined(__x86_64__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return StringCompareKernel::Avx2;
+    }
+    return StringCompareKernel::Sse2;
+#else
+    return StringCompareKernel::Scalar;
+#endif
+}
+
+StringCompareKernel string_compare_kernel {getBestKernel()};
+MismatchFunction mismatch_function {getMismatchFunction(string_compare_kernel)};
+
+// ----------------------------------------
+
+std::size_t mismatchOffset(const char *lhs, const char *rhs, std::size_t length)
+{
+    return mismatch_function(lhs, rhs, length);
+}
+
+int compareStrings(StringView lhs, StringView rhs)
+{
+    auto length = std::min(lhs.length(), rhs.length());
+    auto offset = mismatch_function(lhs.data(), rhs.data(), length);
+    if (offset < length) {
+        return static_cast<unsigned char>(lhs.data()[offset])
+            - static_cast<unsigned char>(rhs.data()[offset]);
+    }
+    return lhs.length() < rhs.length() ? -1 : lhs.length() > rhs.length();
+}
+
+bool isStringCompareKernelSupported(StringCompareKernel kernel)
+{
+    return kernel <= getBestKernel();
+}
+
+StringCompareKernel getStringCompareKernel()
+{
+    return string_compare_kernel;
+}
+
+void setStringCompareKernel(StringCompareKernel kernel)
+{
+    string_compare_kernel = kernel;
+    mismatch_function = getMismatchFunction(kernel);
+}
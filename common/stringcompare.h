@@ -0,0 +1,44 @@
+/* vim:ts=4:sw=4:et:sts=4:
+ *
+ * Copyright 2016 Thunder422.  All rights reserved.
+ * Distributed under GNU General Public License Version 3
+ * (See accompanying file LICENSE or <http://www.gnu.org/licenses/>)
+ */
+
+#ifndef IBC_STRINGCOMPARE_H
+#define IBC_STRINGCOMPARE_H
+
+#include <cstddef>
+
+#include "stringview.h"
+
+
+enum class StringCompareKernel {
+    Scalar,
+    Sse2,
+    Avx2
+};
+
+
+// compares the characters of strings with the widest vector instructions the processor supports
+// (selected when the library is loaded), the characters compare as unsigned like std::string;
+// strings of different lengths are never equal so their characters are not compared
+
+bool equalStrings(StringView lhs, StringView rhs);
+int compareStrings(StringView lhs, StringView rhs);  // < 0, 0 or > 0
+
+std::size_t mismatchOffset(const char *lhs, const char *rhs, std::size_t length);
+
+bool isStringCompareKernelSupported(StringCompareKernel kernel);
+StringCompareKernel getStringCompareKernel();
+void setStringCompareKernel(StringCompareKernel kernel);  // must be supported
+
+
+inline bool equalStrings(StringView lhs, StringView rhs)
+{
+    return lhs.length() == rhs.length()
+        && mismatchOffset(lhs.data(), rhs.data(), lhs.length()) == lhs.length();
+}
+
+
+#endif  // IBC_STRINGCOMPARE_H
@@ -0,0 +1,115 @@
+/* vim:ts=4:sw=4:et:sts=4:
+ *
+ * Copyright 2016 Thunder422.  All rights reserved.
+ * Distributed under GNU General Public License Version 3
+ * (See accompanying file LICENSE or <http://www.gnu.org/licenses/>)
+ */
+
+#ifndef IBC_STRINGPOOL_H
+#define IBC_STRINGPOOL_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+
+// owns the temporary strings of an executer, released strings are cleared but keep their
+// buffers so that acquiring a string again does not need to allocate memory; the strings are
+// allocated together in a slab with one string for each item of the stack (each temporary string
+// is on the stack), so short strings (stored within the string) never allocate memory, a string
+// is only allocated separately if the slab runs out
+
+class StringPool {
+public:
+    struct Statistics {
+        unsigned long hits;
+        unsigned long misses;
+    };
+
+    explicit StringPool(unsigned slab_size);
+
+    std::string *acquire();
+    void release(std::string *string);
+    void releaseAll();
+    Statistics getStatistics() const;
+
+private:
+    unsigned slab_size;
+    std::unique_ptr<std::string[]> slab;
+    std::vector<std::unique_ptr<std::string>> strings;
+    std::vector<std::string *> free_strings;
+    Statistics statistics {0, 0};
+};
+
+
+class TmpStringReleaser {
+public:
+    TmpStringReleaser(StringPool *string_pool);
+    void operator()(std::string *string) const;
+
+private:
+    StringPool *string_pool;
+};
+
+
+inline StringPool::StringPool(unsigned slab_size) :
+    slab_size {slab_size},
+    slab {new std::string[slab_size]}
+{
+    free_strings.reserve(slab_size);
+    for (unsigned index = slab_size; index > 0; --index) {
+        free_strings.push_back(&slab[index - 1]);
+    }
+}
+
+inline std::string *StringPool::acquire()
+{
+    if (free_strings.empty()) {
+        ++statistics.misses;
+        strings.emplace_back(new std::string);
+        return strings.back().get();
+    }
+    ++statistics.hits;
+    auto string = free_strings.back();
+    free_strings.pop_back();
+    return string;
+}
+
+inline void StringPool::release(std::string *string)
+{
+    string->clear();
+    free_strings.push_back(string);
+}
+
+// temporary strings left on the stack by a run error are only recovered by releasing them all
+inline void StringPool::releaseAll()
+{
+    if (free_strings.size() != slab_size + strings.size()) {
+        free_strings.clear();
+        for (auto index = slab_size; index > 0; --index) {
+            release(&slab[index - 1]);
+        }
+        for (auto &string : strings) {
+            release(string.get());
+        }
+    }
+}
+
+inline StringPool::Statistics StringPool::getStatistics() const
+{
+    return statistics;
+}
+
+
+inline TmpStringReleaser::TmpStringReleaser(StringPool *string_pool) :
+    string_pool {string_pool}
+{
+}
+
+inline void TmpStringReleaser::operator()(std::string *string) const
+{
+    string_pool->release(string);
+}
+
+
+#endif  // IBC_STRINGPOOL_H
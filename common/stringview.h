@@ -0,0 +1,130 @@
+/* vim:ts=4:sw=4:et:sts=4:
+ *
+ * Copyright 2016 Thunder422.  All rights reserved.
+ * Distributed under GNU General Public License Version 3
+ * (See accompanying file LICENSE or <http://www.gnu.org/licenses/>)
+ */
+
+#ifndef IBC_STRINGVIEW_H
+#define IBC_STRINGVIEW_H
+
+#include <ostream>
+#include <string>
+
+
+// a view of characters that are not owned (like the characters of a dictionary entry or a word
+// of a source line), so that the characters can be used without copying them into a string;
+// the characters are compared by the character traits (see ci_string_view in cistring.h)
+
+template <typename Traits>
+class BasicStringView {
+public:
+    BasicStringView() { }
+    BasicStringView(const char *data, std::size_t length);
+    BasicStringView(const std::basic_string<char, Traits> &string);
+
+    const char *data() const;
+    std::size_t length() const;
+    bool empty() const;
+    char front() const;
+    const char *begin() const;
+    const char *end() const;
+    std::basic_string<char, Traits> str() const;
+
+private:
+    const char *characters {nullptr};
+    std::size_t size {0};
+};
+
+using StringView = BasicStringView<std::char_traits<char>>;
+
+
+template <typename Traits>
+inline BasicStringView<Traits>::BasicStringView(const char *data, std::size_t length) :
+    characters {data},
+    size {length}
+{
+}
+
+template <typename Traits>
+inline BasicStringView<Traits>::BasicStringView(const std::basic_string<char, Traits> &string) :
+    characters {string.data()},
+    size {string.length()}
+{
+}
+
+template <typename Traits>
+inline const char *BasicStringView<Traits>::data() const
+{
+    return characters;
+}
+
+template <typename Traits>
+inline std::size_t BasicStringView<Traits>::length() const
+{
+    return size;
+}
+
+template <typename Traits>
+inline bool BasicStringView<Traits>::empty() const
+{
+    return size == 0;
+}
+
+template <typename Traits>
+inline char BasicStringView<Traits>::front() const
+{
+    return characters[0];
+}
+
+template <typename Traits>
+inline const char *BasicStringView<Traits>::begin() const
+{
+    return characters;
+}
+
+template <typename Traits>
+inline const char *BasicStringView<Traits>::end() const
+{
+    return characters + size;
+}
+
+template <typename Traits>
+inline std::basic_string<char, Traits> BasicStringView<Traits>::str() const
+{
+    return std::basic_string<char, Traits>(characters, size);
+}
+
+template <typename Traits>
+inline bool operator==(const BasicStringView<Traits> &lhs, const BasicStringView<Traits> &rhs)
+{
+    return lhs.length() == rhs.length()
+        && Traits::compare(lhs.data(), rhs.data(), lhs.length()) == 0;
+}
+
+template <typename Traits>
+inline bool operator!=(const BasicStringView<Traits> &lhs, const BasicStringView<Traits> &rhs)
+{
+    return !(lhs == rhs);
+}
+
+template <typename Traits>
+inline bool operator==(const BasicStringView<Traits> &lhs, const char *rhs)
+{
+    return lhs == BasicStringView<Traits> {rhs, Traits::length(rhs)};
+}
+
+template <typename Traits>
+inline bool operator!=(const BasicStringView<Traits> &lhs, const char *rhs)
+{
+    return !(lhs == rhs);
+}
+
+template <typename Traits>
+inline std::ostream &operator<<(std::ostream &os, const BasicStringView<Traits> &view)
+{
+    return os.write(view.data(), view.length());
+}
+
+
+#endif  // IBC_STRINGVIEW_H
@@ -9,9 +9,36 @@
 #define IBC_WORDTYPE_H
 
 #include <cstdint>
+#include <limits>
 
 
 using WordType = uint16_t;
 
+// an index operand too large for one word (large programs have more constants than fit) is
+// two words with the low word first, only the long form of the constant codes have these
+
+constexpr unsigned LongOperandWords = 2;
+constexpr unsigned MaximumLongOperand = std::numeric_limits<uint32_t>::max();
+
+inline bool isLongOperand(unsigned operand)
+{
+    return operand > std::numeric_limits<WordType>::max();
+}
+
+inline unsigned longOperand(WordType low_word, WordType high_word)
+{
+    return low_word | unsigned {high_word} << std::numeric_limits<WordType>::digits;
+}
+
+inline WordType lowWord(unsigned operand)
+{
+    return static_cast<WordType>(operand);
+}
+
+inline WordType highWord(unsigned operand)
+{
+    return static_cast<WordType>(operand >> std::numeric_limits<WordType>::digits);
+}
+
 
 #endif  // IBC_WORDTYPE_H
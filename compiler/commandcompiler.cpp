@@ -11,35 +11,9 @@
 #include "commandcompiler.h"
 #include "compiler.h"
 #include "compileerror.h"
-#include "programcode.h"
 
 
-class CommandCompilerImpl : public CommandCompiler {
-public:
-    CommandCompilerImpl(const std::string &source_line, ProgramUnit &program);
-
-    ProgramCode &&compile() override;
-
-private:
-    Compiler compiler;
-};
-
-// ----------------------------------------
-
-std::unique_ptr<CommandCompiler> CommandCompiler::create(const std::string &source_line,
-    ProgramUnit &program)
-{
-    return std::unique_ptr<CommandCompiler> {new CommandCompilerImpl {source_line, program}};
-}
-
-// ----------------------------------------
-
-CommandCompilerImpl::CommandCompilerImpl(const std::string &source_line, ProgramUnit &program) :
-    compiler {source_line, program}
-{
-}
-
-ProgramCode &&CommandCompilerImpl::compile()
+void CommandCompiler::compile(Compiler &compiler)
 {
     if (compiler.peekNextChar() != EOF) {
         auto keyword = compiler.getKeyword();
@@ -50,5 +24,4 @@ ProgramCode &&CommandCompilerImpl::compile()
         compiler.clearWord();
         code->compile(compiler);
     }
-    return compiler.getCodeLine();
 }
@@ -8,20 +8,12 @@
 #ifndef IBC_COMMANDPARSER_H
 #define IBC_COMMANDPARSER_H
 
-#include <iosfwd>
-#include <memory>
-
-
-class ProgramCode;
-class ProgramUnit;
+class Compiler;
 
 class CommandCompiler {
 public:
-    static std::unique_ptr<CommandCompiler> create(const std::string &source_line,
-        ProgramUnit &program);
-
-    virtual ProgramCode &&compile() = 0;
-    virtual ~CommandCompiler() = default;
+    // compiles the command of the line of a compiler (not allocated for each line)
+    static void compile(Compiler &compiler);
 };
 
 
@@ -15,36 +15,66 @@
 #include "programunit.h"
 
 
+// the line is copied so that the compiler does not depend on the life of the string
 Compiler::Compiler(const std::string &line, ProgramUnit &program) :
-    iss {line},
-    program {program}
+    line_copy {line},
+    line {line_copy.data()},
+    line_length {line_copy.length()},
+    program {program},
+    buffers {program.compiler_buffers},
+    code_line {buffers.code_line},
+    instruction_offsets {buffers.instruction_offsets}
 {
+    code_line.clear();
+    instruction_offsets.clear();
+}
+
+// the characters of the line are lexed where they are (they are not copied), so the line
+// must not change while it is being compiled; every line is compiled into the buffers of the
+// program unit, so only one line of a program unit can be compiled at a time
+Compiler::Compiler(const char *line, std::size_t length, ProgramUnit &program) :
+    line {line},
+    line_length {length},
+    program {program},
+    buffers {program.compiler_buffers},
+    code_line {buffers.code_line},
+    instruction_offsets {buffers.instruction_offsets}
+{
+    code_line.clear();
+    instruction_offsets.clear();
 }
 
 void Compiler::compileExpression(DataType expected_data_type)
 {
-    ExpressionCompiler::create(*this)->compileExpression(expected_data_type);
+    ExpressionCompiler::compileExpression(*this, expected_data_type);
 }
 
 DataType Compiler::compileExpression()
 {
-    return ExpressionCompiler::create(*this)->compileExpression();
+    return ExpressionCompiler::compileExpression(*this);
 }
 
 DataType Compiler::compileStringConstant()
 {
     if (peekNextChar() == '"') {
+        auto string_column = column;
         getNextChar();
-        std::string string = parseStringConstant();
-        addStrConstInstruction(string);
+        auto &string = parseStringConstant();
+        try {
+            addStrConstInstruction(string);
+        }
+        catch (const Dictionary::FullError &) {
+            throw CompileError {"too many constants", string_column};
+        }
         return DataType::String();
     }
     return {};
 }
 
-std::string Compiler::parseStringConstant()
+const std::string &Compiler::parseStringConstant()
 {
-    std::string string;
+    auto &string = buffers.string_constant;
+    string.clear();
     while (auto c = getStringConstantChar()) {
         string.push_back(c);
     }
@@ -71,10 +101,32 @@ char Compiler::identifyEmbeddedQuote()
 void Compiler::addStrConstInstruction(const std::string &string)
 {
     extern Code const_str_code;
-    code_line.emplace_back(const_str_code.getValue());
+    extern Code const_str_long_code;
 
     auto operand = program.addConstantString(string);
-    code_line.emplace_back(operand);
+    appendConstantInstruction(const_str_code, const_str_long_code, operand);
+}
+
+// constants with an index too large for one word use the long form of the constant code,
+// so that the common case has one word per operand
+void Compiler::appendConstantInstruction(Code &code, Code &long_code, unsigned operand)
+{
+    appendInstructionOffset();
+    if (isLongOperand(operand)) {
+        code_line.emplace_back(long_code);
+        appendLongOperand(operand);
+        adjustStackDepth(long_code);
+    } else {
+        code_line.emplace_back(code);
+        code_line.emplace_back(lowWord(operand));
+        adjustStackDepth(code);
+    }
+}
+
+void Compiler::appendLongOperand(unsigned operand)
+{
+    code_line.emplace_back(lowWord(operand));
+    code_line.emplace_back(highWord(operand));
 }
 
 OperatorCodes *Compiler::getSymbolOperatorCodes(Precedence precedence)
@@ -176,7 +228,7 @@ FunctionCodes *Compiler::getNumFunctionCodes()
     return codes;
 }
 
-ci_string Compiler::getKeyword()
+ci_string_view Compiler::getKeyword()
 {
     if (word.empty()) {
         skipWhiteSpace();
@@ -186,52 +238,50 @@ ci_string Compiler::getKeyword()
     return word;
 }
 
-void Compiler::parseKeyword(char first_char)
+// the word starts with the character before the current column (which was taken as the
+// exponent of a number that turned out to be the start of a word)
+void Compiler::parseKeyword()
 {
     word_column = column - 1;
     auto remaining_word = getAlphaOnlyWord();
-    word += first_char;
-    word += remaining_word;
+    word = ci_string_view {line + word_column, 1 + remaining_word.length()};
 }
 
-ci_string Compiler::getAlphaOnlyWord()
+// a word is the span of the line containing the word
+ci_string_view Compiler::getAlphaOnlyWord()
 {
-    ci_string keyword;
+    auto begin = position;
     while (isalpha(peekNextChar())) {
-        keyword += getNextChar();
+        getNextChar();
     }
+    ci_string_view keyword {line + begin, position - begin};
     skipWhiteSpace();
     return keyword;
 }
 
 void Compiler::clearWord()
 {
-    word.clear();
+    word = ci_string_view {};
 }
 
 char Compiler::peekNextChar()
 {
     if (!word.empty()) {
         return word.front();
-    } else if (!peek_char) {
-        column = iss.tellg();
-        peek_char = iss.peek();
     }
-    return peek_char;
+    column = position;
+    return position < line_length ? line[position] : EOF;
 }
 
 char Compiler::getNextChar()
 {
-    peek_char = 0;
-    return iss.get();
+    return position < line_length ? line[position++] : EOF;
 }
 
 void Compiler::skipWhiteSpace()
 {
-    if (peek_char != EOF) {
-        while (isspace(peekNextChar())) {
-            getNextChar();
-        }
+    while (isspace(peekNextChar())) {
+        getNextChar();
     }
 }
 
@@ -243,18 +293,174 @@ unsigned Compiler::getColumn() noexcept
 void Compiler::addInstruction(Code &code)
 {
     last_operand_was_constant = false;
+    appendInstructionOffset();
     code_line.emplace_back(code);
+    adjustStackDepth(code);
+}
+
+// adds the code of an operation that has a single result, when constant folding is enabled
+// and all of its operands are constants, the operation is evaluated and replaced with the result
+DataType Compiler::addFoldableInstruction(Code &code, DataType data_type)
+{
+    addInstruction(code);
+    return foldOperands(code, data_type);
+}
+
+DataType Compiler::addChainInstruction(Code &code, unsigned operand_count, WordType temporaries,
+    DataType data_type)
+{
+    last_operand_was_constant = false;
+    appendInstructionOffset();
+    code_line.emplace_back(code);
+    code_line.emplace_back(static_cast<WordType>(operand_count));
+    code_line.emplace_back(temporaries);
+    adjustStackDepth(code);
+    return foldOperands(code, data_type);
+}
+
+void Compiler::appendInstructionOffset()
+{
+    instruction_offsets.push_back(code_line.size());
+}
+
+// the code is the last instruction added, its operands (which of a chain code give its stack
+// effect) must have been added
+int Compiler::lastInstructionStackEffect(const Code &code) const
+{
+    auto operands = code_line.getBeginning() + instruction_offsets.back() + 1;
+    return code.getStackEffect(operands);
+}
+
+void Compiler::adjustStackDepth(const Code &code)
+{
+    code_line.adjustStackDepth(lastInstructionStackEffect(code));
+}
+
+// the operands of the code with a single result are the items it pops
+DataType Compiler::foldOperands(const Code &code, DataType data_type)
+{
+    if (program.constantFolding()) {
+        return foldConstantOperands(1 - lastInstructionStackEffect(code), data_type);
+    }
+    return data_type;
+}
+
+DataType Compiler::foldConstantOperands(unsigned operand_count, DataType data_type)
+{
+    if (instruction_offsets.size() <= operand_count) {
+        return data_type;
+    }
+    auto first_operand = instruction_offsets.end() - 1 - operand_count;
+    for (auto operand = first_operand; operand != instruction_offsets.end() - 1; ++operand) {
+        if (!isConstantInstruction(*operand)) {
+            return data_type;
+        }
+    }
+
+    auto offset = *first_operand;
+    auto result = program.evaluateConstantExpression(code_line, offset, operand_count + 1,
+        data_type);
+    if (!result.valid) {
+        return data_type;
+    }
+    auto folded_expression = program.addFoldedExpression(code_line.begin() + offset,
+        code_line.end());
+
+    if (data_type.isTmpStr()) {
+        data_type = DataType::String();
+    }
+    code_line.resize(offset);
+    instruction_offsets.erase(first_operand, instruction_offsets.end());
+    appendInstructionOffset();
+    if (isLongOperand(result.operand) || isLongOperand(folded_expression)) {
+        code_line.emplace_back(longFoldedConstantCode(data_type));
+        appendLongOperand(result.operand);
+        appendLongOperand(folded_expression);
+    } else {
+        code_line.emplace_back(foldedConstantCode(data_type));
+        code_line.emplace_back(lowWord(result.operand));
+        code_line.emplace_back(lowWord(folded_expression));
+    }
+    return data_type;
+}
+
+bool Compiler::isConstantInstruction(unsigned offset)
+{
+    extern Code const_dbl_code;
+    extern Code const_int_code;
+    extern Code const_str_code;
+    extern Code folded_dbl_code;
+    extern Code folded_int_code;
+    extern Code folded_str_code;
+    extern Code const_dbl_long_code;
+    extern Code const_int_long_code;
+    extern Code const_str_long_code;
+    extern Code folded_dbl_long_code;
+    extern Code folded_int_long_code;
+    extern Code folded_str_long_code;
+
+    auto code_value = code_line[offset].operand();
+    return code_value == const_dbl_code.getValue() || code_value == const_int_code.getValue()
+        || code_value == const_str_code.getValue() || code_value == folded_dbl_code.getValue()
+        || code_value == folded_int_code.getValue() || code_value == folded_str_code.getValue()
+        || code_value == const_dbl_long_code.getValue()
+        || code_value == const_int_long_code.getValue()
+        || code_value == const_str_long_code.getValue()
+        || code_value == folded_dbl_long_code.getValue()
+        || code_value == folded_int_long_code.getValue()
+        || code_value == folded_str_long_code.getValue();
+}
+
+Code &Compiler::foldedConstantCode(DataType data_type)
+{
+    extern Code folded_dbl_code;
+    extern Code folded_int_code;
+    extern Code folded_str_code;
+
+    if (data_type.isDouble()) {
+        return folded_dbl_code;
+    } else if (data_type.isInteger()) {
+        return folded_int_code;
+    } else {
+        return folded_str_code;
+    }
+}
+
+Code &Compiler::longFoldedConstantCode(DataType data_type)
+{
+    extern Code folded_dbl_long_code;
+    extern Code folded_int_long_code;
+    extern Code folded_str_long_code;
+
+    if (data_type.isDouble()) {
+        return folded_dbl_long_code;
+    } else if (data_type.isInteger()) {
+        return folded_int_long_code;
+    } else {
+        return folded_str_long_code;
+    }
 }
 
 DataType Compiler::addNumConstInstruction(bool floating_point, const std::string &number,
     unsigned column)
 {
-    auto const_num_info = program.addConstantNumber(floating_point, number);
+    extern Code const_dbl_long_code;
+    extern Code const_int_long_code;
+
     last_operand_was_constant = true;
     last_constant_column = column;
     last_constant_length = number.length();
-    code_line.emplace_back(const_num_info.code_value);
-    code_line.emplace_back(const_num_info.operand);
+    ConstNumCodeInfo const_num_info;
+    try {
+        const_num_info = program.addConstantNumber(floating_point, number);
+    }
+    catch (const Dictionary::FullError &) {
+        throw CompileError {"too many constants", last_constant_column, last_constant_length};
+    }
+    auto &code = *Code::getCode(const_num_info.code_value);
+    auto &long_code = const_num_info.data_type.isDouble() ? const_dbl_long_code
+        : const_int_long_code;
+    appendConstantInstruction(code, long_code, const_num_info.operand);
     return const_num_info.data_type;
 }
 
@@ -265,7 +471,7 @@ void Compiler::convertToDouble(DataType operand_data_type)
             changeConstantToDouble();
         } else {
             extern Code cvtdbl_code;
-            addInstruction(cvtdbl_code);
+            addFoldableInstruction(cvtdbl_code, DataType::Double());
         }
     }
 }
@@ -273,9 +479,11 @@ void Compiler::convertToDouble(DataType operand_data_type)
 void Compiler::changeConstantToDouble()
 {
     extern Code const_dbl_code;
+    extern Code const_dbl_long_code;
 
-    auto last_constant_offset = code_line.size() - 2;
-    code_line[last_constant_offset] = ProgramWord {const_dbl_code};
+    auto last_constant_offset = instruction_offsets.back();
+    auto &code = isLongConstant(last_constant_offset) ? const_dbl_long_code : const_dbl_code;
+    code_line[last_constant_offset] = ProgramWord {code};
 }
 
 void Compiler::convertToInteger(DataType operand_data_type)
@@ -285,7 +493,7 @@ void Compiler::convertToInteger(DataType operand_data_type)
             changeConstantToInteger();
         } else {
             extern Code cvtint_code;
-            addInstruction(cvtint_code);
+            addFoldableInstruction(cvtint_code, DataType::Integer());
         }
     }
 }
@@ -293,22 +501,33 @@ void Compiler::convertToInteger(DataType operand_data_type)
 void Compiler::changeConstantToInteger()
 {
     extern Code const_int_code;
+    extern Code const_int_long_code;
 
-    auto last_constant_offset = code_line.size() - 2;
+    auto last_constant_offset = instruction_offsets.back();
     validateConstantConvertibleToInteger(last_constant_offset);
-    code_line[last_constant_offset] = ProgramWord {const_int_code};
+    auto &code = isLongConstant(last_constant_offset) ? const_int_long_code : const_int_code;
+    code_line[last_constant_offset] = ProgramWord {code};
 }
 
-void Compiler::validateConstantConvertibleToInteger(size_t last_constant_offset)
+bool Compiler::isLongConstant(unsigned offset)
 {
-    auto constant_operand = code_line[last_constant_offset + 1].operand();
+    return code_line[offset].instructionCode()->getOperandCount() == LongOperandWords;
+}
+
+void Compiler::validateConstantConvertibleToInteger(unsigned last_constant_offset)
+{
+    unsigned constant_operand = code_line[last_constant_offset + 1].operand();
+    if (isLongConstant(last_constant_offset)) {
+        constant_operand = longOperand(constant_operand,
+            code_line[last_constant_offset + 2].operand());
+    }
     if (!program.isConstantNumberConvertibleToInteger(constant_operand)) {
         throw CompileError {"floating point constant is out of range", last_constant_column,
             last_constant_length};
     }
 }
 
-ProgramCode &&Compiler::getCodeLine()
+const ProgramCode &Compiler::getCodeLine() const
 {
-    return std::move(code_line);
+    return code_line;
 }
@@ -10,21 +10,22 @@
 
 #include <iosfwd>
 #include <string>
-#include <sstream>
+#include <vector>
 
 #include "cistring.h"
+#include "compilerbuffers.h"
 #include "datatype.h"
 #include "programcode.h"
 #include "table.h"
 
 
 class Code;
-class ProgramCode;
 class ProgramUnit;
 
 class Compiler {
 public:
     Compiler(const std::string &line, ProgramUnit &program);
+    Compiler(const char *line, std::size_t length, ProgramUnit &program);
     void compileExpression(DataType expected_data_type);
     DataType compileExpression();
     DataType compileStringConstant();
@@ -34,8 +35,8 @@ public:
     OperatorCodes *getComparisonOperatorCodes(Precedence precedence);
     FunctionCodes *getNumFunctionCodes();
 
-    ci_string getKeyword();
-    void parseKeyword(char first_char);
+    ci_string_view getKeyword();
+    void parseKeyword();
     void clearWord();
     char peekNextChar();
     char getNextChar();
@@ -43,37 +44,55 @@ public:
     unsigned getColumn() noexcept;
 
     void addInstruction(Code &code);
+    DataType addFoldableInstruction(Code &code, DataType data_type);
+    DataType addChainInstruction(Code &code, unsigned operand_count, WordType temporaries,
+        DataType data_type);
     DataType addNumConstInstruction(bool floating_point, const std::string &number,
         unsigned column);
     void convertToDouble(DataType operand_data_type);
     void convertToInteger(DataType operand_data_type);
     void addStrConstInstruction(const std::string &string);
-    ProgramCode &&getCodeLine();
+    const ProgramCode &getCodeLine() const;
 
 private:
     friend class ComparisonOperatorCodes;
 
-    std::string parseStringConstant();
+    const std::string &parseStringConstant();
     char getStringConstantChar();
     char parseStringConstantChar();
     char identifyEmbeddedQuote();
 
     OperatorCodes *savedEqualityOperatorCodes();
     void setEqualityCodes(OperatorCodes *codes);
-    ci_string getAlphaOnlyWord();
+    ci_string_view getAlphaOnlyWord();
     void changeConstantToDouble();
     void changeConstantToInteger();
-    void validateConstantConvertibleToInteger(size_t last_constant_offset);
+    bool isLongConstant(unsigned offset);
+    void validateConstantConvertibleToInteger(unsigned last_constant_offset);
+    void appendInstructionOffset();
+    int lastInstructionStackEffect(const Code &code) const;
+    void adjustStackDepth(const Code &code);
+    DataType foldOperands(const Code &code, DataType data_type);
+    void appendConstantInstruction(Code &code, Code &long_code, unsigned operand);
+    void appendLongOperand(unsigned operand);
+    DataType foldConstantOperands(unsigned operand_count, DataType data_type);
+    bool isConstantInstruction(unsigned offset);
+    Code &foldedConstantCode(DataType data_type);
+    Code &longFoldedConstantCode(DataType data_type);
 
-    std::istringstream iss;
+    std::string line_copy;
+    const char *line;
+    std::size_t line_length;
+    std::size_t position {0};
     ProgramUnit &program;
-    ProgramCode code_line;
-    char peek_char {0};
+    CompilerBuffers &buffers;
+    ProgramCode &code_line;
+    std::vector<unsigned> &instruction_offsets;
     unsigned column {0};
     bool last_operand_was_constant;
     unsigned last_constant_column;
     unsigned last_constant_length;
-    ci_string word;
+    ci_string_view word;
     OperatorCodes *equality_codes {};
     unsigned word_column {0};
 };
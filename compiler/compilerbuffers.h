@@ -0,0 +1,49 @@
+/* vim:ts=4:sw=4:et:sts=4:
+ *
+ * Copyright 2016 Thunder422.  All rights reserved.
+ * Distributed under GNU General Public License Version 3
+ * (See accompanying file LICENSE or <http://www.gnu.org/licenses/>)
+ */
+
+#ifndef IBC_COMPILERBUFFERS_H
+#define IBC_COMPILERBUFFERS_H
+
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "executer.h"
+#include "programcode.h"
+
+
+// evaluates the constant expressions being folded (which have no output), the code and
+// constants are set for each expression
+
+struct FoldingExecuter {
+    explicit FoldingExecuter(unsigned stack_size);
+
+    std::ostream unused_output {nullptr};
+    Executer executer;
+};
+
+
+// the memory used to compile a line, which a program unit keeps so that each line it compiles
+// reuses the memory of the previous lines instead of allocating; the folding executer is
+// created for the first constant expression and reused after that
+struct CompilerBuffers {
+    ProgramCode code_line;
+    std::vector<unsigned> instruction_offsets;
+    std::string string_constant;
+    std::unique_ptr<FoldingExecuter> folding_executer;
+};
+
+
+inline FoldingExecuter::FoldingExecuter(unsigned stack_size) :
+    executer {nullptr, nullptr, nullptr, nullptr, nullptr, stack_size, unused_output,
+        OutputBuffering::Full}
+{
+}
+
+
+#endif  // IBC_COMPILERBUFFERS_H
@@ -15,13 +15,13 @@
 #include "programunit.h"
 
 
-class ConstNumCompilerImpl : public ConstNumCompiler {
+class ConstNumCompilerImpl {
 public:
     ConstNumCompilerImpl(Compiler &compiler);
 
-    DataType compile() override;
-    bool negateOperator() const noexcept override;
-    char unparsedChar() const noexcept override;
+    DataType compile();
+    bool negateOperator() const noexcept;
+    char unparsedChar() const noexcept;
 
 private:
     void parseInput();
@@ -53,9 +53,11 @@ private:
 
 // ----------------------------------------
 
-std::unique_ptr<ConstNumCompiler> ConstNumCompiler::create(Compiler &compiler)
+ConstNumCompiler::Result ConstNumCompiler::compile(Compiler &compiler)
 {
-    return std::unique_ptr<ConstNumCompiler> {new ConstNumCompilerImpl {compiler}};
+    ConstNumCompilerImpl constant_number {compiler};
+    auto data_type = constant_number.compile();
+    return Result {data_type, constant_number.negateOperator(), constant_number.unparsedChar()};
 }
 
 // ----------------------------------------
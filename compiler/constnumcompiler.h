@@ -8,9 +8,6 @@
 #ifndef IBC_CONSTANTNUMBERPARSER_H
 #define IBC_CONSTANTNUMBERPARSER_H
 
-#include <iosfwd>
-#include <memory>
-
 #include "datatype.h"
 
 
@@ -18,12 +15,14 @@ class Compiler;
 
 class ConstNumCompiler {
 public:
-    static std::unique_ptr<ConstNumCompiler> create(Compiler &compiler);
-
-    virtual DataType compile() = 0;
-    virtual bool negateOperator() const noexcept = 0;
-    virtual char unparsedChar() const noexcept = 0;
-    virtual ~ConstNumCompiler() = default;
+    struct Result {
+        DataType data_type;
+        bool negate_operator;
+        char unparsed_char;
+    };
+
+    // compiles with a constant compiler on the stack (not allocated for each operand)
+    static Result compile(Compiler &compiler);
 };
 
 
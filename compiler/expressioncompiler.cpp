@@ -19,34 +19,39 @@
 
 
 struct ExprErrorFactory {
-    virtual void create(unsigned column)
+    virtual void create(unsigned column) const
     {
         throw ExpExprError {column};
     }
 };
 
 struct NumExprErrorFactory : public ExprErrorFactory {
-    void create(unsigned column) override
+    void create(unsigned column) const override
     {
         throw ExpNumExprError {column};
     }
 };
 
 struct StrExprErrorFactory : public ExprErrorFactory {
-    void create(unsigned column) override
+    void create(unsigned column) const override
     {
         throw ExpStrExprError {column};
     }
 };
 
+// the factories have no state, so one of each is shared by all expression compilers
+const ExprErrorFactory expr_error_factory {};
+const NumExprErrorFactory num_expr_error_factory {};
+const StrExprErrorFactory str_expr_error_factory {};
+
 void NoConvert(Compiler &compiler, DataType data_type);
 
-class ExpressionCompilerImpl : public ExpressionCompiler {
+class ExpressionCompilerImpl {
 public:
     ExpressionCompilerImpl(Compiler &compiler);
 
-    DataType compileExpression(DataType expected_data_type) override;
-    DataType compileExpression() override;
+    DataType compileExpression(DataType expected_data_type);
+    DataType compileExpression();
 
 private:
     using CompileSubExprFunction = DataType (ExpressionCompilerImpl::*)();
@@ -59,6 +64,13 @@ private:
         DataType data_type;
     };
 
+    struct OperatorChain {
+        const OperatorCodes *codes;
+        unsigned operand_count;
+        WordType temporaries;
+        DataType data_type;
+    };
+
     DataType compileImplication();
     DataType compileEquivalence();
     DataType compileOr();
@@ -77,9 +89,9 @@ private:
     DataType compileNegation();
     DataType compileOperand();
     DataType compileFunction();
-    std::vector<DataType> compileFunctionArguments(FunctionCodes *codes);
+    DataType compileFunctionArguments(FunctionCodes *codes);
     DataType compileFunctionArgument(DataType expected_data_type);
-    DataType addFunctionCode(FunctionCodes *codes, std::vector<DataType> argument_data_types) const;
+    DataType addFunctionCode(FunctionCodes *codes, DataType argument_data_type) const;
     DataType compileParentheses();
     DataType compileNumConstant();
     DataType compileNumOperator(Precedence precedence,
@@ -95,18 +107,28 @@ private:
     void setExpressionErrorFactory(DataType data_type);
     DataType addOperatorCodeWithErrorCheck(const OperatorCodes *codes, DataType lhs_data_type,
         const SubExpression &rhs);
+    OperatorCodes::Info selectWithErrorCheck(const OperatorCodes *codes, DataType lhs_data_type,
+        const SubExpression &rhs) const;
+    DataType addChainOperand(OperatorChain &chain, const OperatorCodes *codes,
+        DataType lhs_data_type, const SubExpression &rhs);
+    DataType addChainCode(OperatorChain &chain);
     DataType addOperatorCode(const OperatorCodes *codes, DataType lhs_data_type, DataType rhs_data_type)
         const;
 
     Compiler &compiler;
-    std::unique_ptr<ExprErrorFactory> expression_error;
+    const ExprErrorFactory *expression_error;
 };
 
 // ----------------------------------------
 
-std::unique_ptr<ExpressionCompiler> ExpressionCompiler::create(Compiler &compiler)
+DataType ExpressionCompiler::compileExpression(Compiler &compiler, DataType expected_data_type)
 {
-    return std::unique_ptr<ExpressionCompiler> {new ExpressionCompilerImpl {compiler}};
+    return ExpressionCompilerImpl {compiler}.compileExpression(expected_data_type);
+}
+
+DataType ExpressionCompiler::compileExpression(Compiler &compiler)
+{
+    return ExpressionCompilerImpl {compiler}.compileExpression();
 }
 
 // ----------------------------------------
@@ -146,7 +168,7 @@ void ConvertToInteger(Compiler &compiler, DataType data_type)
 
 ExpressionCompilerImpl::ExpressionCompilerImpl(Compiler &compiler) :
     compiler {compiler},
-    expression_error {new ExprErrorFactory}
+    expression_error {&expr_error_factory}
 {
 }
 
@@ -270,8 +292,7 @@ DataType ExpressionCompilerImpl::compileNegation()
     compiler.skipWhiteSpace();
     auto data_type = compileNumExpression(&ExpressionCompilerImpl::compileExponential);
     auto codes = Table::operatorCodes(Precedence::Negate);
-    compiler.addInstruction(codes->select(data_type).code);
-    return data_type;
+    return compiler.addFoldableInstruction(codes->select(data_type).code, data_type);
 }
 
 DataType ExpressionCompilerImpl::compileOperand()
@@ -296,22 +317,20 @@ DataType ExpressionCompilerImpl::compileOperand()
 DataType ExpressionCompilerImpl::compileFunction()
 {
     if (auto codes = compiler.getNumFunctionCodes()) {
-        auto argument_data_types = compileFunctionArguments(codes);
-        return addFunctionCode(codes, argument_data_types);
+        auto argument_data_type = compileFunctionArguments(codes);
+        return addFunctionCode(codes, argument_data_type);
     }
     return {};
 }
 
-std::vector<DataType> ExpressionCompilerImpl::compileFunctionArguments(FunctionCodes *codes)
+DataType ExpressionCompilerImpl::compileFunctionArguments(FunctionCodes *codes)
 {
-    std::vector<DataType> argument_data_types;
     if (compiler.peekNextChar() == '(') {
-        auto data_type = compileFunctionArgument(codes->argumentDataType());
-        argument_data_types.push_back(data_type);
+        return compileFunctionArgument(codes->argumentDataType());
     } else if (!codes->argumentOptional()) {
         throw CompileError {"expected opening parentheses", compiler.getColumn()};
     }
-    return argument_data_types;
+    return {};
 }
 
 DataType ExpressionCompilerImpl::compileFunctionArgument(DataType expected_data_type)
@@ -327,9 +346,12 @@ DataType ExpressionCompilerImpl::compileFunctionArgument(DataType expected_data_
 }
 
 DataType ExpressionCompilerImpl::addFunctionCode(FunctionCodes *codes,
-    std::vector<DataType> argument_data_types) const
+    DataType argument_data_type) const
 {
-    auto info = codes->select(argument_data_types);
+    auto info = codes->select(argument_data_type);
+    if (codes->foldable()) {
+        return compiler.addFoldableInstruction(info.code, info.result_data_type);
+    }
     compiler.addInstruction(info.code);
     return info.result_data_type;
 }
@@ -351,15 +373,14 @@ DataType ExpressionCompilerImpl::compileParentheses()
 
 DataType ExpressionCompilerImpl::compileNumConstant()
 {
-    auto constant_number = ConstNumCompiler::create(compiler);
-    auto data_type = constant_number->compile();
-    if (!data_type && constant_number->negateOperator()) {
+    auto constant_number = ConstNumCompiler::compile(compiler);
+    if (!constant_number.data_type && constant_number.negate_operator) {
         return compileNegation();
     }
-    if (auto unparsed_char = constant_number->unparsedChar()) {
-        compiler.parseKeyword(unparsed_char);
+    if (constant_number.unparsed_char) {
+        compiler.parseKeyword();
     }
-    return data_type;
+    return constant_number.data_type;
 }
 
 DataType ExpressionCompilerImpl::compileNumOperator(Precedence precedence,
@@ -373,7 +394,7 @@ DataType ExpressionCompilerImpl::compileNumOperator(Precedence precedence,
                 throw ExpNumExprError {lhs.column, lhs.length};
             }
             convert(compiler, lhs.data_type);
-            expression_error.reset(new NumExprErrorFactory);
+            expression_error = &num_expr_error_factory;
             auto rhs_data_type = compileNumExpression(compile_sub_expression);
             convert(compiler, rhs_data_type);
             lhs.data_type = addOperatorCode(codes, lhs.data_type, rhs_data_type);
@@ -398,10 +419,24 @@ DataType ExpressionCompilerImpl::compileNumStrOperator(Precedence precedence,
 {
     auto lhs = compileSubExpression(compile_sub_expression);
     if (lhs.data_type) {
+        OperatorChain chain {nullptr, 0, 0, {}};
         while (auto codes = get_codes(compiler, precedence)) {
             validateLeftOperand(codes, lhs);
+            if (chain.operand_count == MaximumChainOperands) {
+                lhs.data_type = addChainCode(chain);
+            }
             auto rhs = compileSubExpression(compile_sub_expression);
-            lhs.data_type = addOperatorCodeWithErrorCheck(codes, lhs.data_type, rhs);
+            if (lhs.data_type.isNotNumeric() && codes->chainCode()) {
+                lhs.data_type = addChainOperand(chain, codes, lhs.data_type, rhs);
+            } else {
+                if (chain.operand_count > 0) {
+                    addChainCode(chain);
+                }
+                lhs.data_type = addOperatorCodeWithErrorCheck(codes, lhs.data_type, rhs);
+            }
+        }
+        if (chain.operand_count > 0) {
+            lhs.data_type = addChainCode(chain);
         }
     }
     return lhs.data_type;
@@ -432,17 +467,24 @@ void ExpressionCompilerImpl::validateLeftOperand(const OperatorCodes *codes,
 void ExpressionCompilerImpl::setExpressionErrorFactory(DataType data_type)
 {
     if (data_type.isNumeric()) {
-        expression_error.reset(new NumExprErrorFactory);
+        expression_error = &num_expr_error_factory;
     } else {
-        expression_error.reset(new StrExprErrorFactory);
+        expression_error = &str_expr_error_factory;
     }
 }
 
 DataType ExpressionCompilerImpl::addOperatorCodeWithErrorCheck(const OperatorCodes *codes,
     DataType lhs_data_type, const SubExpression &rhs)
+{
+    auto info = selectWithErrorCheck(codes, lhs_data_type, rhs);
+    return compiler.addFoldableInstruction(info.code, info.result_data_type);
+}
+
+OperatorCodes::Info ExpressionCompilerImpl::selectWithErrorCheck(const OperatorCodes *codes,
+    DataType lhs_data_type, const SubExpression &rhs) const
 {
     try {
-        return addOperatorCode(codes, lhs_data_type, rhs.data_type);
+        return codes->select(lhs_data_type, rhs.data_type);
     }
     catch (const ExpNumOperandError &) {
         throw ExpNumExprError {rhs.column, rhs.length};
@@ -452,10 +494,43 @@ DataType ExpressionCompilerImpl::addOperatorCodeWithErrorCheck(const OperatorCod
     }
 }
 
+// the code of a chain of string operators is added after the last operand of the chain (the
+// operands are checked as each is compiled), a chain with more operands than one chain code can
+// have is added before the next operand is compiled, the result of the chain is then the first
+// operand of the next chain
+DataType ExpressionCompilerImpl::addChainOperand(OperatorChain &chain, const OperatorCodes *codes,
+    DataType lhs_data_type, const SubExpression &rhs)
+{
+    auto data_type = selectWithErrorCheck(codes, lhs_data_type, rhs).result_data_type;
+    if (chain.operand_count == 0) {
+        chain.operand_count = 1;
+        chain.temporaries = lhs_data_type.isTmpStr();
+    }
+    chain.codes = codes;
+    chain.temporaries |= WordType {rhs.data_type.isTmpStr()} << chain.operand_count++;
+    chain.data_type = data_type;
+    return data_type;
+}
+
+// a chain of one operator is added as the code of the operator
+DataType ExpressionCompilerImpl::addChainCode(OperatorChain &chain)
+{
+    auto operand_count = chain.operand_count;
+    chain.operand_count = 0;
+    if (operand_count == 2) {
+        auto dataType = [&chain](unsigned operand_index) {
+            return isChainOperandTemporary(chain.temporaries, operand_index)
+                ? DataType::TmpStr() : DataType::String();
+        };
+        return addOperatorCode(chain.codes, dataType(0), dataType(1));
+    }
+    return compiler.addChainInstruction(*chain.codes->chainCode(), operand_count,
+        chain.temporaries, chain.data_type);
+}
+
 DataType ExpressionCompilerImpl::addOperatorCode(const OperatorCodes *codes, DataType lhs_data_type,
     DataType rhs_data_type) const
 {
     auto info = codes->select(lhs_data_type, rhs_data_type);
-    compiler.addInstruction(info.code);
-    return info.result_data_type;
+    return compiler.addFoldableInstruction(info.code, info.result_data_type);
 }
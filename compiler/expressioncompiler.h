@@ -8,9 +8,6 @@
 #ifndef IBC_EXPRESSIONCOMPILER_H
 #define IBC_EXPRESSIONCOMPILER_H
 
-#include <iosfwd>
-#include <memory>
-
 #include <datatype.h>
 
 
@@ -18,11 +15,9 @@ class Compiler;
 
 class ExpressionCompiler {
 public:
-    static std::unique_ptr<ExpressionCompiler> create(Compiler &compiler);
-
-    virtual DataType compileExpression(DataType expected_data_type) = 0;
-    virtual DataType compileExpression() = 0;
-    virtual ~ExpressionCompiler() = default;
+    // compiles with an expression compiler on the stack (not allocated for each expression)
+    static DataType compileExpression(Compiler &compiler, DataType expected_data_type);
+    static DataType compileExpression(Compiler &compiler);
 };
 
 
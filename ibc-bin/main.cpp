@@ -5,12 +5,28 @@
  * (See accompanying file LICENSE or <http://www.gnu.org/licenses/>)
  */
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
 #include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
 #include <string>
+#include <thread>
 #include <vector>
 
+#include <unistd.h>
+
+#include "mappedfile.h"
+#include "mappedprogram.h"
+#include "programimage.h"
 #include "programunit.h"
+#include "threadpool.h"
 
 
 struct IbcError { };
@@ -19,38 +35,81 @@ struct IbcError { };
 class IbcArguments {
 public:
     IbcArguments(int argc, char *argv[]);
-    const std::string &getFileName() const;
+    const std::vector<std::string> &getFileNames() const;
     bool getAlsoRecreate() const;
+    bool getUseImage() const;
+    OutputBuffering getBuffering() const;
+    bool getBatchMode() const;
+    unsigned getJobCount() const;
 
 private:
     void checkNoArguments() const;
-    void checkExtraArguments() const;
-    void parseFileName();
-    bool parseAlsoRecreate();
-    void checkAlsoRecreate();
+    void parseArguments();
+    void parseOption(unsigned &index);
+    const std::string &parseOptionArgument(unsigned &index) const;
+    void parseBuffering(const std::string &argument);
+    void parseJobCount(const std::string &argument);
+    void readFileList(const std::string &list_file_name);
+    void parseFileName(const std::string &argument);
+    void checkFileNames() const;
     void error(const char *message, const std::string &argument) const;
     void usage() const;
 
     std::vector<std::string> args;
-    std::string file_name;
-    bool also_recreate;
+    std::vector<std::string> file_names;
+    bool options_done {false};
+    bool also_recreate {false};
+    bool use_image {false};
+    OutputBuffering buffering;
+    bool batch_mode {false};
+    unsigned job_count {0};
 };
 
 
 class IbcProgram {
 public:
-    IbcProgram(const IbcArguments &arguments);
-    void compile();
-    void recreate();
-    void execute();
+    IbcProgram(const std::string &file_name, const IbcArguments &arguments);
+    bool process(std::ostream &os, std::ostream &error_os);
 
 private:
-    void checkFileOpen();
+    bool openFile(std::ostream &error_os);
+    bool compile(std::ostream &error_os);
+    bool compileSource(std::ostream &error_os);
+    bool mapImage(MappedProgram *image);
+    void saveImage(uint64_t source_hash) const;
+    void recreate(std::ostream &os);
+    bool execute(std::ostream &os);
 
     std::string file_name;
     bool also_recreate;
-    std::ifstream ifs;
+    bool use_image;
+    OutputBuffering buffering;
+    MappedFile source;
     ProgramUnit program;
+    std::unique_ptr<MappedProgram> mapped_program;
+};
+
+
+class IbcBatch {
+public:
+    IbcBatch(const IbcArguments &arguments);
+    bool run();
+
+private:
+    struct Result {
+        std::string output;
+        bool success;
+        bool finished;
+    };
+
+    void runProgram(unsigned index);
+    unsigned outputResults();
+    void outputSummary(unsigned failed_count, double seconds) const;
+
+    const IbcArguments &arguments;
+    std::vector<Result> results;
+    std::mutex mutex;
+    std::condition_variable result_finished;
 };
 
 
@@ -59,11 +118,16 @@ try
 {
     IbcArguments arguments {argc, argv};
 
-    IbcProgram program {arguments};
-
-    program.compile();
-    program.recreate();
-    program.execute();
+    if (arguments.getBatchMode()) {
+        if (!IbcBatch {arguments}.run()) {
+            throw IbcError {};
+        }
+    } else {
+        IbcProgram program {arguments.getFileNames().front(), arguments};
+        if (!program.process(std::cout, std::cerr)) {
+            throw IbcError {};
+        }
+    }
 }
 catch (const IbcError &) {
     return 1;
@@ -71,18 +135,23 @@ catch (const IbcError &) {
 
 // ----------------------------------------
 
+// output is line buffered to a terminal and fully buffered to a file or pipe unless selected;
+// several source files can only be given in batch mode (a job count or a list file)
 IbcArguments::IbcArguments(int argc, char *argv[]) :
-    args {argv, argv + argc}
+    args {argv, argv + argc},
+    buffering {isatty(STDOUT_FILENO) ? OutputBuffering::Line : OutputBuffering::Full}
 {
     checkNoArguments();
-    checkExtraArguments();
-    parseFileName();
-    also_recreate = parseAlsoRecreate();
+    parseArguments();
+    checkFileNames();
+    if (batch_mode && job_count == 0) {
+        job_count = std::max(std::thread::hardware_concurrency(), 1u);
+    }
 }
 
-const std::string &IbcArguments::getFileName() const
+const std::vector<std::string> &IbcArguments::getFileNames() const
 {
-    return file_name;
+    return file_names;
 }
 
 bool IbcArguments::getAlsoRecreate() const
@@ -90,6 +159,26 @@ bool IbcArguments::getAlsoRecreate() const
     return also_recreate;
 }
 
+bool IbcArguments::getUseImage() const
+{
+    return use_image;
+}
+
+OutputBuffering IbcArguments::getBuffering() const
+{
+    return buffering;
+}
+
+bool IbcArguments::getBatchMode() const
+{
+    return batch_mode;
+}
+
+unsigned IbcArguments::getJobCount() const
+{
+    return job_count;
+}
+
 void IbcArguments::checkNoArguments() const
 {
     if (args.size() == 1) {
@@ -98,34 +187,103 @@ void IbcArguments::checkNoArguments() const
     }
 }
 
-void IbcArguments::checkExtraArguments() const
+void IbcArguments::parseArguments()
+{
+    for (unsigned index = 1; index < args.size(); ++index) {
+        if (!options_done && args[index].front() == '-') {
+            parseOption(index);
+        } else {
+            options_done = true;
+            parseFileName(args[index]);
+        }
+    }
+}
+
+void IbcArguments::parseOption(unsigned &index)
 {
-    if (args.size() > 3) {
-        error("extra operand", args[3]);
+    auto &option = args[index];
+    if (option == "-r") {
+        also_recreate = true;
+    } else if (option == "-c") {
+        use_image = true;
+    } else if (option == "-b") {
+        parseBuffering(parseOptionArgument(index));
+    } else if (option == "-j" || option == "--jobs") {
+        parseJobCount(parseOptionArgument(index));
+    } else if (option == "-l" || option == "--list") {
+        readFileList(parseOptionArgument(index));
+    } else {
+        error("invalid option --", option);
         usage();
         throw IbcError {};
     }
 }
 
-void IbcArguments::parseFileName()
+const std::string &IbcArguments::parseOptionArgument(unsigned &index) const
 {
-    file_name = args.size() == 2 ? args[1] : args[2];
+    if (index + 1 == args.size()) {
+        error("option requires an argument --", args[index]);
+        usage();
+        throw IbcError {};
+    }
+    return args[++index];
 }
 
-bool IbcArguments::parseAlsoRecreate()
+void IbcArguments::parseBuffering(const std::string &argument)
 {
-    if (args.size() == 3) {
-        checkAlsoRecreate();
-        return true;
+    if (argument == "line") {
+        buffering = OutputBuffering::Line;
+    } else if (argument == "full") {
+        buffering = OutputBuffering::Full;
     } else {
-        return false;
+        error("invalid buffering --", argument);
+        usage();
+        throw IbcError {};
+    }
+}
+
+// a job count of zero uses a job for each hardware thread
+void IbcArguments::parseJobCount(const std::string &argument)
+{
+    if (argument.empty() || argument.find_first_not_of("0123456789") != std::string::npos
+            || argument.size() > 4) {
+        error("invalid job count --", argument);
+        usage();
+        throw IbcError {};
+    }
+    job_count = std::stoul(argument);
+    batch_mode = true;
+}
+
+void IbcArguments::readFileList(const std::string &list_file_name)
+{
+    std::ifstream ifs {list_file_name};
+    if (!ifs.is_open()) {
+        std::cerr << "ibc: " << list_file_name << ": could not open file" << std::endl;
+        throw IbcError {};
     }
+    std::string file_name;
+    while (std::getline(ifs, file_name)) {
+        if (!file_name.empty()) {
+            file_names.push_back(file_name);
+        }
+    }
+    batch_mode = true;
 }
 
-void IbcArguments::checkAlsoRecreate()
+void IbcArguments::parseFileName(const std::string &argument)
 {
-    if (args[1] != "-r") {
-        error("invalid option --", args[1]);
+    if (!batch_mode && !file_names.empty()) {
+        error("extra operand", argument);
+        usage();
+        throw IbcError {};
+    }
+    file_names.push_back(argument);
+}
+
+void IbcArguments::checkFileNames() const
+{
+    if (file_names.empty()) {
         usage();
         throw IbcError {};
     }
@@ -138,47 +296,202 @@ void IbcArguments::error(const char *message, const std::string &argument) const
 
 void IbcArguments::usage() const
 {
-    std::cerr << "usage: ibc [-r] <source-file>" << std::endl;
+    std::cerr << "usage: ibc [-r] [-c] [-b line|full] <source-file>" << std::endl;
+    std::cerr << "       ibc [-r] [-c] [-j <jobs>] [-l <list-file>] <source-file>..." << std::endl;
 }
 
 // ----------------------------------------
 
-IbcProgram::IbcProgram(const IbcArguments &arguments) :
-    file_name {arguments.getFileName()},
+IbcProgram::IbcProgram(const std::string &file_name, const IbcArguments &arguments) :
+    file_name {file_name},
     also_recreate {arguments.getAlsoRecreate()},
-    ifs {file_name}
+    use_image {arguments.getUseImage()},
+    buffering {arguments.getBuffering()},
+    source {file_name}
 {
-    checkFileOpen();
+    program.setConstantFolding(true);
 }
 
-void IbcProgram::checkFileOpen()
+bool IbcProgram::process(std::ostream &os, std::ostream &error_os)
 {
-    if (!ifs.is_open()) {
-        std::cerr << "ibc: " << file_name << ": could not open file" << std::endl;
-        throw IbcError {};
+    if (!compile(error_os)) {
+        return false;
     }
+    recreate(os);
+    return execute(os);
 }
 
-void IbcProgram::compile()
+bool IbcProgram::openFile(std::ostream &error_os)
 {
-    if (!program.compileSource(ifs, std::cerr)) {
-        std::cerr << file_name << ": contains errros, program not run" << std::endl;
-        throw IbcError {};
+    if (!source.isOpen()) {
+        error_os << "ibc: " << file_name << ": could not open file" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// the compiled program is saved to an image file next to the source file, which is loaded
+// instead of compiling the source when the source has not changed
+bool IbcProgram::compile(std::ostream &error_os)
+{
+    if (!openFile(error_os)) {
+        return false;
+    }
+    if (!use_image) {
+        return compileSource(error_os);
+    }
+    auto source_hash = ProgramImage::hashSource(source.data(), source.size());
+    if (mapImage(new MappedProgram {file_name + ".ibc", source_hash,
+            program.constantFolding()})) {
+        return true;
     }
+    if (!compileSource(error_os)) {
+        return false;
+    }
+    saveImage(source_hash);
+    return true;
+}
+
+// the source is compiled where it is mapped without being copied
+bool IbcProgram::compileSource(std::ostream &error_os)
+{
+    if (!program.compileSource(source.data(), source.size(), error_os)) {
+        error_os << file_name << ": contains errros, program not run" << std::endl;
+        return false;
+    }
+    program.fuseCode();
+    return true;
 }
 
-void IbcProgram::recreate()
+// the image is run where it is mapped unless the program is also recreated (or the image was
+// saved by a build with different code values), then it is loaded into the program unit
+bool IbcProgram::mapImage(MappedProgram *image)
+{
+    mapped_program.reset(image);
+    if (mapped_program->runsInPlace() && !also_recreate) {
+        return true;
+    }
+    auto loaded = mapped_program->load(program);
+    mapped_program.reset();
+    return loaded;
+}
+
+// the image is written to a temporary file that is renamed so that a program being run at the
+// same time never loads a partial image; the program is still run if it can't be saved
+void IbcProgram::saveImage(uint64_t source_hash) const
+{
+    std::ostringstream thread_id;
+    thread_id << std::this_thread::get_id();
+    auto image_file_name = file_name + ".ibc";
+    auto temporary_file_name = image_file_name + '.' + std::to_string(getpid()) + '.'
+        + thread_id.str();
+    {
+        std::ofstream image_ofs {temporary_file_name, std::ios::binary};
+        ProgramImage::save(image_ofs, program, source_hash);
+        if (!image_ofs.flush()) {
+            image_ofs.close();
+            std::remove(temporary_file_name.c_str());
+            return;
+        }
+    }
+    if (std::rename(temporary_file_name.c_str(), image_file_name.c_str()) != 0) {
+        std::remove(temporary_file_name.c_str());
+    }
+}
+
+void IbcProgram::recreate(std::ostream &os)
 {
     if (also_recreate) {
-        std::cout << "Program:" << std::endl;
-        program.recreate(std::cout);
-        std::cout << std::endl << "Executing..." << std::endl;
+        os << "Program:" << std::endl;
+        program.recreate(os);
+        os << std::endl << "Executing..." << std::endl;
     }
 }
 
-void IbcProgram::execute()
+bool IbcProgram::execute(std::ostream &os)
 {
-    if (!program.runCode(std::cout)) {
-        throw IbcError {};
+    if (mapped_program) {
+        return mapped_program->runCode(os, buffering);
+    }
+    return program.runCode(os, buffering);
+}
+
+// ----------------------------------------
+
+// each program is compiled and run by a job with its output kept until the output of all the
+// programs before it has been written, so the output is in the order of the source files
+IbcBatch::IbcBatch(const IbcArguments &arguments) :
+    arguments {arguments},
+    results {arguments.getFileNames().size(), Result {"", false, false}}
+{
+}
+
+bool IbcBatch::run()
+{
+    using Clock = std::chrono::steady_clock;
+
+    auto start = Clock::now();
+    unsigned failed_count;
+    {
+        ThreadPool thread_pool {arguments.getJobCount()};
+        for (unsigned index = 0; index < results.size(); ++index) {
+            thread_pool.submit([this, index]() { runProgram(index); });
+        }
+        failed_count = outputResults();
     }
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+    outputSummary(failed_count, elapsed.count());
+    return failed_count == 0;
+}
+
+// the result is always stored (failed if the program could not be processed), otherwise the
+// output of the programs waits for it forever
+void IbcBatch::runProgram(unsigned index)
+{
+    auto &file_name = arguments.getFileNames()[index];
+    std::ostringstream oss;
+    bool success = false;
+    try {
+        IbcProgram program {file_name, arguments};
+        success = program.process(oss, oss);
+    }
+    catch (const std::exception &error) {
+        oss << "ibc: " << file_name << ": " << error.what() << std::endl;
+    }
+    catch (...) {
+        oss << "ibc: " << file_name << ": unexpected error" << std::endl;
+    }
+
+    std::lock_guard<std::mutex> lock {mutex};
+    results[index] = Result {oss.str(), success, true};
+    result_finished.notify_all();
+}
+
+unsigned IbcBatch::outputResults()
+{
+    unsigned failed_count = 0;
+    for (unsigned index = 0; index < results.size(); ++index) {
+        std::unique_lock<std::mutex> lock {mutex};
+        auto &result = results[index];
+        result_finished.wait(lock, [&result]() { return result.finished; });
+        std::string output;
+        output.swap(result.output);
+        lock.unlock();
+
+        std::cout << "==> " << arguments.getFileNames()[index] << " <==\n" << output;
+        if (!result.success) {
+            ++failed_count;
+        }
+    }
+    std::cout.flush();
+    return failed_count;
+}
+
+void IbcBatch::outputSummary(unsigned failed_count, double seconds) const
+{
+    auto program_count = results.size();
+    std::cerr << "ibc: " << program_count << " programs (" << failed_count << " failed) in "
+        << std::fixed << std::setprecision(3) << seconds << " seconds, " << std::setprecision(1)
+        << program_count / seconds << " programs/second with " << arguments.getJobCount()
+        << " jobs" << std::endl;
 }
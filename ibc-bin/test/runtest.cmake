@@ -7,8 +7,26 @@
 set(out_file ${TEST_NAME}.out)
 set(exp_file ${TEST_NAME}.exp)
 
-execute_process(COMMAND ${TEST_PROGRAM} ${TEST_ARGS}
-    WORKING_DIRECTORY ${SOURCE_DIR}
+# the input file is fed to the program through a pipe
+if (TEST_INPUT)
+    set(input_command COMMAND cat ${TEST_INPUT})
+endif ()
+
+# the test is run in its own directory when it has one
+if (TEST_DIR)
+    file(MAKE_DIRECTORY ${TEST_DIR})
+    foreach (file ${TEST_REMOVE})
+        file(REMOVE ${TEST_DIR}/${file})
+    endforeach ()
+    foreach (file ${TEST_COPY})
+        file(COPY ${file} DESTINATION ${TEST_DIR})
+    endforeach ()
+else ()
+    set(TEST_DIR ${SOURCE_DIR})
+endif ()
+
+execute_process(${input_command} COMMAND ${TEST_PROGRAM} ${TEST_ARGS}
+    WORKING_DIRECTORY ${TEST_DIR}
     RESULT_VARIABLE result
     OUTPUT_FILE ${BINARY_DIR}/${out_file}
     ERROR_FILE ${BINARY_DIR}/${out_file}
@@ -18,6 +36,13 @@ if (NOT ${result} STREQUAL ${TEST_EXPECT})
     message(FATAL_ERROR "Test failed: ${TEST_PROGRAM} returned ${result}, expected ${TEST_EXPECT}")
 endif ()
 
+# remove output lines that vary from run to run (like timings)
+if (TEST_IGNORE)
+    file(READ ${BINARY_DIR}/${out_file} output)
+    string(REGEX REPLACE "${TEST_IGNORE}[^\n]*\n" "" output "${output}")
+    file(WRITE ${BINARY_DIR}/${out_file} "${output}")
+endif ()
+
 execute_process(COMMAND ${CMAKE_COMMAND} -E compare_files
     ${BINARY_DIR}/${out_file} ${SOURCE_DIR}/${exp_file}
     RESULT_VARIABLE mismatch
@@ -0,0 +1,63 @@
+/* vim:ts=4:sw=4:et:sts=4:
+ *
+ * Copyright 2016 Thunder422.  All rights reserved.
+ * Distributed under GNU General Public License Version 3
+ * (See accompanying file LICENSE or <http://www.gnu.org/licenses/>)
+ */
+
+#include "threadpool.h"
+
+
+ThreadPool::ThreadPool(unsigned thread_count)
+{
+    for (unsigned index = 0; index < thread_count; ++index) {
+        threads.emplace_back(&ThreadPool::runTasks, this);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock {mutex};
+        stopping = true;
+    }
+    task_available.notify_all();
+    for (auto &thread : threads) {
+        thread.join();
+    }
+}
+
+void ThreadPool::submit(Task task)
+{
+    {
+        std::lock_guard<std::mutex> lock {mutex};
+        tasks.emplace_back(std::move(task));
+    }
+    task_available.notify_one();
+}
+
+void ThreadPool::runTasks()
+{
+    Task task;
+    while (takeTask(task)) {
+        try {
+            task();
+        }
+        catch (...) {
+        }
+        task = nullptr;
+    }
+}
+
+// returns false when the pool is stopping and there are no more tasks
+bool ThreadPool::takeTask(Task &task)
+{
+    std::unique_lock<std::mutex> lock {mutex};
+    task_available.wait(lock, [this]() { return !tasks.empty() || stopping; });
+    if (tasks.empty()) {
+        return false;
+    }
+    task = std::move(tasks.front());
+    tasks.pop_front();
+    return true;
+}
@@ -0,0 +1,44 @@
+/* vim:ts=4:sw=4:et:sts=4:
+ *
+ * Copyright 2016 Thunder422.  All rights reserved.
+ * Distributed under GNU General Public License Version 3
+ * (See accompanying file LICENSE or <http://www.gnu.org/licenses/>)
+ */
+
+#ifndef IBC_THREADPOOL_H
+#define IBC_THREADPOOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+// the tasks wait in one queue in the order submitted (by any thread, including a task), and
+// each idle thread takes the next one when it is ready for it; a thread with nothing to take
+// waits for a task to be submitted, the destructor waits for all the tasks to finish; a task
+// reports its own errors, an exception thrown by a task is dropped so the thread keeps running
+
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    explicit ThreadPool(unsigned thread_count);
+    ~ThreadPool();
+    void submit(Task task);
+
+private:
+    void runTasks();
+    bool takeTask(Task &task);
+
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable task_available;
+    std::deque<Task> tasks;
+    bool stopping {false};
+};
+
+
+#endif  // IBC_THREADPOOL_H
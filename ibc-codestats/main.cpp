@@ -0,0 +1,206 @@
+/* vim:ts=4:sw=4:et:sts=4:
+ *
+ * Copyright 2016 Thunder422.  All rights reserved.
+ * Distributed under GNU General Public License Version 3
+ * (See accompanying file LICENSE or <http://www.gnu.org/licenses/>)
+ */
+
+// reports the code sequences that occur most often in a set of programs,
+// which is used to choose the codes that are fused (see fusedcode.h),
+// and the memory used by the constant dictionaries
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "commandcode.h"
+#include "programreader.h"
+#include "programunit.h"
+#include "table.h"
+
+
+struct CodeStatsError { };
+
+using CodeSequence = std::vector<WordType>;
+
+
+class SequenceCounter {
+public:
+    void countFile(const std::string &file_name);
+    void output(std::ostream &os, unsigned maximum_lines) const;
+
+private:
+    struct SequenceInfo {
+        unsigned count;
+        std::string example;
+    };
+    using SequenceEntry = std::pair<CodeSequence, SequenceInfo>;
+
+    void countLine(const ProgramUnit &program, unsigned line_index, const std::string &location);
+    static void addMemoryUsage(Dictionary::MemoryUsage &total,
+        const Dictionary::MemoryUsage &memory_usage);
+    static void outputMemoryUsage(std::ostream &os, const std::string &name,
+        const Dictionary::MemoryUsage &memory_usage);
+    void countSequences(const CodeSequence &codes, const std::string &example);
+    void outputSequences(std::ostream &os, unsigned length, unsigned maximum_lines) const;
+    std::vector<SequenceEntry> sortedSequences(unsigned length) const;
+    static std::string describeCode(WordType code_value);
+
+    std::map<CodeSequence, SequenceInfo> sequences;
+    unsigned line_count {0};
+    Dictionary::MemoryUsage constant_numbers {};
+    Dictionary::MemoryUsage constant_strings {};
+};
+
+
+void usage();
+
+
+int main(int argc, char *argv[])
+try
+{
+    if (argc < 2) {
+        usage();
+        throw CodeStatsError {};
+    }
+    SequenceCounter counter;
+    for (int i = 1; i < argc; ++i) {
+        counter.countFile(argv[i]);
+    }
+    counter.output(std::cout, 20);
+}
+catch (const CodeStatsError &) {
+    return 1;
+}
+
+void usage()
+{
+    std::cerr << "usage: ibc-codestats <source-file>..." << std::endl;
+}
+
+// ----------------------------------------
+
+void SequenceCounter::countFile(const std::string &file_name)
+{
+    std::ifstream ifs {file_name};
+    if (!ifs.is_open()) {
+        std::cerr << "ibc-codestats: " << file_name << ": could not open file" << std::endl;
+        throw CodeStatsError {};
+    }
+    ProgramUnit program;
+    program.compileSource(ifs, std::cerr);
+    for (unsigned line_index = 0; line_index < program.lineCount(); ++line_index) {
+        auto location = file_name + ':' + std::to_string(line_index + 1);
+        countLine(program, line_index, location);
+    }
+    addMemoryUsage(constant_numbers, program.getConstantNumberMemoryUsage());
+    addMemoryUsage(constant_strings, program.getConstantStringMemoryUsage());
+}
+
+void SequenceCounter::countLine(const ProgramUnit &program, unsigned line_index,
+    const std::string &location)
+{
+    CodeSequence codes;
+    auto program_reader = program.createProgramReader(line_index);
+    while (program_reader.hasMoreCode()) {
+        auto code = program_reader.getInstruction();
+        codes.push_back(code->getValue());
+        for (auto operand_count = code->getOperandCount(); operand_count > 0; --operand_count) {
+            program_reader.getOperand();
+        }
+    }
+    if (codes.empty()) {
+        return;  // line with an error
+    }
+    ++line_count;
+    countSequences(codes, location + ": " + program.recreateLine(line_index));
+}
+
+// counts every sequence of two and three codes within the line
+void SequenceCounter::countSequences(const CodeSequence &codes, const std::string &example)
+{
+    for (auto begin = codes.begin(); begin != codes.end(); ++begin) {
+        for (unsigned length = 2; length <= 3 && begin + length <= codes.end(); ++length) {
+            auto &info = sequences[CodeSequence {begin, begin + length}];
+            if (info.count++ == 0) {
+                info.example = example;
+            }
+        }
+    }
+}
+
+void SequenceCounter::output(std::ostream &os, unsigned maximum_lines) const
+{
+    os << line_count << " lines" << std::endl;
+    outputMemoryUsage(os, "constant numbers", constant_numbers);
+    outputMemoryUsage(os, "constant strings", constant_strings);
+    outputSequences(os, 2, maximum_lines);
+    outputSequences(os, 3, maximum_lines);
+}
+
+void SequenceCounter::addMemoryUsage(Dictionary::MemoryUsage &total,
+    const Dictionary::MemoryUsage &memory_usage)
+{
+    total.entry_count += memory_usage.entry_count;
+    total.characters += memory_usage.characters;
+    total.entries += memory_usage.entries;
+    total.hash_table += memory_usage.hash_table;
+    total.values += memory_usage.values;
+}
+
+void SequenceCounter::outputMemoryUsage(std::ostream &os, const std::string &name,
+    const Dictionary::MemoryUsage &memory_usage)
+{
+    os << name << ": " << memory_usage.entry_count << " entries, " << memory_usage.total()
+        << " bytes (characters " << memory_usage.characters << ", entries "
+        << memory_usage.entries << ", hash table " << memory_usage.hash_table << ", values "
+        << memory_usage.values << ')' << std::endl;
+}
+
+void SequenceCounter::outputSequences(std::ostream &os, unsigned length,
+    unsigned maximum_lines) const
+{
+    os << std::endl << "sequences of " << length << " codes:" << std::endl;
+    auto entries = sortedSequences(length);
+    if (entries.size() > maximum_lines) {
+        entries.resize(maximum_lines);
+    }
+    for (auto &entry : entries) {
+        std::string description;
+        for (auto code_value : entry.first) {
+            description += describeCode(code_value) + ' ';
+        }
+        os << std::setw(8) << entry.second.count << "  " << std::left << std::setw(32)
+            << description << std::right << entry.second.example << std::endl;
+    }
+}
+
+std::vector<SequenceCounter::SequenceEntry> SequenceCounter::sortedSequences(
+    unsigned length) const
+{
+    std::vector<SequenceEntry> entries;
+    for (auto &entry : sequences) {
+        if (entry.first.size() == length) {
+            entries.push_back(entry);
+        }
+    }
+    auto higher_count = [](const SequenceEntry &lhs, const SequenceEntry &rhs) {
+        return lhs.second.count > rhs.second.count;
+    };
+    std::stable_sort(entries.begin(), entries.end(), higher_count);
+    return entries;
+}
+
+// codes without a keyword (constants, print items, conversions) are only identified by value
+std::string SequenceCounter::describeCode(WordType code_value)
+{
+    auto keyword = Table::findKeyword(code_value);
+    if (!keyword) {
+        keyword = CommandCode::findKeyword(code_value);
+    }
+    return (keyword ? keyword : "") + ('#' + std::to_string(code_value));
+}
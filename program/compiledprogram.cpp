@@ -0,0 +1,49 @@
+/* vim:ts=4:sw=4:et:sts=4:
+ *
+ * Copyright 2016 Thunder422.  All rights reserved.
+ * Distributed under GNU General Public License Version 3
+ * (See accompanying file LICENSE or <http://www.gnu.org/licenses/>)
+ */
+
+#include <utility>
+
+#include "compiledprogram.h"
+#include "programerror.h"
+#include "runerror.h"
+
+
+CompiledProgram::CompiledProgram(ProgramUnit &&program) :
+    program {std::move(program)}
+{
+}
+
+Executer CompiledProgram::createExecuter(std::ostream &os, OutputBuffering buffering,
+    Dispatch dispatch) const
+{
+    return program.createExecuter(os, buffering, dispatch);
+}
+
+// the output and dispatch of the executer are set for each run
+bool CompiledProgram::runCode(Executer &executer, std::ostream &os, OutputBuffering buffering,
+    Dispatch dispatch) const noexcept
+{
+    executer.setOutput(os, buffering);
+    executer.setDispatch(dispatch);
+    executer.run();
+    if (executer.hasRunError()) {
+        program.generateProgramError(executer.getRunError()).output(os);
+        return false;
+    }
+    return true;
+}
+
+void CompiledProgram::run(Executer &executer, std::ostream &os, OutputBuffering buffering,
+    Dispatch dispatch) const
+{
+    executer.setOutput(os, buffering);
+    executer.setDispatch(dispatch);
+    executer.run();
+    if (executer.hasRunError()) {
+        throw program.generateProgramError(executer.getRunError());
+    }
+}
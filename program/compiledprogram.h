@@ -0,0 +1,41 @@
+/* vim:ts=4:sw=4:et:sts=4:
+ *
+ * Copyright 2016 Thunder422.  All rights reserved.
+ * Distributed under GNU General Public License Version 3
+ * (See accompanying file LICENSE or <http://www.gnu.org/licenses/>)
+ */
+
+#ifndef IBC_COMPILEDPROGRAM_H
+#define IBC_COMPILEDPROGRAM_H
+
+#include <iosfwd>
+
+#include "executer.h"
+#include "programunit.h"
+
+
+// a program unit that is no longer being changed (it is moved into the compiled program), which
+// can be run any number of times by reusing an executer; nothing is changed by running the
+// program, so any number of executers on different threads can run it at the same time; the
+// executers refer to the code and constants of the program, so it must not be moved while they
+// are used
+
+class CompiledProgram {
+public:
+    explicit CompiledProgram(ProgramUnit &&program);
+
+    Executer createExecuter(std::ostream &os, OutputBuffering buffering = OutputBuffering::Line,
+        Dispatch dispatch = Dispatch::Labels) const;
+    bool runCode(Executer &executer, std::ostream &os,
+        OutputBuffering buffering = OutputBuffering::Line,
+        Dispatch dispatch = Dispatch::Labels) const noexcept;
+    void run(Executer &executer, std::ostream &os,
+        OutputBuffering buffering = OutputBuffering::Line,
+        Dispatch dispatch = Dispatch::Labels) const;
+
+private:
+    ProgramUnit program;
+};
+
+
+#endif  // IBC_COMPILEDPROGRAM_H
@@ -0,0 +1,79 @@
+/* vim:ts=4:sw=4:et:sts=4:
+ *
+ * Copyright 2016 Thunder422.  All rights reserved.
+ * Distributed under GNU General Public License Version 3
+ * (See accompanying file LICENSE or <http://www.gnu.org/licenses/>)
+ */
+
+#include <cerrno>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "mappedfile.h"
+
+
+constexpr std::size_t ReadBlockSize = 65536;
+
+
+MappedFile::MappedFile(const std::string &file_name)
+{
+    auto fd = ::open(file_name.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        if (!map(fd)) {
+            read(fd);
+        }
+        close(fd);
+    }
+}
+
+MappedFile::~MappedFile()
+{
+    if (mapped) {
+        munmap(const_cast<char *>(mapping), mapping_size);
+    }
+}
+
+// the size of a file that is not a regular file is not its contents (the size of a pipe is zero)
+bool MappedFile::map(int fd)
+{
+    struct stat file_status;
+    if (fstat(fd, &file_status) != 0 || !S_ISREG(file_status.st_mode)
+            || file_status.st_size == 0) {
+        return false;
+    }
+    auto size = static_cast<std::size_t>(file_status.st_size);
+    auto address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (address == MAP_FAILED) {
+        return false;
+    }
+    open = true;
+    mapped = true;
+    mapping = static_cast<const char *>(address);
+    mapping_size = size;
+    return true;
+}
+
+void MappedFile::read(int fd)
+{
+    std::size_t size = 0;
+    for (;;) {
+        buffer.resize(size + ReadBlockSize);
+        auto count = ::read(fd, buffer.data() + size, ReadBlockSize);
+        if (count > 0) {
+            size += count;
+        } else if (count == 0) {
+            break;
+        } else if (errno != EINTR) {
+            buffer.clear();
+            return;
+        }
+    }
+    buffer.resize(size);
+    buffer.shrink_to_fit();
+    open = true;
+    mapping = size == 0 ? nullptr : buffer.data();
+    mapping_size = size;
+}
@@ -0,0 +1,60 @@
+/* vim:ts=4:sw=4:et:sts=4:
+ *
+ * Copyright 2016 Thunder422.  All rights reserved.
+ * Distributed under GNU General Public License Version 3
+ * (See accompanying file LICENSE or <http://www.gnu.org/licenses/>)
+ */
+
+#ifndef IBC_MAPPEDFILE_H
+#define IBC_MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+
+// a file mapped into memory read only (so the pages are shared by all the processes that map
+// the same file and the contents are read without being copied); a file that is not a regular
+// file (like a pipe) or can't be mapped is read into a buffer instead, and an empty file is open
+// but has no data
+
+class MappedFile {
+public:
+    explicit MappedFile(const std::string &file_name);
+    ~MappedFile();
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    bool isOpen() const;
+    const char *data() const;
+    std::size_t size() const;
+
+private:
+    bool map(int fd);
+    void read(int fd);
+
+    bool open {false};
+    bool mapped {false};
+    const char *mapping {nullptr};
+    std::size_t mapping_size {0};
+    std::vector<char> buffer;
+};
+
+
+inline bool MappedFile::isOpen() const
+{
+    return open;
+}
+
+inline const char *MappedFile::data() const
+{
+    return mapping;
+}
+
+inline std::size_t MappedFile::size() const
+{
+    return mapping_size;
+}
+
+
+#endif  // IBC_MAPPEDFILE_H
@@ -0,0 +1,62 @@
+/* vim:ts=4:sw=4:et:sts=4:
+ *
+ * Copyright 2016 Thunder422.  All rights reserved.
+ * Distributed under GNU General Public License Version 3
+ * (See accompanying file LICENSE or <http://www.gnu.org/licenses/>)
+ */
+
+#include "mappedprogram.h"
+#include "programerror.h"
+#include "programunit.h"
+#include "runerror.h"
+
+
+MappedProgram::MappedProgram(const std::string &file_name, uint64_t source_hash,
+        bool constant_folding) :
+    file {file_name},
+    image {file.data(), file.size()},
+    open {image.open(source_hash, constant_folding)}
+{
+}
+
+bool MappedProgram::runsInPlace() const
+{
+    return open && image.codeValuesMatch();
+}
+
+bool MappedProgram::load(ProgramUnit &program) const
+{
+    return open && image.load(program);
+}
+
+Executer MappedProgram::createExecuter(std::ostream &os, OutputBuffering buffering,
+    Dispatch dispatch) const
+{
+    return Executer {image.getCode(), image.getDblValues(), image.getIntValues(),
+        image.getStrCharacters(), image.getStrOffsets(), image.getMaximumStackDepth(), os,
+        buffering, dispatch};
+}
+
+// the program must run in place
+bool MappedProgram::runCode(std::ostream &os, OutputBuffering buffering, Dispatch dispatch) const
+    noexcept
+{
+    auto executer = createExecuter(os, buffering, dispatch);
+    executer.run();
+    if (executer.hasRunError()) {
+        outputRunError(executer.getRunError(), os);
+        return false;
+    }
+    return true;
+}
+
+// the program is only loaded to report a run error since the line needs to be recreated
+void MappedProgram::outputRunError(const RunError &error, std::ostream &os) const
+{
+    ProgramUnit program;
+    if (image.load(program)) {
+        program.generateProgramError(error).output(os);
+    } else {
+        ProgramError {error}.output(os);
+    }
+}
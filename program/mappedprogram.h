@@ -0,0 +1,54 @@
+/* vim:ts=4:sw=4:et:sts=4:
+ *
+ * Copyright 2016 Thunder422.  All rights reserved.
+ * Distributed under GNU General Public License Version 3
+ * (See accompanying file LICENSE or <http://www.gnu.org/licenses/>)
+ */
+
+#ifndef IBC_MAPPEDPROGRAM_H
+#define IBC_MAPPEDPROGRAM_H
+
+#include <iosfwd>
+#include <string>
+
+#include "executer.h"
+#include "mappedfile.h"
+#include "programimage.h"
+
+
+class ProgramUnit;
+struct RunError;
+
+// a program image file mapped into memory (read only, so the pages are shared by all the
+// processes that map the same file), which is run where it is in memory when the code values
+// of the image are the same as the running program, otherwise it can be loaded into a program
+// unit; nothing is copied to run the program (the string constants are views of the image)
+
+class MappedProgram {
+public:
+    MappedProgram(const std::string &file_name, uint64_t source_hash, bool constant_folding);
+
+    bool isOpen() const;
+    bool runsInPlace() const;
+    bool load(ProgramUnit &program) const;
+    Executer createExecuter(std::ostream &os, OutputBuffering buffering = OutputBuffering::Line,
+        Dispatch dispatch = Dispatch::Labels) const;
+    bool runCode(std::ostream &os, OutputBuffering buffering = OutputBuffering::Line,
+        Dispatch dispatch = Dispatch::Labels) const noexcept;
+
+private:
+    void outputRunError(const RunError &error, std::ostream &os) const;
+
+    MappedFile file;
+    ProgramImage image;
+    bool open;
+};
+
+
+inline bool MappedProgram::isOpen() const
+{
+    return open;
+}
+
+
+#endif  // IBC_MAPPEDPROGRAM_H
@@ -5,6 +5,9 @@
  * (See accompanying file LICENSE or <http://www.gnu.org/licenses/>)
  */
 
+#include <algorithm>
+
+#include "fusedcode.h"
 #include "programcode.h"
 
 ProgramCode::ProgramCode()
@@ -14,9 +17,60 @@ ProgramCode::ProgramCode()
 void ProgramCode::append(ProgramCode &more)
 {
     code.insert(code.end(), more.code.begin(), more.code.end());
+    maximum_stack_depth = std::max(maximum_stack_depth, more.maximum_stack_depth);
 }
 
 void ProgramCode::pop_back()
 {
     code.pop_back();
 }
+
+// the memory of the code is kept so that it can be reused
+void ProgramCode::clear()
+{
+    code.clear();
+    stack_depth = 0;
+    maximum_stack_depth = 0;
+}
+
+void ProgramCode::resize(std::size_t size)
+{
+    code.resize(size, ProgramWord {0});
+}
+
+// moves the instructions at offset to the fused offset (which is not after the offset) fusing
+// each instruction with the previous instruction where there is a fused code for the pair,
+// the operands of a fused code are the operands of the first code followed by the second code
+unsigned ProgramCode::fuseInstructions(unsigned offset, unsigned size, unsigned fused_offset)
+{
+    auto end_offset = offset + size;
+    auto next_offset = fused_offset;
+    auto previous_offset = end_offset;
+    while (offset < end_offset) {
+        auto code_value = code[offset].operand();
+        auto operand_count = code[offset].instructionCode()->getOperandCount();
+        Code *fused_code = nullptr;
+        if (previous_offset != end_offset) {
+            fused_code = FusedCode::find(code[previous_offset].operand(), code_value);
+        }
+        if (fused_code) {
+            code[previous_offset] = ProgramWord {*fused_code};
+        } else {
+            previous_offset = next_offset;
+            code[next_offset++] = code[offset];
+        }
+        ++offset;
+        for (; operand_count > 0; --operand_count) {
+            code[next_offset++] = code[offset++];
+        }
+    }
+    return next_offset - fused_offset;
+}
+
+void ProgramCode::adjustStackDepth(int stack_effect)
+{
+    stack_depth += stack_effect;
+    if (stack_depth > static_cast<int>(maximum_stack_depth)) {
+        maximum_stack_depth = stack_depth;
+    }
+}
@@ -28,11 +28,21 @@ public:
     template <typename... Args> void emplace_back(Args &&... args);
     void append(ProgramCode &more);
     void pop_back();
+    void clear();
+    void reserve(std::size_t size);
+    void resize(std::size_t size);
+    unsigned fuseInstructions(unsigned offset, unsigned size, unsigned fused_offset);
     ProgramConstIterator begin() const;
+    ProgramConstIterator end() const;
     const WordType *getBeginning() const;
+    void adjustStackDepth(int stack_effect);
+    unsigned maximumStackDepth() const;
+    void setMaximumStackDepth(unsigned stack_depth);
 
 private:
     ProgramVector code;
+    int stack_depth {0};
+    unsigned maximum_stack_depth {0};
 };
 
 
@@ -57,15 +67,35 @@ inline void ProgramCode::emplace_back(Args &&... args)
     code.emplace_back(std::forward<Args>(args)...);
 }
 
+inline void ProgramCode::reserve(std::size_t size)
+{
+    code.reserve(size);
+}
+
 inline ProgramConstIterator ProgramCode::begin() const
 {
     return code.cbegin();
 }
 
+inline ProgramConstIterator ProgramCode::end() const
+{
+    return code.cend();
+}
+
 inline const WordType *ProgramCode::getBeginning() const
 {
     return code[0].addressOf();
 }
 
+inline unsigned ProgramCode::maximumStackDepth() const
+{
+    return maximum_stack_depth;
+}
+
+inline void ProgramCode::setMaximumStackDepth(unsigned stack_depth)
+{
+    maximum_stack_depth = stack_depth;
+}
+
 
 #endif  // IBC_PROGRAMCODE_H
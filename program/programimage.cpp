@@ -0,0 +1,675 @@
+/* vim:ts=4:sw=4:et:sts=4:
+ *
+ * Copyright 2016 Thunder422.  All rights reserved.
+ * Distributed under GNU General Public License Version 3
+ * (See accompanying file LICENSE or <http://www.gnu.org/licenses/>)
+ */
+
+#include <algorithm>
+#include <istream>
+#include <iterator>
+#include <ostream>
+#include <unordered_map>
+
+#include "commandcode.h"
+#include "fusedcode.h"
+#include "operators.h"
+#include "programimage.h"
+#include "programunit.h"
+
+
+extern CommandCode end_code;
+extern Code const_dbl_code, const_int_code, const_dbl_long_code, const_int_long_code;
+extern Code folded_dbl_code, folded_int_code, folded_dbl_long_code, folded_int_long_code;
+extern Code const_str_code, const_str_long_code, folded_str_code, folded_str_long_code;
+
+// the words are saved in the byte order of the machine, which is detected by the magic number
+constexpr uint32_t ImageMagic = 0x58434249;  // "IBCX"
+constexpr std::size_t ImageAlignment = alignof(double);
+
+
+struct ImageError { };
+
+
+class ImageWriter {
+public:
+    ImageWriter(std::ostream &os);
+
+    void writeCodeNames();
+    void writeCode(const ProgramCode &code);
+    void writeLineInfo(const std::vector<ProgramUnit::LineInfo> &line_info);
+    void writeStrings(const Dictionary &dictionary);
+    template <typename T> void writeArray(const T *array, std::size_t count);
+    template <typename T> void write(T value);
+
+private:
+    void writeBytes(const void *bytes, std::size_t count);
+    void align();
+
+    std::ostream &os;
+    std::size_t offset {0};
+};
+
+
+class ImageReader {
+public:
+    ImageReader(const char *image, std::size_t size);
+
+    std::string readString();
+    template <typename T> const T *readArray(std::size_t count);
+    template <typename T> T read();
+
+private:
+    const char *readBytes(std::size_t count);
+
+    const char *image;
+    std::size_t size;
+    std::size_t offset {0};
+};
+
+
+// checks the code of an image so that the code can be run where it is (the executer does not
+// check the code): the instructions must be codes with their operands within the code, the
+// constant operands must be entries of the dictionaries (or folded expressions), each code must
+// pop items of the data types it expects, and the stack must stay within the maximum stack depth;
+// the stack depth the code reaches is returned
+
+class CodeChecker {
+public:
+    CodeChecker(const std::vector<Code *> &codes, uint32_t number_count, uint32_t string_count,
+        uint32_t folded_expression_count);
+
+    uint32_t checkCode(const WordType *code, uint32_t code_size,
+        uint32_t maximum_stack_depth) const;
+    void checkFoldedCode(const WordType *code, uint32_t code_size) const;
+
+private:
+    enum class Constant {
+        Number,
+        String
+    };
+    struct ConstantOperands {
+        Constant constant;
+        unsigned words;         // of each operand
+        bool folded;            // the second operand is a folded expression
+    };
+    using ConstantCodes = std::unordered_map<const Code *, ConstantOperands>;
+
+    struct IndexOperand {
+        unsigned offset;
+        unsigned words;
+        uint32_t count;
+    };
+    struct ComponentCode {
+        const Code *code;
+        unsigned offset;                    // of its operands
+    };
+    // a code has at most two index operands (a folded constant) and a fused code has two codes
+    // (which may be fused codes), an image with a code that has more is not opened
+    static constexpr unsigned MaximumIndexOperands = 4;
+    static constexpr unsigned MaximumComponentCodes = 4;
+    struct OperandChecks {
+        const Code *code;                   // or null if the code does not exist
+        unsigned operand_count;
+        unsigned index_operand_count;
+        IndexOperand index_operands[MaximumIndexOperands];
+        unsigned component_count;           // the codes executed in order
+        ComponentCode components[MaximumComponentCodes];
+    };
+    using DataTypeStack = std::vector<DataType>;
+
+    static ConstantCodes constantCodes();
+    void addOperandChecks(OperandChecks &checks, const Code &code, unsigned offset) const;
+    const OperandChecks &checkInstruction(const WordType *word, const WordType *end) const;
+    static void checkOperands(const OperandChecks &checks, const WordType *operands);
+    static void checkDataTypes(const ComponentCode &component, const WordType *operands,
+        DataTypeStack &stack);
+    static void popDataType(DataTypeStack &stack, DataType data_type);
+
+    uint32_t number_count;
+    uint32_t string_count;
+    uint32_t folded_expression_count;
+    std::vector<OperandChecks> code_checks;     // for each saved code value
+};
+
+
+using CodeNames = std::unordered_map<std::string, Code *>;
+
+CodeNames codeNames();
+void loadCode(ProgramCode &program_code, const WordType *code, uint32_t code_size,
+    const std::vector<Code *> &codes);
+void checkLineInfo(const uint32_t *line_info, uint32_t line_count, uint32_t code_size);
+void checkOffsets(const uint32_t *offsets, uint32_t count);
+std::string getString(const uint32_t *offsets, const char *characters, uint32_t index);
+
+// ----------------------------------------
+
+// FNV-1a
+uint64_t ProgramImage::hashSource(const std::string &source)
+{
+    return hashSource(source.data(), source.size());
+}
+
+uint64_t ProgramImage::hashSource(const char *source, std::size_t size)
+{
+    uint64_t hash = 0xcbf29ce484222325;
+    for (auto end = source + size; source != end; ++source) {
+        hash = (hash ^ static_cast<unsigned char>(*source)) * 0x100000001b3;
+    }
+    return hash;
+}
+
+void ProgramImage::save(std::ostream &os, const ProgramUnit &program, uint64_t source_hash)
+{
+    auto &const_num_dictionary = program.const_num_dictionary;
+    auto &const_str_dictionary = program.const_str_dictionary;
+
+    ImageWriter writer {os};
+    writer.write(ImageMagic);
+    writer.write(Version);
+    writer.write(source_hash);
+    writer.write<uint32_t>(sizeof(WordType));
+    writer.write<uint32_t>(program.constant_folding);
+    writer.write<uint32_t>(Code::getCodeCount());
+    writer.write<uint32_t>(program.code.size());
+    writer.write<uint32_t>(program.line_info.size());
+    writer.write<uint32_t>(program.code.maximumStackDepth());
+    writer.write<uint32_t>(program.folded_code.size());
+    writer.write<uint32_t>(program.folded_expression_info.size());
+    writer.write<uint32_t>(const_num_dictionary.size());
+    writer.write<uint32_t>(const_str_dictionary.size());
+
+    writer.writeCodeNames();
+    writer.writeCode(program.code);
+    writer.writeLineInfo(program.line_info);
+    writer.writeCode(program.folded_code);
+    writer.writeLineInfo(program.folded_expression_info);
+    writer.writeArray(const_num_dictionary.getDblValues(), const_num_dictionary.size());
+    writer.writeArray(const_num_dictionary.getIntValues(), const_num_dictionary.size());
+    writer.writeStrings(const_num_dictionary);
+    writer.writeStrings(const_str_dictionary);
+}
+
+// the program is only changed if the image is valid for the source and the compile options,
+// which are not changed (the constant folding option must be set before loading)
+bool ProgramImage::load(std::istream &is, ProgramUnit &program, uint64_t source_hash)
+{
+    std::vector<char> contents {std::istreambuf_iterator<char> {is},
+        std::istreambuf_iterator<char> {}};
+    ProgramImage image {contents.data(), contents.size()};
+    return image.open(source_hash, program.constant_folding) && image.load(program);
+}
+
+// ----------------------------------------
+
+ProgramImage::ProgramImage(const char *image, std::size_t size) :
+    image {image},
+    size {size}
+{
+}
+
+// the code is checked so that it can be run where it is, the rest of the contents of the arrays
+// (including the folded code, which is only used to recreate) are checked when loaded into a
+// program unit
+bool ProgramImage::open(uint64_t source_hash, bool constant_folding)
+try
+{
+    ImageReader reader {image, size};
+    if (reader.read<uint32_t>() != ImageMagic || reader.read<uint32_t>() != Version
+            || reader.read<uint64_t>() != source_hash
+            || reader.read<uint32_t>() != sizeof(WordType)
+            || reader.read<uint32_t>() != constant_folding) {
+        return false;
+    }
+    this->constant_folding = constant_folding;
+    auto code_count = reader.read<uint32_t>();
+    code_size = reader.read<uint32_t>();
+    line_count = reader.read<uint32_t>();
+    maximum_stack_depth = reader.read<uint32_t>();
+    folded_code_size = reader.read<uint32_t>();
+    folded_expression_count = reader.read<uint32_t>();
+    number_count = reader.read<uint32_t>();
+    string_count = reader.read<uint32_t>();
+    if (maximum_stack_depth > code_size) {
+        return false;
+    }
+
+    // a saved code that no longer exists is only an error if the program uses it
+    static const CodeNames code_names = codeNames();
+    codes.clear();
+    code_values_match = code_count == Code::getCodeCount();
+    for (unsigned value = 0; value < code_count; ++value) {
+        auto it = code_names.find(reader.readString());
+        auto code = it == code_names.end() ? nullptr : it->second;
+        codes.push_back(code);
+        if (!code || code->getValue() != value) {
+            code_values_match = false;
+        }
+    }
+
+    code = reader.readArray<WordType>(code_size);
+    if (code_size == 0 || code[code_size - 1] >= codes.size()
+            || codes[code[code_size - 1]] != &end_code) {
+        return false;
+    }
+    line_info = reader.readArray<uint32_t>(2 * std::size_t {line_count});
+    folded_code = reader.readArray<WordType>(folded_code_size);
+    folded_expression_info = reader.readArray<uint32_t>(2 * std::size_t {folded_expression_count});
+    dbl_values = reader.readArray<double>(number_count);
+    int_values = reader.readArray<int32_t>(number_count);
+    numbers.offsets = reader.readArray<uint32_t>(number_count + std::size_t {1});
+    numbers.characters = reader.readArray<char>(numbers.offsets[number_count]);
+    strings.offsets = reader.readArray<uint32_t>(string_count + std::size_t {1});
+    strings.characters = reader.readArray<char>(strings.offsets[string_count]);
+    checkOffsets(strings.offsets, string_count);
+
+    // the stack of an executer is sized by the depth the code reaches and not the saved depth
+    CodeChecker checker {codes, number_count, string_count, folded_expression_count};
+    maximum_stack_depth = checker.checkCode(code, code_size, maximum_stack_depth);
+    return true;
+}
+catch (const ImageError &) {
+    return false;
+}
+
+// the image must have been opened
+bool ProgramImage::load(ProgramUnit &program) const
+try
+{
+    ProgramUnit loaded;
+    loaded.constant_folding = constant_folding;
+    loadCode(loaded.code, code, code_size, codes);
+    loaded.code.setMaximumStackDepth(maximum_stack_depth);
+    checkLineInfo(line_info, line_count, code_size - 1);
+    for (unsigned index = 0; index < line_count; ++index) {
+        loaded.line_info.emplace_back(line_info[2 * index], line_info[2 * index + 1]);
+    }
+    CodeChecker checker {codes, number_count, string_count, folded_expression_count};
+    checker.checkFoldedCode(folded_code, folded_code_size);
+    loadCode(loaded.folded_code, folded_code, folded_code_size, codes);
+    checkLineInfo(folded_expression_info, folded_expression_count, folded_code_size);
+    for (unsigned index = 0; index < folded_expression_count; ++index) {
+        loaded.folded_expression_info.emplace_back(folded_expression_info[2 * index],
+            folded_expression_info[2 * index + 1]);
+    }
+
+    for (unsigned index = 0; index < number_count; ++index) {
+        auto number = getString(numbers.offsets, numbers.characters, index);
+        if (loaded.const_num_dictionary.add(number, dbl_values[index], int_values[index])
+                != index) {
+            return false;
+        }
+    }
+    for (unsigned index = 0; index < string_count; ++index) {
+        auto string = getString(strings.offsets, strings.characters, index);
+        if (loaded.const_str_dictionary.add(string) != index) {
+            return false;
+        }
+    }
+
+    program = std::move(loaded);
+    return true;
+}
+catch (const ImageError &) {
+    return false;
+}
+
+// ----------------------------------------
+
+CodeChecker::CodeChecker(const std::vector<Code *> &codes, uint32_t number_count,
+        uint32_t string_count, uint32_t folded_expression_count) :
+    number_count {number_count},
+    string_count {string_count},
+    folded_expression_count {folded_expression_count},
+    code_checks(codes.size(), OperandChecks {nullptr, 0, 0, { }, 0, { }})
+{
+    for (unsigned value = 0; value < codes.size(); ++value) {
+        if (codes[value]) {
+            auto &checks = code_checks[value];
+            checks.code = codes[value];
+            checks.operand_count = codes[value]->getOperandCount();
+            addOperandChecks(checks, *codes[value], 0);
+        }
+    }
+}
+
+// the last word of the code is the end code (checked when the image is opened), which must be
+// an instruction and not an operand; the stack is checked after each code of a fused code since
+// the codes are executed one at a time
+uint32_t CodeChecker::checkCode(const WordType *code, uint32_t code_size,
+    uint32_t maximum_stack_depth) const
+{
+    DataTypeStack stack;
+    std::size_t reached_stack_depth = 0;
+    auto end = code + code_size;
+    auto instruction = end;
+    for (auto word = code; word != end; ++word) {
+        instruction = word;
+        auto &checks = checkInstruction(word, end);
+        checkOperands(checks, word + 1);
+        auto components_end = checks.components + checks.component_count;
+        for (auto component = checks.components; component != components_end; ++component) {
+            checkDataTypes(*component, word + 1, stack);
+            if (stack.size() > maximum_stack_depth) {
+                throw ImageError {};
+            }
+            reached_stack_depth = std::max(reached_stack_depth, stack.size());
+        }
+        word += checks.operand_count;
+    }
+    if (instruction != end - 1) {
+        throw ImageError {};
+    }
+    return reached_stack_depth;
+}
+
+// the folded expressions are only recreated, so the stack is not checked
+void CodeChecker::checkFoldedCode(const WordType *code, uint32_t code_size) const
+{
+    for (auto word = code, end = code + code_size; word != end; ++word) {
+        auto &checks = checkInstruction(word, end);
+        checkOperands(checks, word + 1);
+        word += checks.operand_count;
+    }
+}
+
+CodeChecker::ConstantCodes CodeChecker::constantCodes()
+{
+    return ConstantCodes {
+        {&const_dbl_code, {Constant::Number, 1, false}},
+        {&const_int_code, {Constant::Number, 1, false}},
+        {&const_dbl_long_code, {Constant::Number, LongOperandWords, false}},
+        {&const_int_long_code, {Constant::Number, LongOperandWords, false}},
+        {&folded_dbl_code, {Constant::Number, 1, true}},
+        {&folded_int_code, {Constant::Number, 1, true}},
+        {&folded_dbl_long_code, {Constant::Number, LongOperandWords, true}},
+        {&folded_int_long_code, {Constant::Number, LongOperandWords, true}},
+        {&const_str_code, {Constant::String, 1, false}},
+        {&const_str_long_code, {Constant::String, LongOperandWords, false}},
+        {&folded_str_code, {Constant::String, 1, true}},
+        {&folded_str_long_code, {Constant::String, LongOperandWords, true}}
+    };
+}
+
+// the operands of a fused code are the operands of the first code followed by the operands of
+// the second code
+void CodeChecker::addOperandChecks(OperandChecks &checks, const Code &code, unsigned offset) const
+{
+    if (FusedCode::isFused(code.getValue())) {
+        auto &fused_code = FusedCode::get(code.getValue());
+        auto &first_code = fused_code.getFirstCode();
+        addOperandChecks(checks, first_code, offset);
+        addOperandChecks(checks, fused_code.getSecondCode(),
+            offset + first_code.getOperandCount());
+        return;
+    }
+    if (checks.component_count == MaximumComponentCodes) {
+        throw ImageError {};
+    }
+    checks.components[checks.component_count++] = ComponentCode {&code, offset};
+    static const ConstantCodes constant_codes = constantCodes();
+    auto it = constant_codes.find(&code);
+    if (it != constant_codes.end()) {
+        auto &constant_operands = it->second;
+        auto words = constant_operands.words;
+        if (checks.index_operand_count + 2 > MaximumIndexOperands) {
+            throw ImageError {};
+        }
+        checks.index_operands[checks.index_operand_count++] = IndexOperand {offset, words,
+            constant_operands.constant == Constant::Number ? number_count : string_count};
+        if (constant_operands.folded) {
+            checks.index_operands[checks.index_operand_count++] = IndexOperand {offset + words,
+                words, folded_expression_count};
+        }
+    }
+}
+
+const CodeChecker::OperandChecks &CodeChecker::checkInstruction(const WordType *word,
+    const WordType *end) const
+{
+    if (*word >= code_checks.size() || !code_checks[*word].code) {
+        throw ImageError {};
+    }
+    auto &checks = code_checks[*word];
+    if (checks.operand_count > static_cast<unsigned>(end - word - 1)) {
+        throw ImageError {};
+    }
+    return checks;
+}
+
+// checks the index operands and the number of operands of a chain
+void CodeChecker::checkOperands(const OperandChecks &checks, const WordType *operands)
+{
+    auto end = checks.index_operands + checks.index_operand_count;
+    for (auto index_operand = checks.index_operands; index_operand != end; ++index_operand) {
+        auto operand = operands + index_operand->offset;
+        auto index = index_operand->words == 1 ? operand[0]
+            : longOperand(operand[0], operand[1]);
+        if (index >= index_operand->count) {
+            throw ImageError {};
+        }
+    }
+    auto &code = *checks.code;
+    if (code.hasChainOperand()) {
+        auto operand_count = operands[code.getChainOperandOffset()];
+        if (operand_count < 2 || operand_count > MaximumChainOperands) {
+            throw ImageError {};
+        }
+    }
+}
+
+// the items popped by a chain code are strings, the operand after its number of operands marks
+// which of them are temporary strings
+void CodeChecker::checkDataTypes(const ComponentCode &component, const WordType *operands,
+    DataTypeStack &stack)
+{
+    auto &code = *component.code;
+    auto &data_types = code.getDataTypes();
+    if (code.hasChainOperand()) {
+        auto chain_operand = operands + component.offset + code.getChainOperandOffset();
+        auto operand_count = chain_operand[0];
+        auto temporaries = chain_operand[1];
+        for (auto index = operand_count; index-- > 0; ) {
+            popDataType(stack, isChainOperandTemporary(temporaries, index)
+                ? DataType::TmpStr() : DataType::String());
+        }
+    } else {
+        if (data_types.second_operand) {
+            popDataType(stack, data_types.second_operand);
+        }
+        if (data_types.first_operand) {
+            popDataType(stack, data_types.first_operand);
+        }
+    }
+    if (data_types.result) {
+        stack.push_back(data_types.result);
+    }
+}
+
+void CodeChecker::popDataType(DataTypeStack &stack, DataType data_type)
+{
+    if (stack.empty() || stack.back() != data_type) {
+        throw ImageError {};
+    }
+    stack.pop_back();
+}
+
+// ----------------------------------------
+
+// the names of the fused codes are only set when the fused codes are set up
+CodeNames codeNames()
+{
+    FusedCode::initialize();
+    CodeNames code_names;
+    for (unsigned value = 0; value < Code::getCodeCount(); ++value) {
+        auto code = Code::getCode(value);
+        code_names.emplace(code->getName(), code);
+    }
+    return code_names;
+}
+
+// maps the value of each instruction to the value of the code with the same name,
+// the operands that follow an instruction are not changed (the code was checked when opened)
+void loadCode(ProgramCode &program_code, const WordType *code, uint32_t code_size,
+    const std::vector<Code *> &codes)
+{
+    program_code.resize(0);
+    for (auto word = code; word != code + code_size; ++word) {
+        auto instruction = codes[*word];
+        program_code.emplace_back(*instruction);
+        for (auto operand_count = instruction->getOperandCount(); operand_count > 0;
+                --operand_count) {
+            program_code.emplace_back(*++word);
+        }
+    }
+}
+
+void checkLineInfo(const uint32_t *line_info, uint32_t line_count, uint32_t code_size)
+{
+    for (unsigned index = 0; index < line_count; ++index) {
+        auto offset = line_info[2 * index];
+        auto size = line_info[2 * index + 1];
+        if (offset > code_size || size > code_size - offset) {
+            throw ImageError {};
+        }
+    }
+}
+
+// the string constants are run where they are, so each string must be within the characters
+void checkOffsets(const uint32_t *offsets, uint32_t count)
+{
+    for (unsigned index = 0; index < count; ++index) {
+        if (offsets[index + 1] < offsets[index]) {
+            throw ImageError {};
+        }
+    }
+}
+
+std::string getString(const uint32_t *offsets, const char *characters, uint32_t index)
+{
+    if (offsets[index + 1] < offsets[index]) {
+        throw ImageError {};
+    }
+    return std::string(characters + offsets[index], characters + offsets[index + 1]);
+}
+
+// ----------------------------------------
+
+ImageWriter::ImageWriter(std::ostream &os) :
+    os {os}
+{
+}
+
+void ImageWriter::writeCodeNames()
+{
+    FusedCode::initialize();
+    for (unsigned value = 0; value < Code::getCodeCount(); ++value) {
+        auto &name = Code::getCode(value)->getName();
+        write<uint32_t>(name.size());
+        writeBytes(name.data(), name.size());
+    }
+}
+
+void ImageWriter::writeCode(const ProgramCode &code)
+{
+    std::vector<WordType> words;
+    words.reserve(code.size());
+    for (auto &word : code) {
+        words.push_back(word.operand());
+    }
+    writeArray(words.data(), words.size());
+}
+
+void ImageWriter::writeLineInfo(const std::vector<ProgramUnit::LineInfo> &line_info)
+{
+    std::vector<uint32_t> words;
+    for (auto &info : line_info) {
+        words.push_back(info.offset);
+        words.push_back(info.size);
+    }
+    writeArray(words.data(), words.size());
+}
+
+// the strings are saved as the offsets of each string (and of the end of the last string)
+// followed by the characters of all the strings
+void ImageWriter::writeStrings(const Dictionary &dictionary)
+{
+    std::vector<uint32_t> offsets {0};
+    std::string characters;
+    for (unsigned index = 0; index < dictionary.size(); ++index) {
+        auto string = dictionary.get(index);
+        characters.append(string.data(), string.length());
+        offsets.push_back(characters.size());
+    }
+    writeArray(offsets.data(), offsets.size());
+    writeArray(characters.data(), characters.size());
+}
+
+template <typename T>
+void ImageWriter::writeArray(const T *array, std::size_t count)
+{
+    align();
+    writeBytes(array, count * sizeof(T));
+}
+
+template <typename T>
+void ImageWriter::write(T value)
+{
+    writeBytes(&value, sizeof(value));
+}
+
+void ImageWriter::writeBytes(const void *bytes, std::size_t count)
+{
+    os.write(static_cast<const char *>(bytes), count);
+    offset += count;
+}
+
+void ImageWriter::align()
+{
+    static const char padding[ImageAlignment] { };
+    writeBytes(padding, -offset % ImageAlignment);
+}
+
+// ----------------------------------------
+
+ImageReader::ImageReader(const char *image, std::size_t size) :
+    image {image},
+    size {size}
+{
+}
+
+std::string ImageReader::readString()
+{
+    auto count = read<uint32_t>();
+    auto bytes = readBytes(count);
+    return std::string(bytes, bytes + count);
+}
+
+// the image must be aligned for the arrays to be aligned (as it is when mapped)
+template <typename T>
+const T *ImageReader::readArray(std::size_t count)
+{
+    readBytes(-offset % ImageAlignment);
+    if (count > (size - offset) / sizeof(T)) {
+        throw ImageError {};
+    }
+    return reinterpret_cast<const T *>(readBytes(count * sizeof(T)));
+}
+
+template <typename T>
+T ImageReader::read()
+{
+    T value;
+    std::copy_n(readBytes(sizeof(value)), sizeof(value), reinterpret_cast<char *>(&value));
+    return value;
+}
+
+const char *ImageReader::readBytes(std::size_t count)
+{
+    if (count > size - offset) {
+        throw ImageError {};
+    }
+    auto bytes = image + offset;
+    offset += count;
+    return bytes;
+}
@@ -0,0 +1,117 @@
+/* vim:ts=4:sw=4:et:sts=4:
+ *
+ * Copyright 2016 Thunder422.  All rights reserved.
+ * Distributed under GNU General Public License Version 3
+ * (See accompanying file LICENSE or <http://www.gnu.org/licenses/>)
+ */
+
+#ifndef IBC_PROGRAMIMAGE_H
+#define IBC_PROGRAMIMAGE_H
+
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "wordtype.h"
+
+
+class Code;
+class ProgramUnit;
+
+// a compiled program saved so that it can be loaded instead of compiling the source again,
+// the image contains the hash of the source so that it is only loaded for the same source;
+// code values are saved with the name of each code and are mapped to the values of the
+// loading program since the values depend on the order of static initialization
+
+// the code, the numeric constants and the string constants (the characters and the offsets of
+// each string like a dictionary) are arrays in the image (aligned for their type) so that the
+// program can be run where the image is in memory when the code values are the same
+
+class ProgramImage {
+public:
+    static const uint32_t Version = 2;
+
+    static uint64_t hashSource(const std::string &source);
+    static uint64_t hashSource(const char *source, std::size_t size);
+    static void save(std::ostream &os, const ProgramUnit &program, uint64_t source_hash);
+    static bool load(std::istream &is, ProgramUnit &program, uint64_t source_hash);
+
+    ProgramImage(const char *image, std::size_t size);
+    bool open(uint64_t source_hash, bool constant_folding);
+    bool load(ProgramUnit &program) const;
+    bool codeValuesMatch() const;
+    const WordType *getCode() const;
+    unsigned getMaximumStackDepth() const;
+    const double *getDblValues() const;
+    const int32_t *getIntValues() const;
+    const char *getStrCharacters() const;
+    const uint32_t *getStrOffsets() const;
+
+private:
+    struct Strings {
+        const uint32_t *offsets;
+        const char *characters;
+    };
+
+    const char *image;
+    std::size_t size;
+    bool constant_folding {false};
+    std::vector<Code *> codes;
+    bool code_values_match {false};
+    const WordType *code;
+    uint32_t code_size;
+    const uint32_t *line_info;
+    uint32_t line_count;
+    uint32_t maximum_stack_depth;
+    const WordType *folded_code;
+    uint32_t folded_code_size;
+    const uint32_t *folded_expression_info;
+    uint32_t folded_expression_count;
+    const double *dbl_values;
+    const int32_t *int_values;
+    Strings numbers;
+    uint32_t number_count;
+    Strings strings;
+    uint32_t string_count;
+};
+
+
+inline bool ProgramImage::codeValuesMatch() const
+{
+    return code_values_match;
+}
+
+inline const WordType *ProgramImage::getCode() const
+{
+    return code;
+}
+
+inline unsigned ProgramImage::getMaximumStackDepth() const
+{
+    return maximum_stack_depth;
+}
+
+inline const double *ProgramImage::getDblValues() const
+{
+    return dbl_values;
+}
+
+inline const int32_t *ProgramImage::getIntValues() const
+{
+    return int_values;
+}
+
+inline const char *ProgramImage::getStrCharacters() const
+{
+    return strings.characters;
+}
+
+inline const uint32_t *ProgramImage::getStrOffsets() const
+{
+    return strings.offsets;
+}
+
+
+#endif  // IBC_PROGRAMIMAGE_H
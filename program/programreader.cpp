@@ -26,6 +26,12 @@ WordType ProgramReader::getOperand()
     return (*iterator++).operand();
 }
 
+unsigned ProgramReader::getLongOperand()
+{
+    auto low_word = getOperand();
+    return longOperand(low_word, getOperand());
+}
+
 unsigned ProgramReader::currentOffset() const
 {
     return std::distance(begin_iterator, iterator);
@@ -18,6 +18,7 @@ public:
     ProgramReader(ProgramConstIterator begin, unsigned offset, unsigned size);
     Code *getInstruction();
     WordType getOperand();
+    unsigned getLongOperand();
     unsigned currentOffset() const;
     bool hasMoreCode() const;
 
@@ -6,10 +6,15 @@
  */
 
 #include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iterator>
 #include <sstream>
+#include <utility>
 
 #include "commandcode.h"
 #include "commandcompiler.h"
+#include "compiledprogram.h"
 #include "compileerror.h"
 #include "compiler.h"
 #include "executer.h"
@@ -20,8 +25,26 @@
 #include "runerror.h"
 
 
+extern CommandCode end_code;
+
+// typical lines compile to about a word of code for every two characters of the line
+constexpr std::size_t SourceBytesPerCodeWord = 2;
+
+// the code always ends with the END command so that running the program does not change it,
+// which allows a program to be run by any number of threads at the same time
 ProgramUnit::ProgramUnit()
 {
+    code.emplace_back(end_code);
+}
+
+void ProgramUnit::setConstantFolding(bool enable)
+{
+    constant_folding = enable;
+}
+
+bool ProgramUnit::constantFolding() const
+{
+    return constant_folding;
 }
 
 bool ProgramUnit::compileSource(std::istream &is, std::ostream &os)
@@ -33,24 +56,83 @@ bool ProgramUnit::compileSource(std::istream &is, std::ostream &os)
     return program_errors.empty();
 }
 
+bool ProgramUnit::compileSource(const char *source, std::size_t size, std::ostream &os)
+{
+    auto program_errors = compile(source, size);
+    for (auto &error : program_errors) {
+        error.output(os);
+    }
+    return program_errors.empty();
+}
+
 std::vector<ProgramError> ProgramUnit::compile(std::istream &is)
 {
     std::vector<ProgramError> errors;
     std::string line;
     while (std::getline(is, line)) {
-        try {
-            auto code_line = CommandCompiler::create(line, *this)->compile();
-            appendCodeLine(code_line);
-        }
-        catch (const CompileError &error) {
-            appendEmptyCodeLine();
-            unsigned line_number = line_info.size();
-            errors.emplace_back(error, line_number, line);
+        compileAndAppendLine(line.data(), line.length(), errors);
+    }
+    return errors;
+}
+
+// the lines are compiled where they are in the source (such as a mapped source file) without
+// being copied, the lines are separated the same as by getline (a newline at the end of the
+// source does not start another line)
+std::vector<ProgramError> ProgramUnit::compile(const char *source, std::size_t size)
+{
+    reserveForSource(source, size);
+    std::vector<ProgramError> errors;
+    auto end = source + size;
+    for (auto line = source; line != end;) {
+        auto line_end = static_cast<const char *>(std::memchr(line, '\n', end - line));
+        if (!line_end) {
+            line_end = end;
         }
+        compileAndAppendLine(line, line_end - line, errors);
+        line = line_end == end ? end : line_end + 1;
     }
     return errors;
 }
 
+void ProgramUnit::compileAndAppendLine(const char *line, std::size_t length,
+    std::vector<ProgramError> &errors)
+{
+    try {
+        appendCodeLine(compileLine(line, length));
+    }
+    catch (const CompileError &error) {
+        appendEmptyCodeLine();
+        unsigned line_number = line_info.size();
+        errors.emplace_back(error, line_number, std::string {line, length});
+    }
+}
+
+// the program is sized before compiling so that it does not grow a line at a time, the line
+// count is exact while the code size is estimated from the size of the source
+void ProgramUnit::reserveForSource(const char *source, std::size_t size)
+{
+    auto line_count = std::count(source, source + size, '\n') + 1;
+    auto code_size = size / SourceBytesPerCodeWord;
+    line_info.reserve(line_info.size() + line_count);
+    code.reserve(code.size() + code_size);
+}
+
+// the line is compiled into the buffers of the unit (the code line returned is only valid
+// until the next line is compiled), so once the buffers have grown to the size of the lines
+// being compiled, compiling a line does not allocate memory (other than for new constants);
+// the folded expressions of a compiled line that was not appended are no longer used
+ProgramCode &ProgramUnit::compileLine(const char *line, std::size_t length)
+{
+    if (!compiled_line_appended) {
+        discardFoldedExpressions(compiled_line_folded_count);
+    }
+    compiled_line_folded_count = folded_expression_info.size();
+    compiled_line_appended = false;
+    Compiler compiler {line, length, *this};
+    CommandCompiler::compile(compiler);
+    return compiler_buffers.code_line;
+}
+
 void ProgramUnit::appendEmptyCodeLine()
 {
     ProgramCode empty_line;
@@ -59,13 +141,34 @@ void ProgramUnit::appendEmptyCodeLine()
 
 void ProgramUnit::appendCodeLine(ProgramCode &code_line)
 {
+    code.pop_back();
     line_info.emplace_back(code.size(), code_line.size());
     code.append(code_line);
+    code.emplace_back(end_code);
+    compiled_line_appended = true;
+}
+
+// replaces common sequences of codes in each line with fused codes
+void ProgramUnit::fuseCode()
+{
+    unsigned fused_offset = 0;
+    for (auto &info : line_info) {
+        auto fused_size = code.fuseInstructions(info.offset, info.size, fused_offset);
+        info = LineInfo {fused_offset, fused_size};
+        fused_offset += fused_size;
+    }
+    code.resize(fused_offset);
+    code.emplace_back(end_code);
 }
 
-void ProgramUnit::recreate(std::ostream &os)
+unsigned ProgramUnit::lineCount() const
 {
-    for (unsigned line_index = 0; line_index < line_info.size(); ++line_index) {
+    return line_info.size();
+}
+
+void ProgramUnit::recreate(std::ostream &os) const
+{
+    for (unsigned line_index = 0; line_index < lineCount(); ++line_index) {
         os << recreateLine(line_index) << std::endl;
     }
 }
@@ -82,79 +185,56 @@ ProgramReader ProgramUnit::createProgramReader(unsigned line_index) const
     return ProgramReader {code.begin(), info.offset, info.size};
 }
 
-class ProgramEndGuard {
-public:
-    ProgramEndGuard(ProgramCode &code);
-    ~ProgramEndGuard();
-
-private:
-    ProgramCode &code;
-};
-
-bool ProgramUnit::runCode(std::ostream &os) noexcept
+bool ProgramUnit::runCode(std::ostream &os, OutputBuffering buffering, Dispatch dispatch) const
+    noexcept
 {
-    try {
-        run(os);
-        return true;
-    }
-    catch (const ProgramError &error) {
-        error.output(os);
+    if (auto error = execute(os, buffering, dispatch)) {
+        generateProgramError(*error).output(os);
         return false;
     }
+    return true;
 }
 
-void ProgramUnit::run(std::ostream &os)
+void ProgramUnit::run(std::ostream &os, OutputBuffering buffering, Dispatch dispatch) const
 {
-    try {
-        execute(os);
-    }
-    catch (const RunError &error) {
-        generateProgramError(error);
+    if (auto error = execute(os, buffering, dispatch)) {
+        throw generateProgramError(*error);
     }
 }
 
-void ProgramUnit::generateProgramError(const RunError &error)
+CompiledProgram ProgramUnit::seal() &&
 {
-    if (error.offset >= code.size()) {
-        throw ProgramError {error};
-    } else {
-        auto line_index = lineIndex(error.offset);
-        auto program_line = recreateLine(line_index, error.offset);
-        throw ProgramError {error, line_index + 1, program_line};
-    }
+    return CompiledProgram {std::move(*this)};
 }
 
-void ProgramUnit::execute(std::ostream &os)
+ProgramError ProgramUnit::generateProgramError(const RunError &error) const
 {
-    ProgramEndGuard end_guard {code};
-    auto executer = createExecuter(os);
-    try {
-        executer.run();
-    }
-    catch (const EndOfProgram &) {
-        if (!executer.stackEmpty()) {
-            throw RunError {"BUG: value stack not empty at end of program",
-                executer.currentOffset()};
-        }
+    auto line_index = lineIndex(error.offset);
+    if (line_index == lineCount()) {
+        return ProgramError {error};
+    } else {
+        auto program_line = recreateLine(line_index, error.offset);
+        return ProgramError {error, line_index + 1, program_line};
     }
 }
 
-ProgramEndGuard::ProgramEndGuard(ProgramCode &code) :
-    code {code}
+std::unique_ptr<RunError> ProgramUnit::execute(std::ostream &os, OutputBuffering buffering,
+    Dispatch dispatch) const
 {
-    extern CommandCode end_code;
-    code.emplace_back(end_code);
-}
-
-ProgramEndGuard::~ProgramEndGuard()
-{
-    code.pop_back();
+    auto executer = createExecuter(os, buffering, dispatch);
+    executer.run();
+    if (executer.hasRunError()) {
+        return std::unique_ptr<RunError> {new RunError {executer.getRunError()}};
+    }
+    return nullptr;
 }
 
-Executer ProgramUnit::createExecuter(std::ostream &os) const
+Executer ProgramUnit::createExecuter(std::ostream &os, OutputBuffering buffering,
+    Dispatch dispatch) const
 {
     return Executer {code.getBeginning(), const_num_dictionary.getDblValues(),
-        const_num_dictionary.getIntValues(), const_str_dictionary.getStrValues(), os};
+        const_num_dictionary.getIntValues(), const_str_dictionary.getCharacters(),
+        const_str_dictionary.getOffsets(), code.maximumStackDepth(), os, buffering, dispatch};
 }
 
 ConstNumCodeInfo ProgramUnit::addConstantNumber(bool floating_point, const std::string &number)
@@ -162,32 +242,130 @@ ConstNumCodeInfo ProgramUnit::addConstantNumber(bool floating_point, const std::
     return const_num_dictionary.add(floating_point, number);
 }
 
-bool ProgramUnit::isConstantNumberConvertibleToInteger(WordType index) const
+bool ProgramUnit::isConstantNumberConvertibleToInteger(unsigned index) const
 {
     return const_num_dictionary.convertibleToInteger(index);
 }
 
-std::string ProgramUnit::getConstantNumber(WordType index) const
+StringView ProgramUnit::getConstantNumber(unsigned index) const
 {
     return const_num_dictionary.get(index);
 }
 
-WordType ProgramUnit::addConstantString(const std::string &string)
+unsigned ProgramUnit::addConstantString(const std::string &string)
 {
     return const_str_dictionary.add(string);
 }
 
-std::string ProgramUnit::getConstantString(WordType index) const
+StringView ProgramUnit::getConstantString(unsigned index) const
 {
     return const_str_dictionary.get(index);
 }
 
+Dictionary::MemoryUsage ProgramUnit::getConstantNumberMemoryUsage() const
+{
+    return const_num_dictionary.getMemoryUsage();
+}
+
+Dictionary::MemoryUsage ProgramUnit::getConstantStringMemoryUsage() const
+{
+    return const_str_dictionary.getMemoryUsage();
+}
+
+// executes the instructions of an expression of constants, the result is added to the
+// constant dictionary unless the expression caused a run error, which is left for run time
+// (the expression is also left when the dictionary is full)
+ProgramUnit::ConstantEntry ProgramUnit::evaluateConstantExpression(const ProgramCode &code_line,
+    unsigned offset, unsigned instruction_count, DataType data_type)
+{
+    auto &executer = foldingExecuter(code_line.getBeginning() + offset, instruction_count);
+    for (; instruction_count > 0 && executer.isRunning(); --instruction_count) {
+        executer.executeOneCode();
+    }
+    if (executer.hasRunError()) {
+        return ConstantEntry {0, false};
+    }
+    try {
+        return addConstantResult(executer, data_type);
+    }
+    catch (const Dictionary::FullError &) {
+        return ConstantEntry {0, false};
+    }
+}
+
+Executer &ProgramUnit::foldingExecuter(const WordType *code, unsigned stack_size)
+{
+    auto &folding_executer = compiler_buffers.folding_executer;
+    if (!folding_executer) {
+        folding_executer.reset(new FoldingExecuter {stack_size});
+    }
+    auto &executer = folding_executer->executer;
+    executer.setCode(code, const_num_dictionary.getDblValues(),
+        const_num_dictionary.getIntValues(), const_str_dictionary.getCharacters(),
+        const_str_dictionary.getOffsets(), stack_size);
+    return executer;
+}
+
+ProgramUnit::ConstantEntry ProgramUnit::addConstantResult(Executer &executer, DataType data_type)
+{
+    if (data_type.isDouble()) {
+        auto value = executer.topDbl();
+        if (!std::isfinite(value)) {
+            return ConstantEntry {0, false};
+        }
+        return ConstantEntry {const_num_dictionary.add(value), true};
+    } else if (data_type.isInteger()) {
+        return ConstantEntry {const_num_dictionary.add(executer.topInt()), true};
+    } else if (data_type.isTmpStr()) {
+        auto string = executer.moveTopTmpStr();
+        return ConstantEntry {const_str_dictionary.add(*string), true};
+    } else {
+        return ConstantEntry {const_str_dictionary.add(executer.topStr()), true};
+    }
+}
+
+unsigned ProgramUnit::addFoldedExpression(ProgramConstIterator begin, ProgramConstIterator end)
+{
+    unsigned index = folded_expression_info.size();
+    folded_expression_info.emplace_back(folded_code.size(), std::distance(begin, end));
+    for (auto word = begin; word != end; ++word) {
+        folded_code.emplace_back(*word);
+    }
+    return index;
+}
+
+void ProgramUnit::discardFoldedExpressions(unsigned count)
+{
+    if (count < folded_expression_info.size()) {
+        folded_code.resize(folded_expression_info[count].offset);
+        folded_expression_info.erase(folded_expression_info.begin() + count,
+            folded_expression_info.end());
+    }
+}
+
+ProgramReader ProgramUnit::createFoldedExpressionReader(unsigned index) const
+{
+    auto &info = folded_expression_info[index];
+    return ProgramReader {folded_code.begin(), info.offset, info.size};
+}
+
+// the line offsets are in ascending order, so the line is the last one starting at or before
+// the offset (lines without code start at the same offset as the next line);
+// returns the line count if the offset is not within any line
 unsigned ProgramUnit::lineIndex(unsigned offset) const
 {
-    auto find_offset = [offset](LineInfo line_info) {
-        return offset >= line_info.offset && offset < line_info.offset + line_info.size;
+    auto offset_before = [](unsigned offset, const LineInfo &info) {
+        return offset < info.offset;
     };
 
-    auto it = std::find_if(line_info.begin(), line_info.end(), find_offset);
-    return std::distance(line_info.cbegin(), it);
+    auto it = std::upper_bound(line_info.begin(), line_info.end(), offset, offset_before);
+    if (it == line_info.begin() || offset >= std::prev(it)->offset + std::prev(it)->size) {
+        return lineCount();
+    }
+    return std::distance(line_info.begin(), it) - 1;
+}
+
+ProgramUnit::LineInfo ProgramUnit::getLineInfo(unsigned line_index) const
+{
+    return line_info[line_index];
 }
@@ -8,57 +8,98 @@
 #ifndef IBC_PROGRAMMODEL_H
 #define IBC_PROGRAMMODEL_H
 
+#include <memory>
 #include <string>
 
+#include "compilerbuffers.h"
 #include "constnum.h"
 #include "conststr.h"
+#include "executer.h"
 #include "programcode.h"
 
 
+class CompiledProgram;
 struct CompileError;
 struct ProgramError;
 struct RunError;
-class Executer;
 class ProgramReader;
 
 class ProgramUnit {
 public:
+    struct ConstantEntry {
+        unsigned operand;
+        bool valid;
+    };
+
+    struct LineInfo {
+        LineInfo(unsigned offset, unsigned size);
+
+        unsigned offset;
+        unsigned size;
+    };
+
     ProgramUnit();
 
     bool compileSource(std::istream &is, std::ostream &os);
+    bool compileSource(const char *source, std::size_t size, std::ostream &os);
     std::vector<ProgramError> compile(std::istream &is);
+    std::vector<ProgramError> compile(const char *source, std::size_t size);
+    ProgramCode &compileLine(const char *line, std::size_t length);
     void appendCodeLine(ProgramCode &code_line);
-    void recreate(std::ostream &os);
+    void fuseCode();
+    unsigned lineCount() const;
+    unsigned lineIndex(unsigned offset) const;
+    LineInfo getLineInfo(unsigned line_index) const;
+    ProgramReader createProgramReader(unsigned line_index) const;
+    void recreate(std::ostream &os) const;
     std::string recreateLine(unsigned line_index, unsigned error_offset = -1) const;
-    bool runCode(std::ostream &os) noexcept;
-    void run(std::ostream &os);
-    Executer createExecuter(std::ostream &os) const;
+    bool runCode(std::ostream &os, OutputBuffering buffering = OutputBuffering::Line,
+        Dispatch dispatch = Dispatch::Labels) const noexcept;
+    void run(std::ostream &os, OutputBuffering buffering = OutputBuffering::Line,
+        Dispatch dispatch = Dispatch::Labels) const;
+    Executer createExecuter(std::ostream &os, OutputBuffering buffering = OutputBuffering::Line,
+        Dispatch dispatch = Dispatch::Labels) const;
+    CompiledProgram seal() &&;
+    ProgramError generateProgramError(const RunError &error) const;
+    void setConstantFolding(bool enable);
+    bool constantFolding() const;
 
     ConstNumCodeInfo addConstantNumber(bool floating_point, const std::string &number);
-    bool isConstantNumberConvertibleToInteger(WordType index) const;
-    std::string getConstantNumber(WordType index) const;
-    WordType addConstantString(const std::string &string);
-    std::string getConstantString(WordType index) const;
+    bool isConstantNumberConvertibleToInteger(unsigned index) const;
+    StringView getConstantNumber(unsigned index) const;
+    unsigned addConstantString(const std::string &string);
+    StringView getConstantString(unsigned index) const;
+    Dictionary::MemoryUsage getConstantNumberMemoryUsage() const;
+    Dictionary::MemoryUsage getConstantStringMemoryUsage() const;
+    ConstantEntry evaluateConstantExpression(const ProgramCode &code_line, unsigned offset,
+        unsigned instruction_count, DataType data_type);
+    unsigned addFoldedExpression(ProgramConstIterator begin, ProgramConstIterator end);
+    ProgramReader createFoldedExpressionReader(unsigned index) const;
 
 private:
-    bool compileLine(const std::string &line);
-    void appendEmptyCodeLine();
-    ProgramReader createProgramReader(unsigned line_index) const;
-    void generateProgramError(const RunError &error);
-    void execute(std::ostream &os);
-    unsigned lineIndex(unsigned offset) const;
-
-    struct LineInfo {
-        LineInfo(unsigned offset, unsigned size);
+    friend class Compiler;
+    friend class ProgramImage;
 
-        unsigned offset;
-        unsigned size;
-    };
+    void compileAndAppendLine(const char *line, std::size_t length,
+        std::vector<ProgramError> &errors);
+    void reserveForSource(const char *source, std::size_t size);
+    void appendEmptyCodeLine();
+    void discardFoldedExpressions(unsigned count);
+    std::unique_ptr<RunError> execute(std::ostream &os, OutputBuffering buffering,
+        Dispatch dispatch) const;
+    Executer &foldingExecuter(const WordType *code, unsigned stack_size);
+    ConstantEntry addConstantResult(Executer &executer, DataType data_type);
 
     std::vector<LineInfo> line_info;
     ProgramCode code;
     ConstNumDictionary const_num_dictionary;
     ConstStrDictionary const_str_dictionary;
+    bool constant_folding {false};
+    std::vector<LineInfo> folded_expression_info;
+    ProgramCode folded_code;
+    unsigned compiled_line_folded_count {0};   // folded expressions before the compiled line
+    bool compiled_line_appended {true};
+    CompilerBuffers compiler_buffers;
 };
 
 
@@ -0,0 +1,156 @@
+/* vim:ts=4:sw=4:et:sts=4:
+ *
+ * Copyright 2016 Thunder422.  All rights reserved.
+ * Distributed under GNU General Public License Version 3
+ * (See accompanying file LICENSE or <http://www.gnu.org/licenses/>)
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+#include <sstream>
+#include <string>
+
+#include "catch.hpp"
+#include "commandcompiler.h"
+#include "compiler.h"
+#include "executer.h"
+#include "programcode.h"
+#include "programerror.h"
+#include "programunit.h"
+#include "support.h"
+
+
+// the global allocation functions are replaced (for the library too) to count allocations
+
+unsigned allocation_count = 0;
+
+void *operator new(std::size_t size)
+{
+    ++allocation_count;
+    if (auto memory = std::malloc(size == 0 ? 1 : size)) {
+        return memory;
+    }
+    throw std::bad_alloc {};
+}
+
+void operator delete(void *memory) noexcept
+{
+    std::free(memory);
+}
+
+unsigned countCompileLineAllocations(ProgramUnit &program, const std::string &line)
+{
+    auto count = allocation_count;
+    program.compileLine(line.data(), line.length());
+    return allocation_count - count;
+}
+
+
+TEST_CASE("compile lines without allocating memory", "[allocation]")
+{
+    std::string lines[] = {
+        "PRINT ABS(-12) + SGN(3) * INT(2.5) - 7 \\ 7 ^ 2",
+        "print sqr(16) / cos(1.5) + sin(0.5) - atn(1) + frac(2.5) + rnd(10) + rnd",
+        "PRINT (12 < 500) AND (12 >= 2) OR NOT 12 <> 7 XOR 1 EQV 0 IMP 1",
+        "Print 12 Mod 7 = 1 Or Fix(12) <= 3",
+        "PRINT \"a string constant that is too long for a short string\" + \"more\"",
+        "PRINT",
+        ""
+    };
+
+    SECTION("compiling the same lines again does not allocate")
+    {
+        ProgramUnit program;
+        for (auto &line : lines) {
+            program.compileLine(line.data(), line.length());
+        }
+        for (auto &line : lines) {
+            INFO("line: " << line);
+            REQUIRE(countCompileLineAllocations(program, line) == 0);
+        }
+    }
+    SECTION("compiling the same lines again with constant folding does not allocate")
+    {
+        ProgramUnit program;
+        program.setConstantFolding(true);
+        for (auto &line : lines) {
+            program.compileLine(line.data(), line.length());
+        }
+        for (auto &line : lines) {
+            INFO("line: " << line);
+            REQUIRE(countCompileLineAllocations(program, line) == 0);
+        }
+
+        ProgramUnit unfolded_program;
+        auto &line = lines[0];
+        auto unfolded_size = unfolded_program.compileLine(line.data(), line.length()).size();
+        REQUIRE(program.compileLine(line.data(), line.length()).size() < unfolded_size);
+    }
+    SECTION("compiling other lines with the same constants does not allocate")
+    {
+        ProgramUnit program;
+        for (auto &line : lines) {
+            program.compileLine(line.data(), line.length());
+        }
+        REQUIRE(countCompileLineAllocations(program, "PRINT 2.5 * 12 - 7 ^ 3 + INT(16)") == 0);
+        REQUIRE(countCompileLineAllocations(program, "PRINT \"more\" + \"more\"") == 0);
+    }
+    SECTION("new constants are allocated (the allocations are counted)")
+    {
+        ProgramUnit program;
+        REQUIRE(countCompileLineAllocations(program, "PRINT 123") > 0);
+        REQUIRE(countCompileLineAllocations(program, "PRINT 123") == 0);
+    }
+    SECTION("the code of the line is the same as the code compiled with a command compiler")
+    {
+        ProgramUnit program;
+        for (auto &line : lines) {
+            auto &code_line = program.compileLine(line.data(), line.length());
+            Compiler compiler {line, program};
+            CommandCompiler::compile(compiler);
+            auto expected_code_line = compiler.getCodeLine();
+            REQUIRE(code_line.size() == expected_code_line.size());
+            REQUIRE(std::equal(code_line.begin(), code_line.end(), expected_code_line.begin(),
+                [](const ProgramWord &word1, const ProgramWord &word2) {
+                    return word1.operand() == word2.operand();
+                }));
+            REQUIRE(code_line.maximumStackDepth() == expected_code_line.maximumStackDepth());
+        }
+    }
+}
+
+TEST_CASE("run lines with short temporary strings without allocating memory", "[allocation]")
+{
+    std::istringstream iss {
+        R"(PRINT "ab"+"cd")" "\n"
+        R"(PRINT "ab"+("cd"+"ef")+"gh"+("ij"+"kl"))" "\n"
+        R"(PRINT "ab"+"cd" < "ab"+"ce")" "\n"
+        R"(PRINT ("a"+"b") < ("a"+"c"))" "\n"
+        "END"
+    };
+    ProgramUnit program;
+    program.compile(iss);
+    std::ostringstream oss;
+    auto executer = program.createExecuter(oss, OutputBuffering::Line, test_dispatch);
+
+    SECTION("the temporary strings of the first run are not allocated")
+    {
+        executer.run();
+
+        REQUIRE(oss.str() == "abcd\nabcdefghijkl\n-1\n-1\n");
+        REQUIRE(executer.getStringPoolStatistics().misses == 0);
+    }
+    SECTION("the next run does not allocate (the output buffer is allocated by the first run)")
+    {
+        executer.run();
+        std::ostream null_os {nullptr};
+        executer.setOutput(null_os, OutputBuffering::Full);
+
+        auto count = allocation_count;
+        executer.run();
+        auto run_allocation_count = allocation_count - count;
+
+        REQUIRE(run_allocation_count == 0);
+    }
+}
@@ -3,6 +3,26 @@
 // this is a separate file because it takes a while to compile, so to speed up
 // development of the test program, it is a separate source file so that it
 // only needs to be compiled once
+//
+// the tests are run once for each executer dispatch
 
-#define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_RUNNER
 #include "catch.hpp"
+#include "support.h"
+
+
+Dispatch test_dispatch;
+
+int main(int argc, char *argv[])
+{
+    Catch::Session session;
+    auto result = session.applyCommandLine(argc, argv);
+    if (result != 0) {
+        return result;
+    }
+    for (auto dispatch : {Dispatch::Table, Dispatch::Labels}) {
+        test_dispatch = dispatch;
+        result += session.run();
+    }
+    return result;
+}
@@ -5,6 +5,9 @@
  * (See accompanying file LICENSE or <http://www.gnu.org/licenses/>)
  */
 
+#include <cctype>
+#include <cstring>
+
 #include "catch.hpp"
 #include "cistring.h"
 
@@ -90,3 +93,109 @@ TEST_CASE("test case insensitive string class", "[test]")
         REQUIRE(cs == "Test");
     }
 }
+
+TEST_CASE("test case insensitive string view class", "[view]")
+{
+    SECTION("view of part of a line compares to c-style strings")
+    {
+        std::string line {"PRINT abs(-2)"};
+        ci_string_view word {line.data() + 6, 3};
+
+        REQUIRE(word == "ABS");
+        REQUIRE(word == "Abs");
+        REQUIRE(word != "AB");
+        REQUIRE(word != "ABSX");
+        REQUIRE(word.front() == 'a');
+        REQUIRE(word.length() == 3);
+    }
+    SECTION("empty view")
+    {
+        ci_string_view word;
+
+        REQUIRE(word.empty());
+        REQUIRE(word == "");
+        REQUIRE(word != "A");
+    }
+    SECTION("view of a case insensitive string")
+    {
+        ci_string string {"End"};
+        ci_string_view word {string};
+
+        REQUIRE(word == "END");
+        REQUIRE(word.data() == string.data());
+    }
+    SECTION("a case sensitive view of the same characters")
+    {
+        std::string line {"PRINT abs(-2)"};
+        ci_string_view word {line.data() + 6, 3};
+        StringView case_word {line.data() + 6, 3};
+
+        REQUIRE(case_word == "abs");
+        REQUIRE(case_word != "ABS");
+        REQUIRE((word == ci_string_view {"ABS", 3}));
+        REQUIRE(case_word.str() == "abs");
+        REQUIRE(word.str() == "ABS");
+    }
+}
+
+TEST_CASE("test ASCII case conversion of case insensitive strings", "[ascii]")
+{
+    SECTION("only upper case ASCII letters are converted")
+    {
+        for (int i = 0; i < 256; ++i) {
+            auto c = static_cast<char>(i);
+            auto expected = c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+            INFO("character " << i);
+            REQUIRE(lowerCase(c) == expected);
+        }
+    }
+    SECTION("eight characters are converted the same as each character")
+    {
+        for (int i = 0; i < 256; i += 8) {
+            char characters[8];
+            for (int j = 0; j < 8; ++j) {
+                characters[j] = static_cast<char>(i + j);
+            }
+            uint64_t word;
+            std::memcpy(&word, characters, sizeof(word));
+            word = lowerCase8(word);
+            std::memcpy(characters, &word, sizeof(word));
+            for (int j = 0; j < 8; ++j) {
+                INFO("character " << i + j);
+                REQUIRE(characters[j] == lowerCase(static_cast<char>(i + j)));
+            }
+        }
+    }
+    SECTION("comparisons of long strings are case insensitive at every position")
+    {
+        ci_string string1 {"the Quick brown fox jumps over the lazy dog"};
+        for (std::size_t i = 0; i < string1.length(); ++i) {
+            auto string2 = string1;
+            string2[i] = static_cast<char>(std::toupper(string2[i]));
+            REQUIRE(string1 == string2);
+            string2[i] = '~';
+            REQUIRE(string1 != string2);
+            REQUIRE((string1 < string2) == (string1[i] < '~'));
+        }
+    }
+    SECTION("letters that are not ASCII are not case insensitive")
+    {
+        ci_string string1 {"caf\xc9"};
+        ci_string string2 {"CAF\xe9"};
+
+        REQUIRE(string1 != string2);
+        REQUIRE(string1 < string2);
+    }
+    SECTION("hashes of strings that differ only in case are the same")
+    {
+        std::string string1 {"Rnd"};
+        std::string string2 {"rND"};
+
+        REQUIRE(hashLowerCase(string1.data(), string1.length())
+            == hashLowerCase(string2.data(), string2.length()));
+        REQUIRE(hashLowerCase(string1.data(), string1.length(), 1)
+            != hashLowerCase(string1.data(), string1.length()));
+        REQUIRE(equalLowerCase("Eqv Imp Xor", "EQV imp xOR", 11));
+        REQUIRE_FALSE(equalLowerCase("Eqv Imp Xor", "EQV imp xOX", 11));
+    }
+}
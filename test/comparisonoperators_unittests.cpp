@@ -11,6 +11,7 @@
 #include "operators.h"
 #include "programerror.h"
 #include "programunit.h"
+#include "support.h"
 
 TEST_CASE("compile less than operator expressions", "[lt][compile]")
 {
@@ -122,7 +123,7 @@ TEST_CASE("execute less than operator", "[lt][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "0\n-1\n0\n");
     }
@@ -132,7 +133,7 @@ TEST_CASE("execute less than operator", "[lt][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "0\n-1\n0\n");
     }
@@ -142,7 +143,7 @@ TEST_CASE("execute less than operator", "[lt][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "0\n-1\n0\n");
     }
@@ -152,7 +153,7 @@ TEST_CASE("execute less than operator", "[lt][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "0\n-1\n0\n");
     }
@@ -225,7 +226,7 @@ TEST_CASE("execute greater than operator", "[gt][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "-1\n0\n0\n");
     }
@@ -235,7 +236,7 @@ TEST_CASE("execute greater than operator", "[gt][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "-1\n0\n0\n");
     }
@@ -245,7 +246,7 @@ TEST_CASE("execute greater than operator", "[gt][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "-1\n0\n0\n");
     }
@@ -255,7 +256,7 @@ TEST_CASE("execute greater than operator", "[gt][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "-1\n0\n0\n");
     }
@@ -328,7 +329,7 @@ TEST_CASE("execute less than or equal operator", "[gt][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "0\n-1\n-1\n");
     }
@@ -338,7 +339,7 @@ TEST_CASE("execute less than or equal operator", "[gt][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "0\n-1\n-1\n");
     }
@@ -348,7 +349,7 @@ TEST_CASE("execute less than or equal operator", "[gt][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "0\n-1\n-1\n");
     }
@@ -358,7 +359,7 @@ TEST_CASE("execute less than or equal operator", "[gt][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "0\n-1\n-1\n");
     }
@@ -431,7 +432,7 @@ TEST_CASE("execute greater than or equal operator", "[gt][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "-1\n0\n-1\n");
     }
@@ -441,7 +442,7 @@ TEST_CASE("execute greater than or equal operator", "[gt][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "-1\n0\n-1\n");
     }
@@ -451,7 +452,7 @@ TEST_CASE("execute greater than or equal operator", "[gt][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "-1\n0\n-1\n");
     }
@@ -461,7 +462,7 @@ TEST_CASE("execute greater than or equal operator", "[gt][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "-1\n0\n-1\n");
     }
@@ -574,7 +575,7 @@ TEST_CASE("execute equal to operator", "[eq][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "0\n0\n-1\n");
     }
@@ -584,7 +585,7 @@ TEST_CASE("execute equal to operator", "[eq][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "0\n0\n-1\n");
     }
@@ -594,7 +595,7 @@ TEST_CASE("execute equal to operator", "[eq][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "0\n0\n-1\n");
     }
@@ -604,7 +605,7 @@ TEST_CASE("execute equal to operator", "[eq][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "0\n0\n-1\n");
     }
@@ -677,7 +678,7 @@ TEST_CASE("execute not equal to operator", "[ne][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "-1\n-1\n0\n");
     }
@@ -687,7 +688,7 @@ TEST_CASE("execute not equal to operator", "[ne][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "-1\n-1\n0\n");
     }
@@ -697,7 +698,7 @@ TEST_CASE("execute not equal to operator", "[ne][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "-1\n-1\n0\n");
     }
@@ -707,7 +708,7 @@ TEST_CASE("execute not equal to operator", "[ne][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "-1\n-1\n0\n");
     }
@@ -23,7 +23,7 @@ TEST_CASE("compiling integer constants from a string", "[integers]")
     SECTION("input stream does not contain a constant (caller will determine action)")
     {
         Compiler compiler {"%", program};
-        auto data_type = ConstNumCompiler::create(compiler)->compile();
+        auto data_type = ConstNumCompiler::compile(compiler).data_type;
         auto code_line = compiler.getCodeLine();
         REQUIRE_FALSE(data_type);
         REQUIRE(code_line.size() == 0);
@@ -34,26 +34,26 @@ TEST_CASE("compiling integer constants from a string", "[integers]")
         extern Code const_int_code;
 
         Compiler compiler {"1", program};
-        auto data_type = ConstNumCompiler::create(compiler)->compile();
+        auto data_type = ConstNumCompiler::compile(compiler).data_type;
         REQUIRE_INTEGER_OPERAND("1");
         REQUIRE(code_line[0].instructionCode()->getValue() == const_int_code.getValue());
     }
     SECTION("compile a multiple digit number")
     {
         Compiler compiler {"123", program};
-        auto data_type = ConstNumCompiler::create(compiler)->compile();
+        auto data_type = ConstNumCompiler::compile(compiler).data_type;
         REQUIRE_INTEGER_OPERAND("123");
     }
     SECTION("compile a negative number")
     {
         Compiler compiler {"-234", program};
-        auto data_type = ConstNumCompiler::create(compiler)->compile();
+        auto data_type = ConstNumCompiler::compile(compiler).data_type;
         REQUIRE_INTEGER_OPERAND("-234");
     }
     SECTION("terminate compiling at correct character")
     {
         Compiler compiler {"345+", program};
-        auto data_type = ConstNumCompiler::create(compiler)->compile();
+        auto data_type = ConstNumCompiler::compile(compiler).data_type;
         REQUIRE_INTEGER_OPERAND("345");
         REQUIRE(compiler.peekNextChar() == '+');
     }
@@ -67,19 +67,19 @@ TEST_CASE("compiling floating point constants from a string", "[doubles]")
     SECTION("compile a number with a decimal point")
     {
         Compiler compiler {"0.5", program};
-        auto data_type = ConstNumCompiler::create(compiler)->compile();
+        auto data_type = ConstNumCompiler::compile(compiler).data_type;
         REQUIRE_DOUBLE_OPERAND("0.5");
     }
     SECTION("compile a number with a decimal point at the beginning")
     {
         Compiler compiler {".75", program};
-        auto data_type = ConstNumCompiler::create(compiler)->compile();
+        auto data_type = ConstNumCompiler::compile(compiler).data_type;
         REQUIRE_DOUBLE_OPERAND(".75");
     }
     SECTION("compile a number with a second decimal point (should ignore second one)")
     {
         Compiler compiler {"0.1.", program};
-        auto data_type = ConstNumCompiler::create(compiler)->compile();
+        auto data_type = ConstNumCompiler::compile(compiler).data_type;
         REQUIRE_DOUBLE_OPERAND("0.1");
         REQUIRE(compiler.peekNextChar() == '.');
     }
@@ -88,40 +88,40 @@ TEST_CASE("compiling floating point constants from a string", "[doubles]")
         extern Code const_dbl_code;
 
         Compiler compiler {"1.2", program};
-        auto data_type = ConstNumCompiler::create(compiler)->compile();
+        auto data_type = ConstNumCompiler::compile(compiler).data_type;
         REQUIRE_DOUBLE_OPERAND("1.2");
         REQUIRE(code_line[0].instructionCode()->getValue() == const_dbl_code.getValue());
     }
     SECTION("compile a number with an exponent")
     {
         Compiler compiler {"1e0", program};
-        auto data_type = ConstNumCompiler::create(compiler)->compile();
+        auto data_type = ConstNumCompiler::compile(compiler).data_type;
         REQUIRE_DOUBLE_OPERAND("1e0");
     }
     SECTION("make sure compiling stops before a second 'E'")
     {
         Compiler compiler {"1e0E", program};
-        auto data_type = ConstNumCompiler::create(compiler)->compile();
+        auto data_type = ConstNumCompiler::compile(compiler).data_type;
         REQUIRE_DOUBLE_OPERAND("1e0");
         REQUIRE(compiler.peekNextChar() == 'E');
     }
     SECTION("compile a number with a minus exponent")
     {
         Compiler compiler {"1e-2", program};
-        auto data_type = ConstNumCompiler::create(compiler)->compile();
+        auto data_type = ConstNumCompiler::compile(compiler).data_type;
         REQUIRE_DOUBLE_OPERAND("1e-2");
     }
     SECTION("compile a number with a minus exponent terminated be a minus operator")
     {
         Compiler compiler {"1e-2-", program};
-        auto data_type = ConstNumCompiler::create(compiler)->compile();
+        auto data_type = ConstNumCompiler::compile(compiler).data_type;
         REQUIRE_DOUBLE_OPERAND("1e-2");
         REQUIRE(compiler.peekNextChar() == '-');
     }
     SECTION("compile a number with a plus exponent")
     {
         Compiler compiler {"1e+2", program};
-        auto data_type = ConstNumCompiler::create(compiler)->compile();
+        auto data_type = ConstNumCompiler::compile(compiler).data_type;
         REQUIRE_DOUBLE_OPERAND("1e+2");
     }
 }
@@ -134,16 +134,15 @@ TEST_CASE("handle leading zero of a constant correctly including errors", "[zero
     SECTION("check for an error when a leading zero is not followed by a digit")
     {
         Compiler compiler {"01", program};
-        auto constant_number = ConstNumCompiler::create(compiler);
 
         SECTION("check that the error is thrown")
         {
-            REQUIRE_THROWS_AS(constant_number->compile(), CompileError);
+            REQUIRE_THROWS_AS(ConstNumCompiler::compile(compiler), CompileError);
         }
         SECTION("check the message, column and length of the error thrown")
         {
             try {
-                constant_number->compile();
+                ConstNumCompiler::compile(compiler);
             }
             catch (const CompileError &error) {
                 std::string expected = "expected decimal point after leading zero";
@@ -156,7 +155,7 @@ TEST_CASE("handle leading zero of a constant correctly including errors", "[zero
     SECTION("check compiling ends when followed by a non-period non-digit")
     {
         Compiler compiler {"0-", program};
-        auto data_type = ConstNumCompiler::create(compiler)->compile();
+        auto data_type = ConstNumCompiler::compile(compiler).data_type;
         REQUIRE_INTEGER_OPERAND("0");
         REQUIRE(compiler.peekNextChar() == '-');
     }
@@ -170,16 +169,15 @@ TEST_CASE("handle leading period of a constant correctly including errors", "[pe
     SECTION("check for an error when a leading period is followed by another period")
     {
         Compiler compiler {"..", program};
-        auto constant_number = ConstNumCompiler::create(compiler);
 
         SECTION("check that the error is thrown")
         {
-            REQUIRE_THROWS_AS(constant_number->compile(), CompileError);
+            REQUIRE_THROWS_AS(ConstNumCompiler::compile(compiler), CompileError);
         }
         SECTION("check the message, column and length of the error thrown")
         {
             try {
-                constant_number->compile();
+                ConstNumCompiler::compile(compiler);
             }
             catch (const CompileError &error) {
                 std::string expected = "expected digit after decimal point";
@@ -199,16 +197,15 @@ TEST_CASE("check for correct exponent format", "[exponent]")
     SECTION("check for an error if no sign or digits at the start of an exponent")
     {
         Compiler compiler {"1e.", program};
-        auto constant_number = ConstNumCompiler::create(compiler);
 
         SECTION("check that the error is thrown")
         {
-            REQUIRE_THROWS_AS(constant_number->compile(), CompileError);
+            REQUIRE_THROWS_AS(ConstNumCompiler::compile(compiler), CompileError);
         }
         SECTION("check the message, column and length of the error thrown")
         {
             try {
-                constant_number->compile();
+                ConstNumCompiler::compile(compiler);
             }
             catch (const CompileError &error) {
                 std::string expected = "expected sign or digit for exponent";
@@ -221,23 +218,22 @@ TEST_CASE("check for correct exponent format", "[exponent]")
     SECTION("allow for possible EQV operator ('E' lost, which will be handled by caller)")
     {
         Compiler compiler {"1eq", program};
-        auto data_type = ConstNumCompiler::create(compiler)->compile();
+        auto data_type = ConstNumCompiler::compile(compiler).data_type;
         REQUIRE_INTEGER_OPERAND("1");
         REQUIRE(compiler.peekNextChar() == 'q');
     }
     SECTION("check for an error if there is no digit after an exponent sign")
     {
         Compiler compiler {"1e-A", program};
-        auto constant_number = ConstNumCompiler::create(compiler);
 
         SECTION("check that the error is thrown")
         {
-            REQUIRE_THROWS_AS(constant_number->compile(), CompileError);
+            REQUIRE_THROWS_AS(ConstNumCompiler::compile(compiler), CompileError);
         }
         SECTION("check the message, column and length of the error thrown")
         {
             try {
-                constant_number->compile();
+                ConstNumCompiler::compile(compiler);
             }
             catch (const CompileError &error) {
                 std::string expected = "expected digit after exponent sign";
@@ -250,16 +246,15 @@ TEST_CASE("check for correct exponent format", "[exponent]")
     SECTION("check for an error if terminated by end of the line after an exponent sign")
     {
         Compiler compiler {"1e+", program};
-        auto constant_number = ConstNumCompiler::create(compiler);
 
         SECTION("check that the error is thrown")
         {
-            REQUIRE_THROWS_AS(constant_number->compile(), CompileError);
+            REQUIRE_THROWS_AS(ConstNumCompiler::compile(compiler), CompileError);
         }
         SECTION("check the message, column and length of the error thrown")
         {
             try {
-                constant_number->compile();
+                ConstNumCompiler::compile(compiler);
             }
             catch (const CompileError &error) {
                 REQUIRE(error.column == 3);
@@ -277,7 +272,7 @@ TEST_CASE("look for possible exit conditions", "[exit]")
     SECTION("look for possible negate operator ('-' not followed by '.' or digit)")
     {
         Compiler compiler {"-e", program};
-        auto data_type = ConstNumCompiler::create(compiler)->compile();
+        auto data_type = ConstNumCompiler::compile(compiler).data_type;
         auto code_line = compiler.getCodeLine();
         REQUIRE_FALSE(data_type);
         REQUIRE(code_line.size() == 0);
@@ -285,59 +280,58 @@ TEST_CASE("look for possible exit conditions", "[exit]")
     SECTION("allow a period after a negative sign")
     {
         Compiler compiler {"-.1", program};
-        auto data_type = ConstNumCompiler::create(compiler)->compile();
+        auto data_type = ConstNumCompiler::compile(compiler).data_type;
         REQUIRE_DOUBLE_OPERAND("-.1");
     }
     SECTION("look for negate operator status (false if not negate operator)")
     {
         Compiler compiler {"-1-", program};
-        auto constant_number = ConstNumCompiler::create(compiler);
-        auto data_type = constant_number->compile();
+        auto result = ConstNumCompiler::compile(compiler);
+        auto data_type = result.data_type;
         REQUIRE_INTEGER_OPERAND("-1");
         REQUIRE(compiler.peekNextChar() == '-');
-        REQUIRE_FALSE(constant_number->negateOperator());
+        REQUIRE_FALSE(result.negate_operator);
     }
     SECTION("look for negate operator status (true for negate operator)")
     {
         Compiler compiler {"-e", program};
-        auto constant_number = ConstNumCompiler::create(compiler);
-        auto data_type = constant_number->compile();
+        auto result = ConstNumCompiler::compile(compiler);
+        auto data_type = result.data_type;
         auto code_line = compiler.getCodeLine();
         REQUIRE_FALSE(data_type);
         REQUIRE(compiler.peekNextChar() == 'e');
-        REQUIRE(constant_number->negateOperator());
+        REQUIRE(result.negate_operator);
     }
     SECTION("look for possible operator status (false if no operator starting with 'E')")
     {
         Compiler compiler {"-1e1-", program};
-        auto constant_number = ConstNumCompiler::create(compiler);
-        auto data_type = constant_number->compile();
+        auto result = ConstNumCompiler::compile(compiler);
+        auto data_type = result.data_type;
         REQUIRE_DOUBLE_OPERAND("-1e1");
         REQUIRE(compiler.peekNextChar() == '-');
-        REQUIRE(constant_number->unparsedChar() == 0);
+        REQUIRE(result.unparsed_char == 0);
     }
     SECTION("look for possible operator status (true if 'E' followed by another letter)")
     {
         Compiler compiler {"-1eqv", program};
-        auto constant_number = ConstNumCompiler::create(compiler);
-        auto data_type = constant_number->compile();
+        auto result = ConstNumCompiler::compile(compiler);
+        auto data_type = result.data_type;
         REQUIRE_INTEGER_OPERAND("-1");
         REQUIRE(compiler.peekNextChar() == 'q');
-        REQUIRE(constant_number->unparsedChar() == 'e');
+        REQUIRE(result.unparsed_char == 'e');
     }
     SECTION("check when 'E' character not followed by a another letter throws an error")
     {
         Compiler compiler {"-1e$", program};
-        auto constant_number = ConstNumCompiler::create(compiler);
 
         SECTION("check that the error is thrown")
         {
-            REQUIRE_THROWS_AS(constant_number->compile(), CompileError);
+            REQUIRE_THROWS_AS(ConstNumCompiler::compile(compiler), CompileError);
         }
         SECTION("check the message, column and length of the error thrown")
         {
             try {
-                constant_number->compile();
+                ConstNumCompiler::compile(compiler);
             }
             catch (const CompileError &error) {
                 std::string expected_what = "expected sign or digit for exponent";
@@ -375,7 +369,7 @@ TEST_CASE("check other numeric constants from the IBCP tests", "[other]")
                 Compiler compiler {test.input, program};
 
                 CAPTURE(test.input);
-                REQUIRE_THROWS_AS(ConstNumCompiler::create(compiler)->compile(), CompileError);
+                REQUIRE_THROWS_AS(ConstNumCompiler::compile(compiler), CompileError);
             }
         }
         SECTION("check the message, column and length of the errors thrown")
@@ -385,7 +379,7 @@ TEST_CASE("check other numeric constants from the IBCP tests", "[other]")
 
                 CAPTURE(test.input);
                 try {
-                    ConstNumCompiler::create(compiler)->compile();
+                    ConstNumCompiler::compile(compiler);
                 }
                 catch (const CompileError &error) {
                     REQUIRE(error.what() == test.expected_what);
@@ -398,7 +392,7 @@ TEST_CASE("check other numeric constants from the IBCP tests", "[other]")
     SECTION("miscellaneous test")
     {
         Compiler compiler {"1..", program};
-        auto data_type = ConstNumCompiler::create(compiler)->compile();
+        auto data_type = ConstNumCompiler::compile(compiler).data_type;
         REQUIRE_DOUBLE_OPERAND("1.");
         REQUIRE(compiler.peekNextChar() == '.');
     }
@@ -432,7 +426,7 @@ TEST_CASE("execute a constant code", "[execute]")
         auto code_line = compiler.getCodeLine();
         program.appendCodeLine(code_line);
 
-        auto executer = program.createExecuter(unused_oss);
+        auto executer = program.createExecuter(unused_oss, OutputBuffering::Line, test_dispatch);
         executer.executeOneCode();
         REQUIRE(executer.topInt() == 12345);
     }
@@ -442,7 +436,7 @@ TEST_CASE("execute a constant code", "[execute]")
         auto code_line = compiler.getCodeLine();
         program.appendCodeLine(code_line);
 
-        auto executer = program.createExecuter(unused_oss);
+        auto executer = program.createExecuter(unused_oss, OutputBuffering::Line, test_dispatch);
         executer.executeOneCode();
         REQUIRE(executer.topInt() == 23456);
     }
@@ -453,7 +447,7 @@ TEST_CASE("execute a constant code", "[execute]")
         auto code_line = compiler.getCodeLine();
         program.appendCodeLine(code_line);
 
-        auto executer = program.createExecuter(unused_oss);
+        auto executer = program.createExecuter(unused_oss, OutputBuffering::Line, test_dispatch);
         executer.executeOneCode();
         REQUIRE(executer.topInt() == 12345);
         executer.executeOneCode();
@@ -466,7 +460,7 @@ TEST_CASE("execute a constant code", "[execute]")
         auto code_line = compiler.getCodeLine();
         program.appendCodeLine(code_line);
 
-        auto executer = program.createExecuter(unused_oss);
+        auto executer = program.createExecuter(unused_oss, OutputBuffering::Line, test_dispatch);
         executer.executeOneCode();
         executer.executeOneCode();
         REQUIRE(executer.topInt() == 23456);
@@ -479,7 +473,7 @@ TEST_CASE("execute a constant code", "[execute]")
         auto code_line = compiler.getCodeLine();
         program.appendCodeLine(code_line);
 
-        auto executer = program.createExecuter(unused_oss);
+        auto executer = program.createExecuter(unused_oss, OutputBuffering::Line, test_dispatch);
         executer.executeOneCode();
         REQUIRE(executer.topDbl() == 12.345);
     }
@@ -489,7 +483,7 @@ TEST_CASE("execute a constant code", "[execute]")
         auto code_line = compiler.getCodeLine();
         program.appendCodeLine(code_line);
 
-        auto executer = program.createExecuter(unused_oss);
+        auto executer = program.createExecuter(unused_oss, OutputBuffering::Line, test_dispatch);
         executer.executeOneCode();
         REQUIRE(executer.topDbl() == -2.3456);
     }
@@ -502,7 +496,7 @@ TEST_CASE("execute a constant code", "[execute]")
         auto code_line = compiler.getCodeLine();
         program.appendCodeLine(code_line);
 
-        auto executer = program.createExecuter(unused_oss);
+        auto executer = program.createExecuter(unused_oss, OutputBuffering::Line, test_dispatch);
         executer.executeOneCode();
         REQUIRE(executer.topInt() == 12345);
         executer.executeOneCode();
@@ -521,7 +515,7 @@ TEST_CASE("constant errors", "[errors]")
         extern Code const_dbl_code;
 
         Compiler compiler {"12345678901", program};
-        auto data_type = ConstNumCompiler::create(compiler)->compile();
+        auto data_type = ConstNumCompiler::compile(compiler).data_type;
         REQUIRE_DOUBLE_OPERAND("12345678901")
         REQUIRE(code_line[0].instructionCode()->getValue() == const_dbl_code.getValue());
     }
@@ -532,12 +526,12 @@ TEST_CASE("constant errors", "[errors]")
         Compiler compiler {"1.23e4567", program};
         SECTION("check that error is thrown")
         {
-            REQUIRE_THROWS_AS(ConstNumCompiler::create(compiler)->compile(), CompileError);
+            REQUIRE_THROWS_AS(ConstNumCompiler::compile(compiler), CompileError);
         }
         SECTION("check the message, column and length of the error thrown")
         {
             try {
-                ConstNumCompiler::create(compiler)->compile();
+                ConstNumCompiler::compile(compiler);
             }
             catch (const CompileError &error) {
                 std::string expected = "floating point constant is out of range";
@@ -559,7 +553,7 @@ TEST_CASE("changing a constant from double to integer", "[convert]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "124\n");
     }
@@ -569,7 +563,7 @@ TEST_CASE("changing a constant from double to integer", "[convert]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "-124\n");
     }
@@ -579,7 +573,7 @@ TEST_CASE("changing a constant from double to integer", "[convert]")
         std::ostringstream oss;
 
         program.compileSource(iss, oss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "2147483647\n");
     }
@@ -589,7 +583,7 @@ TEST_CASE("changing a constant from double to integer", "[convert]")
         std::ostringstream oss;
 
         program.compileSource(iss, oss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() ==
             "error on line 1:7: floating point constant is out of range\n"
@@ -603,7 +597,7 @@ TEST_CASE("changing a constant from double to integer", "[convert]")
         std::ostringstream oss;
 
         program.compileSource(iss, oss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "-2147483648\n");
     }
@@ -613,7 +607,7 @@ TEST_CASE("changing a constant from double to integer", "[convert]")
         std::ostringstream oss;
 
         program.compileSource(iss, oss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() ==
             "error on line 1:7: floating point constant is out of range\n"
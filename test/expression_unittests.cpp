@@ -199,7 +199,7 @@ TEST_CASE("check expressions with various operators", "[operator]")
 
         program.compile(iss);
         program.recreate(oss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "PRINT - 2 + 4\n2\n");
     }
@@ -210,7 +210,7 @@ TEST_CASE("check expressions with various operators", "[operator]")
 
         if (program.compileSource(iss, oss)) {
             program.recreate(oss);
-            program.run(oss);
+            program.run(oss, OutputBuffering::Line, test_dispatch);
         }
 
         REQUIRE(oss.str() == "PRINT 2 + NOT -4\n5\n");
@@ -308,3 +308,110 @@ TEST_CASE("parentheses related checks", "[more-parens]")
         );
     }
 }
+
+TEST_CASE("fold constant expressions", "[fold]")
+{
+    ProgramUnit program;
+    program.setConstantFolding(true);
+
+    SECTION("fold an integer expression to a single constant")
+    {
+        Compiler compiler {"2^10*3+1", program};
+        auto data_type = compiler.compileExpression();
+
+        REQUIRE(data_type.isInteger());
+        REQUIRE_CODESIZE_OPERAND(3, "3073");
+    }
+    SECTION("fold a function of a constant")
+    {
+        Compiler compiler {"INT(SQR(2)*100)", program};
+        auto data_type = compiler.compileExpression();
+
+        REQUIRE(data_type.isDouble());
+        REQUIRE_CODESIZE_OPERAND(3, "141");
+    }
+    SECTION("fold a string concatenation to a constant string")
+    {
+        Compiler compiler {R"("ab"+"cd"+"ef")", program};
+        auto data_type = compiler.compileExpression();
+
+        REQUIRE(data_type.isString());
+        auto code_line = compiler.getCodeLine();
+        REQUIRE(code_line.size() == 3);
+        REQUIRE(program.getConstantString(code_line[1].operand()) == "abcdef");
+    }
+    SECTION("do not fold a random function")
+    {
+        Compiler compiler {"RND(10)+1", program};
+        compiler.compileExpression();
+
+        auto code_line = compiler.getCodeLine();
+        REQUIRE(code_line.size() == 6);
+    }
+    SECTION("recreate the original expressions of a folded program")
+    {
+        std::istringstream iss {
+            "PRINT 2^10*3+1\n"
+            "PRINT -(2*4)\n"
+            "PRINT (1+2)*RND(5)\n"
+            "PRINT 3 AND 1.5*2\n"
+            "PRINT \"ab\"+\"cd\"\n"
+        };
+        std::ostringstream oss;
+
+        program.compile(iss);
+        program.recreate(oss);
+
+        REQUIRE(oss.str() ==
+            "PRINT 2 ^ 10 * 3 + 1\n"
+            "PRINT -(2 * 4)\n"
+            "PRINT (1 + 2) * RND(5)\n"
+            "PRINT 3 AND 1.5 * 2\n"
+            "PRINT \"ab\" + \"cd\"\n");
+    }
+    SECTION("run a folded program")
+    {
+        std::istringstream iss {
+            "PRINT 2^10*3+1\n"
+            "PRINT 3 AND 1.5*2\n"
+            "PRINT 1.5*2+SQR(4)\n"
+            "PRINT \"ab\"+\"cd\"=\"abcd\"\n"
+        };
+        std::ostringstream oss;
+
+        program.compile(iss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
+
+        REQUIRE(oss.str() ==
+            "3073\n"
+            "3\n"
+            "5\n"
+            "-1\n");
+    }
+    SECTION("leave an expression with an error to be reported at run time")
+    {
+        std::istringstream iss {"PRINT 2^3+16^8"};
+        std::ostringstream oss;
+
+        program.compile(iss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
+
+        REQUIRE(oss.str() ==
+            "run error at line 1:18: overflow\n"
+            "    PRINT 2 ^ 3 + 16 ^ 8\n"
+            "                     ^\n");
+    }
+    SECTION("leave an overflow converting a folded double to integer for run time")
+    {
+        std::istringstream iss {"PRINT NOT (1E5*1E5)"};
+        std::ostringstream oss;
+
+        program.compile(iss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
+
+        REQUIRE(oss.str() ==
+            "run error at line 1:11: overflow\n"
+            "    PRINT NOT 1E5 * 1E5\n"
+            "              ^^^^^^^^^\n");
+    }
+}
@@ -10,6 +10,7 @@
 #include "operators.h"
 #include "programerror.h"
 #include "programunit.h"
+#include "support.h"
 
 
 TEST_CASE("compile not operator expressions", "[not][compile]")
@@ -85,7 +86,7 @@ TEST_CASE("execute not operator", "[not][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "-3\n");
     }
@@ -101,7 +102,7 @@ TEST_CASE("apply necessary conversions to not operator", "[not][conversion]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "-3\n");
     }
@@ -111,7 +112,7 @@ TEST_CASE("apply necessary conversions to not operator", "[not][conversion]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "-3\n");
     }
@@ -154,7 +155,7 @@ TEST_CASE("apply necessary conversions to not operator", "[not][conversion]")
         }
         SECTION("execute the convert to integer code for a non-constant double operand")
         {
-            program.run(oss);
+            program.run(oss, OutputBuffering::Line, test_dispatch);
 
             REQUIRE(oss.str() == "-3\n");
         }
@@ -165,7 +166,7 @@ TEST_CASE("apply necessary conversions to not operator", "[not][conversion]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() ==
             "run error at line 1:11: overflow\n"
@@ -179,7 +180,7 @@ TEST_CASE("apply necessary conversions to not operator", "[not][conversion]")
         std::ostringstream oss;
 
         program.compileSource(iss, oss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() ==
             "error on line 1:11: expected numeric expression\n"
@@ -253,7 +254,7 @@ TEST_CASE("execute and operator", "[and][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "2\n");
     }
@@ -269,7 +270,7 @@ TEST_CASE("apply necessary conversions to and operator", "[and][conversion]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "2\n");
     }
@@ -279,7 +280,7 @@ TEST_CASE("apply necessary conversions to and operator", "[and][conversion]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "2\n");
     }
@@ -325,7 +326,7 @@ TEST_CASE("execute or operator", "[or][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "15\n");
     }
@@ -371,7 +372,7 @@ TEST_CASE("execute exclusive-or operator", "[xor][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "13\n");
     }
@@ -417,7 +418,7 @@ TEST_CASE("execute equivalence operator", "[eqv][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "-14\n");
     }
@@ -463,7 +464,7 @@ TEST_CASE("execute implication operator", "[imp][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "-9\n");
     }
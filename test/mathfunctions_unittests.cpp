@@ -5,11 +5,15 @@
  * (See accompanying file LICENSE or <http://www.gnu.org/licenses/>)
  */
 
+#include <utility>
+
 #include "catch.hpp"
+#include "compiledprogram.h"
 #include "compileerror.h"
 #include "compiler.h"
 #include "programerror.h"
 #include "programunit.h"
+#include "support.h"
 
 
 TEST_CASE("compile absolute function expressions", "[abs][compile]")
@@ -109,7 +113,7 @@ TEST_CASE("execute abs function expressions", "[abs][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "2.1\n");
     }
@@ -119,7 +123,7 @@ TEST_CASE("execute abs function expressions", "[abs][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "2.1\n");
     }
@@ -129,7 +133,7 @@ TEST_CASE("execute abs function expressions", "[abs][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "2\n");
     }
@@ -139,7 +143,7 @@ TEST_CASE("execute abs function expressions", "[abs][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "2\n");
     }
@@ -149,7 +153,7 @@ TEST_CASE("execute abs function expressions", "[abs][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() ==
             "run error at line 1:7: overflow\n"
@@ -208,7 +212,7 @@ TEST_CASE("execute sign function expressions", "[sgn][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "0\n");
     }
@@ -218,7 +222,7 @@ TEST_CASE("execute sign function expressions", "[sgn][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "1\n");
     }
@@ -228,7 +232,7 @@ TEST_CASE("execute sign function expressions", "[sgn][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "-1\n");
     }
@@ -238,7 +242,7 @@ TEST_CASE("execute sign function expressions", "[sgn][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "0\n");
     }
@@ -248,7 +252,7 @@ TEST_CASE("execute sign function expressions", "[sgn][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "1\n");
     }
@@ -258,7 +262,7 @@ TEST_CASE("execute sign function expressions", "[sgn][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "-1\n");
     }
@@ -304,7 +308,7 @@ TEST_CASE("execute square root function expressions", "[sqr][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "2.5\n");
     }
@@ -314,7 +318,7 @@ TEST_CASE("execute square root function expressions", "[sqr][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() ==
             "run error at line 1:7: square root of negative number\n"
@@ -327,7 +331,7 @@ TEST_CASE("execute square root function expressions", "[sqr][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "25\n");
     }
@@ -373,7 +377,7 @@ TEST_CASE("execute integer function expressions", "[int][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "6\n6\n");
     }
@@ -383,7 +387,7 @@ TEST_CASE("execute integer function expressions", "[int][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "-7\n-7\n");
     }
@@ -417,7 +421,7 @@ TEST_CASE("compile fix function expressions", "[fix]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "6\n6\n");
     }
@@ -427,7 +431,7 @@ TEST_CASE("compile fix function expressions", "[fix]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "-6\n-6\n");
     }
@@ -461,7 +465,7 @@ TEST_CASE("fractional function expressions", "[frac]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "0.01\n0.99\n");
     }
@@ -471,7 +475,7 @@ TEST_CASE("fractional function expressions", "[frac]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "-0.01\n-0.99\n");
     }
@@ -505,7 +509,7 @@ TEST_CASE("cosine function expressions", "[cos]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "0.62161\n");
     }
@@ -539,7 +543,7 @@ TEST_CASE("sine function expressions", "[sin]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "0.783327\n");
     }
@@ -573,7 +577,7 @@ TEST_CASE("tangent function expressions", "[tan]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "1.26016\n");
     }
@@ -607,7 +611,7 @@ TEST_CASE("arctangent function expressions", "[atn]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "0.732815\n");
     }
@@ -641,7 +645,7 @@ TEST_CASE("natural logarithm function expressions", "[log]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "-0.105361\n");
     }
@@ -651,7 +655,7 @@ TEST_CASE("natural logarithm function expressions", "[log]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() ==
             "run error at line 1:7: logarithm of non-positive number\n"
@@ -664,7 +668,7 @@ TEST_CASE("natural logarithm function expressions", "[log]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() ==
             "run error at line 1:7: logarithm of non-positive number\n"
@@ -701,7 +705,7 @@ TEST_CASE("base-e exponential function expressions", "[exp]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "2.4596\n");
     }
@@ -711,7 +715,7 @@ TEST_CASE("base-e exponential function expressions", "[exp]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "0\n");
     }
@@ -721,7 +725,7 @@ TEST_CASE("base-e exponential function expressions", "[exp]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() ==
             "run error at line 1:7: overflow\n"
@@ -799,7 +803,7 @@ TEST_CASE("execute convert to double function expressions", "[cdbl][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "123\n");
     }
@@ -862,7 +866,7 @@ TEST_CASE("execute convert to integer function expressions", "[cint][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "123\n");
     }
@@ -872,7 +876,7 @@ TEST_CASE("execute convert to integer function expressions", "[cint][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "124\n");
     }
@@ -983,7 +987,7 @@ TEST_CASE("execute random function expressions", "[rnd][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         auto numbers = ParseValues<double>(oss);
         REQUIRE(numbers.size() == 1);
@@ -1001,7 +1005,7 @@ TEST_CASE("execute random function expressions", "[rnd][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         auto numbers = ParseValues<double>(oss);
         REQUIRE(numbers.size() == RandomTestCount);
@@ -1022,7 +1026,7 @@ TEST_CASE("execute random function expressions", "[rnd][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         auto numbers = ParseValues<int32_t>(oss);
         REQUIRE(numbers.size() == RandomTestCount);
@@ -1041,13 +1045,53 @@ TEST_CASE("execute random function expressions", "[rnd][execute]")
         REQUIRE(min == 1);
         REQUIRE(max == 10);
     }
+    SECTION("check that every run of a program has the same random numbers")
+    {
+        std::istringstream iss {
+            "PRINT RND\n"
+            "PRINT RND(1000)\n"
+        };
+        program.compile(iss);
+        std::ostringstream oss1;
+        std::ostringstream oss2;
+
+        program.run(oss1, OutputBuffering::Line, test_dispatch);
+        program.run(oss2, OutputBuffering::Line, test_dispatch);
+
+        REQUIRE(oss1.str() == oss2.str());
+    }
+    SECTION("check that the random engine and seed of an executer can be selected")
+    {
+        std::string input;
+        for (int i = 0; i < 10; ++i) {
+            input += "PRINT RND(1000000)\n";
+        }
+        std::istringstream iss {input};
+        program.compile(iss);
+        auto compiled_program = std::move(program).seal();
+        std::ostringstream unused_oss;
+        auto executer = compiled_program.createExecuter(unused_oss, OutputBuffering::Line,
+            test_dispatch);
+        std::ostringstream oss1;
+        std::ostringstream oss2;
+        std::ostringstream oss3;
+
+        executer.setRandomGenerator(RandomEngine::Xoshiro, 42);
+        compiled_program.run(executer, oss1, OutputBuffering::Line, test_dispatch);
+        compiled_program.run(executer, oss2, OutputBuffering::Line, test_dispatch);
+        executer.setRandomGenerator(RandomEngine::Xoshiro, 43);
+        compiled_program.run(executer, oss3, OutputBuffering::Line, test_dispatch);
+
+        REQUIRE(oss1.str() == oss2.str());
+        REQUIRE(oss1.str() != oss3.str());
+    }
     SECTION("check for error when integer argument is zero")
     {
         std::istringstream iss {"PRINT RND(0)"};
         std::ostringstream oss;
 
         program.compile(iss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() ==
             "run error at line 1:7: random function on zero or negative number\n"
@@ -1060,7 +1104,7 @@ TEST_CASE("execute random function expressions", "[rnd][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() ==
             "run error at line 1:7: random function on zero or negative number\n"
@@ -11,6 +11,7 @@
 #include "operators.h"
 #include "programerror.h"
 #include "programunit.h"
+#include "support.h"
 
 
 TEST_CASE("compile negate operator expressions", "[neg][compile]")
@@ -135,7 +136,7 @@ TEST_CASE("execute negate operator expressions", "[neg][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "345\n");
     }
@@ -145,7 +146,7 @@ TEST_CASE("execute negate operator expressions", "[neg][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "-1.345e+210\n");
     }
@@ -155,7 +156,7 @@ TEST_CASE("execute negate operator expressions", "[neg][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "0.00390625\n");
     }
@@ -165,7 +166,7 @@ TEST_CASE("execute negate operator expressions", "[neg][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() ==
             "run error at line 1:7: overflow\n"
@@ -350,7 +351,7 @@ TEST_CASE("execute integer-integer exponential operator", "[exp][int-int]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "9\n");
     }
@@ -360,7 +361,7 @@ TEST_CASE("execute integer-integer exponential operator", "[exp][int-int]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "32\n");
     }
@@ -370,7 +371,7 @@ TEST_CASE("execute integer-integer exponential operator", "[exp][int-int]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "0\n");
     }
@@ -380,7 +381,7 @@ TEST_CASE("execute integer-integer exponential operator", "[exp][int-int]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "1\n");
     }
@@ -390,7 +391,7 @@ TEST_CASE("execute integer-integer exponential operator", "[exp][int-int]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "-1\n");
     }
@@ -400,7 +401,7 @@ TEST_CASE("execute integer-integer exponential operator", "[exp][int-int]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "1\n");
     }
@@ -413,12 +414,12 @@ TEST_CASE("execute integer-integer exponential operator", "[exp][int-int]")
 
         SECTION("check that the error is thrown")
         {
-            REQUIRE_THROWS_AS(program.run(oss), ProgramError);
+            REQUIRE_THROWS_AS(program.run(oss, OutputBuffering::Line, test_dispatch), ProgramError);
         }
         SECTION("check the offset of the error thrown")
         {
             try {
-                program.run(oss);
+                program.run(oss, OutputBuffering::Line, test_dispatch);
             }
             catch (const ProgramError &error) {
                 std::string expected = "divide by zero";
@@ -436,7 +437,7 @@ TEST_CASE("execute integer-integer exponential operator", "[exp][int-int]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() ==
             "run error at line 1:10: overflow\n"
@@ -449,7 +450,7 @@ TEST_CASE("execute integer-integer exponential operator", "[exp][int-int]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() ==
             "run error at line 1:10: overflow\n"
@@ -462,7 +463,7 @@ TEST_CASE("execute integer-integer exponential operator", "[exp][int-int]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() ==
             "run error at line 1:10: overflow\n"
@@ -475,7 +476,7 @@ TEST_CASE("execute integer-integer exponential operator", "[exp][int-int]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "-729\n");
     }
@@ -485,7 +486,7 @@ TEST_CASE("execute integer-integer exponential operator", "[exp][int-int]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "524288\n");
     }
@@ -495,7 +496,7 @@ TEST_CASE("execute integer-integer exponential operator", "[exp][int-int]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() ==
             "run error at line 1:11: overflow\n"
@@ -508,7 +509,7 @@ TEST_CASE("execute integer-integer exponential operator", "[exp][int-int]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "-524288\n");
     }
@@ -518,7 +519,7 @@ TEST_CASE("execute integer-integer exponential operator", "[exp][int-int]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() ==
             "run error at line 1:12: overflow\n"
@@ -531,7 +532,7 @@ TEST_CASE("execute integer-integer exponential operator", "[exp][int-int]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() ==
             "run error at line 1:12: overflow\n"
@@ -550,7 +551,7 @@ TEST_CASE("execute double-double exponential operator", "[exp][dbl-dbl]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "9\n");
     }
@@ -560,7 +561,7 @@ TEST_CASE("execute double-double exponential operator", "[exp][dbl-dbl]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() ==
             "run error at line 1:12: domain error (non-integer exponent)\n"
@@ -573,7 +574,7 @@ TEST_CASE("execute double-double exponential operator", "[exp][dbl-dbl]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() ==
             "run error at line 1:13: overflow\n"
@@ -586,7 +587,7 @@ TEST_CASE("execute double-double exponential operator", "[exp][dbl-dbl]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() ==
             "run error at line 1:11: divide by zero\n"
@@ -605,7 +606,7 @@ TEST_CASE("execute integer-double exponential operator", "[exp][int-dbl]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "-27\n");
     }
@@ -621,7 +622,7 @@ TEST_CASE("execute double-integer exponential operator", "[exp][dbl-int]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "-27\n");
     }
@@ -631,7 +632,7 @@ TEST_CASE("execute double-integer exponential operator", "[exp][dbl-int]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "0.0625\n");
     }
@@ -641,7 +642,7 @@ TEST_CASE("execute double-integer exponential operator", "[exp][dbl-int]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() ==
             "run error at line 1:11: divide by zero\n"
@@ -654,7 +655,7 @@ TEST_CASE("execute double-integer exponential operator", "[exp][dbl-int]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() ==
             "run error at line 1:13: overflow\n"
@@ -667,7 +668,7 @@ TEST_CASE("execute double-integer exponential operator", "[exp][dbl-int]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "-524288\n");
     }
@@ -677,7 +678,7 @@ TEST_CASE("execute double-integer exponential operator", "[exp][dbl-int]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() ==
             "run error at line 1:13: overflow\n"
@@ -690,7 +691,7 @@ TEST_CASE("execute double-integer exponential operator", "[exp][dbl-int]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "7.62939e-108\n");
     }
@@ -700,7 +701,7 @@ TEST_CASE("execute double-integer exponential operator", "[exp][dbl-int]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() ==
             "run error at line 1:16: overflow\n"
@@ -850,7 +851,7 @@ TEST_CASE("execute integer-integer multiply operator", "[mul][int-int]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "6\n");
     }
@@ -860,7 +861,7 @@ TEST_CASE("execute integer-integer multiply operator", "[mul][int-int]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() ==
             "run error at line 1:18: overflow\n"
@@ -873,7 +874,7 @@ TEST_CASE("execute integer-integer multiply operator", "[mul][int-int]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() ==
             "run error at line 1:18: overflow\n"
@@ -892,7 +893,7 @@ TEST_CASE("execute double-double multiply operator", "[mul][dbl-dbl]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "6\n");
     }
@@ -902,7 +903,7 @@ TEST_CASE("execute double-double multiply operator", "[mul][dbl-dbl]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() ==
             "run error at line 1:13: overflow\n"
@@ -915,7 +916,7 @@ TEST_CASE("execute double-double multiply operator", "[mul][dbl-dbl]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() ==
             "run error at line 1:14: overflow\n"
@@ -928,7 +929,7 @@ TEST_CASE("execute double-double multiply operator", "[mul][dbl-dbl]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "-6\n");
     }
@@ -944,7 +945,7 @@ TEST_CASE("execute double-integer multiply operator", "[mul][dbl-int]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "6\n");
     }
@@ -954,7 +955,7 @@ TEST_CASE("execute double-integer multiply operator", "[mul][dbl-int]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() ==
             "run error at line 1:13: overflow\n"
@@ -973,7 +974,7 @@ TEST_CASE("execute integer-double multiply operator", "[mul][int-dbl]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "6\n");
     }
@@ -983,7 +984,7 @@ TEST_CASE("execute integer-double multiply operator", "[mul][int-dbl]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() ==
             "run error at line 1:16: overflow\n"
@@ -1062,7 +1063,7 @@ TEST_CASE("execute integer-integer divide operator", "[div][int-int]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "1\n");
     }
@@ -1072,7 +1073,7 @@ TEST_CASE("execute integer-integer divide operator", "[div][int-int]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() ==
             "run error at line 1:9: divide by zero\n"
@@ -1091,7 +1092,7 @@ TEST_CASE("execute double-double divide operator", "[div][dbl-dbl]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "1.5\n");
     }
@@ -1101,7 +1102,7 @@ TEST_CASE("execute double-double divide operator", "[div][dbl-dbl]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() ==
             "run error at line 1:11: divide by zero\n"
@@ -1114,7 +1115,7 @@ TEST_CASE("execute double-double divide operator", "[div][dbl-dbl]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() ==
             "run error at line 1:13: overflow\n"
@@ -1127,7 +1128,7 @@ TEST_CASE("execute double-double divide operator", "[div][dbl-dbl]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() ==
             "run error at line 1:14: overflow\n"
@@ -1146,7 +1147,7 @@ TEST_CASE("execute integer-double divide operator", "[div][int-dbl]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "1.5\n");
     }
@@ -1156,7 +1157,7 @@ TEST_CASE("execute integer-double divide operator", "[div][int-dbl]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() ==
             "run error at line 1:9: divide by zero\n"
@@ -1169,7 +1170,7 @@ TEST_CASE("execute integer-double divide operator", "[div][int-dbl]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() ==
             "run error at line 1:11: overflow\n"
@@ -1188,7 +1189,7 @@ TEST_CASE("execute double-integer divide operator", "[div][dbl-int]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "1.5\n");
     }
@@ -1198,7 +1199,7 @@ TEST_CASE("execute double-integer divide operator", "[div][dbl-int]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() ==
             "run error at line 1:11: divide by zero\n"
@@ -1278,7 +1279,7 @@ TEST_CASE("execute integer divide operator", "[intdiv][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "1\n");
     }
@@ -1288,7 +1289,7 @@ TEST_CASE("execute integer divide operator", "[intdiv][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() ==
             "run error at line 1:11: divide by zero\n"
@@ -1301,7 +1302,7 @@ TEST_CASE("execute integer divide operator", "[intdiv][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() ==
             "run error at line 1:12: overflow\n"
@@ -1314,7 +1315,7 @@ TEST_CASE("execute integer divide operator", "[intdiv][execute]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() ==
             "run error at line 1:12: overflow\n"
@@ -1333,7 +1334,7 @@ TEST_CASE("apply necessary conversions to integer divide operator", "[intdiv][co
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "1\n");
     }
@@ -1343,7 +1344,7 @@ TEST_CASE("apply necessary conversions to integer divide operator", "[intdiv][co
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "1\n");
     }
@@ -1353,7 +1354,7 @@ TEST_CASE("apply necessary conversions to integer divide operator", "[intdiv][co
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "1\n");
     }
@@ -1383,7 +1384,7 @@ TEST_CASE("apply necessary conversions to integer divide operator", "[intdiv][co
         }
         SECTION("execute the convert to double code for a non-constant integer operand")
         {
-            program.run(oss);
+            program.run(oss, OutputBuffering::Line, test_dispatch);
 
             REQUIRE(oss.str() == "1\n");
         }
@@ -1490,7 +1491,7 @@ TEST_CASE("execute integer-integer mod operator", "[mod][int-int]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "2\n");
     }
@@ -1503,11 +1504,11 @@ TEST_CASE("execute integer-integer mod operator", "[mod][int-int]")
 
         SECTION("check that error is thrown")
         {
-            REQUIRE_THROWS_AS(program.run(oss), ProgramError);
+            REQUIRE_THROWS_AS(program.run(oss, OutputBuffering::Line, test_dispatch), ProgramError);
         }
         SECTION("check for the correct error message, column and length")
         {
-            program.runCode(oss);
+            program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
             REQUIRE(oss.str() ==
                 "run error at line 1:9: divide by zero\n"
@@ -1527,7 +1528,7 @@ TEST_CASE("execute double-double mod operator", "[mod][dbl-dbl]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "2.2\n");
     }
@@ -1537,7 +1538,7 @@ TEST_CASE("execute double-double mod operator", "[mod][dbl-dbl]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() ==
             "run error at line 1:11: divide by zero\n"
@@ -1556,7 +1557,7 @@ TEST_CASE("execute integer-double mod operator", "[mod][int-dbl]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "1.8\n");
     }
@@ -1566,7 +1567,7 @@ TEST_CASE("execute integer-double mod operator", "[mod][int-dbl]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() ==
             "run error at line 1:9: divide by zero\n"
@@ -1585,7 +1586,7 @@ TEST_CASE("execute double-integer mod operator", "[mod][dbl-int]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "2.3\n");
     }
@@ -1595,7 +1596,7 @@ TEST_CASE("execute double-integer mod operator", "[mod][dbl-int]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() ==
             "run error at line 1:11: divide by zero\n"
@@ -1703,7 +1704,7 @@ TEST_CASE("execute integer-integer add operator", "[add][int-int]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "8\n");
     }
@@ -1713,7 +1714,7 @@ TEST_CASE("execute integer-integer add operator", "[add][int-int]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() ==
             "run error at line 1:18: overflow\n"
@@ -1726,7 +1727,7 @@ TEST_CASE("execute integer-integer add operator", "[add][int-int]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() ==
             "run error at line 1:19: overflow\n"
@@ -1745,7 +1746,7 @@ TEST_CASE("execute double-double add operator", "[add][dbl-dbl]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "5\n");
     }
@@ -1755,7 +1756,7 @@ TEST_CASE("execute double-double add operator", "[add][dbl-dbl]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() ==
             "run error at line 1:13: overflow\n"
@@ -1768,7 +1769,7 @@ TEST_CASE("execute double-double add operator", "[add][dbl-dbl]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() ==
             "run error at line 1:14: overflow\n"
@@ -1787,7 +1788,7 @@ TEST_CASE("execute integer-double add operator", "[add][int-dbl]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "5\n");
     }
@@ -1803,7 +1804,7 @@ TEST_CASE("execute double-integer add operator", "[add][dbl-int]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "5\n");
     }
@@ -1879,7 +1880,7 @@ TEST_CASE("execute integer-integer subtract operator", "[sub][int-int]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "2\n");
     }
@@ -1889,7 +1890,7 @@ TEST_CASE("execute integer-integer subtract operator", "[sub][int-int]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() ==
             "run error at line 1:18: overflow\n"
@@ -1902,7 +1903,7 @@ TEST_CASE("execute integer-integer subtract operator", "[sub][int-int]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() ==
             "run error at line 1:19: overflow\n"
@@ -1921,7 +1922,7 @@ TEST_CASE("execute double-double subtract operator", "[sub][dbl-dbl]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "2.9\n");
     }
@@ -1931,7 +1932,7 @@ TEST_CASE("execute double-double subtract operator", "[sub][dbl-dbl]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() ==
             "run error at line 1:13: overflow\n"
@@ -1944,7 +1945,7 @@ TEST_CASE("execute double-double subtract operator", "[sub][dbl-dbl]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.runCode(oss);
+        program.runCode(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() ==
             "run error at line 1:14: overflow\n"
@@ -1963,7 +1964,7 @@ TEST_CASE("execute integer-double subtract operator", "[sub][int-dbl]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "2.9\n");
     }
@@ -1979,7 +1980,7 @@ TEST_CASE("execute double-integer subtract operator", "[sub][dbl-int]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "3.1\n");
     }
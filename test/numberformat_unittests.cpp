@@ -0,0 +1,153 @@
+/* vim:ts=4:sw=4:et:sts=4:
+ *
+ * Copyright 2016 Thunder422.  All rights reserved.
+ * Distributed under GNU General Public License Version 3
+ * (See accompanying file LICENSE or <http://www.gnu.org/licenses/>)
+ */
+
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <random>
+#include <sstream>
+
+#include "catch.hpp"
+#include "numberformat.h"
+
+
+template <typename T>
+std::string streamFormat(T value)
+{
+    std::ostringstream oss;
+    oss << value;
+    return oss.str();
+}
+
+std::string formatted(int32_t value)
+{
+    char buffer[MaximumIntegerLength];
+    return std::string(buffer, formatInteger(buffer, value));
+}
+
+std::string formatted(double value)
+{
+    char buffer[MaximumDoubleLength];
+    return std::string(buffer, formatDouble(buffer, value));
+}
+
+
+TEST_CASE("format integers", "[integer]")
+{
+    SECTION("integers used by the print tests")
+    {
+        REQUIRE(formatted(-1234) == "-1234");
+        REQUIRE(formatted(123) == "123");
+        REQUIRE(formatted(0) == "0");
+    }
+    SECTION("integers at each number of digits and the limits")
+    {
+        std::vector<int32_t> values {std::numeric_limits<int32_t>::min(),
+            std::numeric_limits<int32_t>::max()};
+        for (int32_t power = 1; power <= 1000000000; power *= 10) {
+            for (auto value : {power - 1, power, power + 1}) {
+                values.push_back(value);
+                values.push_back(-value);
+            }
+        }
+        for (auto value : values) {
+            REQUIRE(formatted(value) == streamFormat(value));
+        }
+    }
+    SECTION("random integers")
+    {
+        std::mt19937 generator {1};
+        std::uniform_int_distribution<int32_t> distribution {
+            std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max()};
+        for (int i = 0; i < 100000; ++i) {
+            auto value = distribution(generator);
+            REQUIRE(formatted(value) == streamFormat(value));
+        }
+    }
+}
+
+TEST_CASE("format doubles", "[double]")
+{
+    SECTION("doubles used by the print tests")
+    {
+        REQUIRE(formatted(-2.45) == "-2.45");
+        REQUIRE(formatted(23.4e-108) == "2.34e-107");
+        REQUIRE(formatted(8.5) == "8.5");
+        REQUIRE(formatted(1e10) == "1e+10");
+    }
+    SECTION("zero, infinity and not a number")
+    {
+        auto infinity = std::numeric_limits<double>::infinity();
+        for (auto value : {0.0, -0.0, infinity, -infinity, std::nan("")}) {
+            REQUIRE(formatted(value) == streamFormat(value));
+        }
+    }
+    SECTION("doubles near the boundaries of the fixed and exponent formats")
+    {
+        for (auto value : {1e-4, 9.99999e-5, 9.999995e-5, 9.9999949e-5, 999999.0, 999999.4,
+                999999.5, 999999.6, 1e6, 100000.5, 100001.5, 0.1, 0.3, 0.1 + 0.2, 2.5e-4,
+                123456.5, 1.0000005, 1.0000015, 0.00012345650000000001}) {
+            REQUIRE(formatted(value) == streamFormat(value));
+            REQUIRE(formatted(-value) == streamFormat(-value));
+        }
+    }
+    SECTION("random doubles of every magnitude")
+    {
+        std::mt19937_64 generator {1};
+        std::uniform_real_distribution<double> mantissa {1.0, 10.0};
+        std::uniform_int_distribution<int> exponent {-12, 12};
+        for (int i = 0; i < 200000; ++i) {
+            auto value = mantissa(generator) * std::pow(10.0, exponent(generator));
+            REQUIRE(formatted(value) == streamFormat(value));
+        }
+    }
+    SECTION("random doubles with few digits")
+    {
+        std::mt19937 generator {1};
+        std::uniform_int_distribution<int> digits {-9999999, 9999999};
+        std::uniform_int_distribution<int> exponent {0, 10};
+        for (int i = 0; i < 200000; ++i) {
+            auto value = digits(generator) / std::pow(10.0, exponent(generator));
+            REQUIRE(formatted(value) == streamFormat(value));
+        }
+    }
+}
+
+TEST_CASE("format doubles exactly", "[exact]")
+{
+    auto exactly = [](double value) {
+        char buffer[MaximumExactDoubleLength];
+        return std::string(buffer, formatExactDouble(buffer, value));
+    };
+    auto streamExactly = [](double value) {
+        std::ostringstream oss;
+        oss << std::setprecision(17) << value;
+        return oss.str();
+    };
+
+    SECTION("doubles used by constant folding")
+    {
+        REQUIRE(exactly(2.5) == "2.5");
+        REQUIRE(exactly(0.1 + 0.2) == "0.30000000000000004");
+        REQUIRE(exactly(-std::numeric_limits<double>::min())
+            == streamExactly(-std::numeric_limits<double>::min()));
+        REQUIRE(exactly(std::numeric_limits<double>::max())
+            == streamExactly(std::numeric_limits<double>::max()));
+    }
+    SECTION("random doubles convert back to the same value")
+    {
+        std::mt19937_64 generator {1};
+        std::uniform_real_distribution<double> mantissa {1.0, 10.0};
+        std::uniform_int_distribution<int> exponent {-300, 300};
+        for (int i = 0; i < 100000; ++i) {
+            auto value = mantissa(generator) * std::pow(10.0, exponent(generator));
+            auto string = exactly(value);
+            REQUIRE(string == streamExactly(value));
+            REQUIRE(std::stod(string) == value);
+        }
+    }
+}
@@ -8,9 +8,11 @@
 #include "catch.hpp"
 #include "commandcode.h"
 #include "commandcompiler.h"
+#include "compiler.h"
 #include "executer.h"
 #include "programerror.h"
 #include "programunit.h"
+#include "support.h"
 
 
 TEST_CASE("compile simple PRINT commands", "[compile]")
@@ -24,7 +26,9 @@ TEST_CASE("compile simple PRINT commands", "[compile]")
 
     SECTION("compile a PRINT command with an expression (single constant for now)")
     {
-        auto code_line = CommandCompiler::create("PRINT 234", program)->compile();
+        Compiler compiler {"PRINT 234", program};
+        CommandCompiler::compile(compiler);
+        auto code_line = compiler.getCodeLine();
 
         REQUIRE(code_line.size() == 4);
         REQUIRE(code_line[0].instructionCode()->getValue() == const_int_code.getValue());
@@ -38,7 +42,9 @@ TEST_CASE("compile simple PRINT commands", "[compile]")
         extern Code const_dbl_code;
         extern Code print_dbl_code;
 
-        auto code_line = CommandCompiler::create("PRINT -5.6e14", program)->compile();
+        Compiler compiler {"PRINT -5.6e14", program};
+        CommandCompiler::compile(compiler);
+        auto code_line = compiler.getCodeLine();
 
         REQUIRE(code_line.size() == 4);
         REQUIRE(code_line[0].instructionCode()->getValue() == const_dbl_code.getValue());
@@ -49,7 +55,9 @@ TEST_CASE("compile simple PRINT commands", "[compile]")
     }
     SECTION("compile a lower case PRINT command")
     {
-        auto code_line = CommandCompiler::create("print", program)->compile();
+        Compiler compiler {"print", program};
+        CommandCompiler::compile(compiler);
+        auto code_line = compiler.getCodeLine();
 
         REQUIRE(code_line.size() == 1);
         REQUIRE(code_line[0].instructionCode()->getValue() == print_code.getValue());
@@ -66,7 +74,7 @@ TEST_CASE("execute simple PRINT commands", "[execute]")
         program.compile(iss);
         std::ostringstream oss;
 
-        auto executer = program.createExecuter(oss);
+        auto executer = program.createExecuter(oss, OutputBuffering::Line, test_dispatch);
         executer.executeOneCode();
 
         REQUIRE(oss.str() == "\n");
@@ -77,7 +85,7 @@ TEST_CASE("execute simple PRINT commands", "[execute]")
         program.compile(iss);
         std::ostringstream oss;
 
-        auto executer = program.createExecuter(oss);
+        auto executer = program.createExecuter(oss, OutputBuffering::Line, test_dispatch);
         executer.executeOneCode();
         executer.executeOneCode();
         executer.executeOneCode();
@@ -90,7 +98,7 @@ TEST_CASE("execute simple PRINT commands", "[execute]")
         program.compile(iss);
         std::ostringstream oss;
 
-        auto executer = program.createExecuter(oss);
+        auto executer = program.createExecuter(oss, OutputBuffering::Line, test_dispatch);
         executer.executeOneCode();
         executer.executeOneCode();
         executer.executeOneCode();
@@ -105,7 +113,9 @@ TEST_CASE("PRINT command handling of string expressions", "[strings]")
 
     SECTION("compile a PRINT command with a string constant")
     {
-        auto code_line = CommandCompiler::create(R"(PRINT "test")", program)->compile();
+        Compiler compiler {R"(PRINT "test")", program};
+        CommandCompiler::compile(compiler);
+        auto code_line = compiler.getCodeLine();
 
         extern Code const_str_code;
         extern Code print_str_code;
@@ -133,7 +143,7 @@ TEST_CASE("PRINT command handling of string expressions", "[strings]")
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "test\n");
     }
@@ -145,10 +155,60 @@ TEST_CASE("PRINT command handling of temporary string expressions", "[tmpstrs]")
 
     SECTION("compile a PRINT command with a temporary string")
     {
-        auto code_line = CommandCompiler::create(R"(PRINT "Left"+"Right")", program)->compile();
+        Compiler compiler {R"(PRINT "Left"+"Right")", program};
+        CommandCompiler::compile(compiler);
+        auto code_line = compiler.getCodeLine();
 
         extern Code print_tmp_code;
         REQUIRE(code_line.size() == 7);
         REQUIRE(code_line[5].instructionCode()->getValue() == print_tmp_code.getValue());
     }
 }
+
+TEST_CASE("buffering of PRINT command output", "[buffering]")
+{
+    ProgramUnit program;
+    std::istringstream iss {
+        "PRINT 1\n"
+        "PRINT 2"
+    };
+    program.compile(iss);
+    std::ostringstream oss;
+
+    SECTION("line buffered output is written at the end of each line")
+    {
+        auto executer = program.createExecuter(oss, OutputBuffering::Line, test_dispatch);
+        executer.executeOneCode();
+        executer.executeOneCode();
+        REQUIRE(oss.str() == "");
+
+        executer.executeOneCode();
+        REQUIRE(oss.str() == "1\n");
+    }
+    SECTION("fully buffered output is not written until flushed")
+    {
+        auto executer = program.createExecuter(oss, OutputBuffering::Full, test_dispatch);
+        executer.executeOneCode();
+        executer.executeOneCode();
+        executer.executeOneCode();
+        REQUIRE(oss.str() == "");
+    }
+    SECTION("fully buffered output is written at the end of the program")
+    {
+        program.run(oss, OutputBuffering::Full, test_dispatch);
+
+        REQUIRE(oss.str() == "1\n2\n");
+    }
+    SECTION("fully buffered output is written before a run error")
+    {
+        std::istringstream iss {
+            "PRINT 1\n"
+            "PRINT 1/0"
+        };
+        ProgramUnit error_program;
+        error_program.compile(iss);
+
+        REQUIRE_FALSE(error_program.runCode(oss, OutputBuffering::Full, test_dispatch));
+        REQUIRE(oss.str().find("1\nrun error at line 2") == 0);
+    }
+}
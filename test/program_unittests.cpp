@@ -5,16 +5,35 @@
  * (See accompanying file LICENSE or <http://www.gnu.org/licenses/>)
  */
 
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <set>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
 #include "catch.hpp"
 #include "commandcode.h"
 #include "commandcompiler.h"
+#include "compiledprogram.h"
 #include "compiler.h"
 #include "compileerror.h"
 #include "executer.h"
+#include "fusedcode.h"
+#include "mappedfile.h"
+#include "mappedprogram.h"
 #include "programcode.h"
 #include "programerror.h"
+#include "programimage.h"
+#include "programreader.h"
 #include "programunit.h"
 #include "runerror.h"
+#include "support.h"
 
 
 TEST_CASE("compile simple commands", "[commands]")
@@ -28,43 +47,51 @@ TEST_CASE("compile simple commands", "[commands]")
 
     SECTION("compile an empty command line")
     {
-        auto code_line = CommandCompiler::create("", program)->compile();
+        Compiler compiler {"", program};
+        CommandCompiler::compile(compiler);
+        auto code_line = compiler.getCodeLine();
 
         REQUIRE(code_line.empty());
     }
     SECTION("compile a simple PRINT command")
     {
-        auto code_line = CommandCompiler::create("PRINT", program)->compile();
+        Compiler compiler {"PRINT", program};
+        CommandCompiler::compile(compiler);
+        auto code_line = compiler.getCodeLine();
 
         REQUIRE(code_line.size() == 1);
         REQUIRE(code_line[0].instructionCode()->getValue() == print_code.getValue());
     }
     SECTION("compile an END command")
     {
-        auto code_line = CommandCompiler::create("END", program)->compile();
+        Compiler compiler {"END", program};
+        CommandCompiler::compile(compiler);
+        auto code_line = compiler.getCodeLine();
 
         REQUIRE(code_line.size() == 1);
         REQUIRE(code_line[0].instructionCode()->getValue() == end_code.getValue());
     }
     SECTION("allow white space before a command")
     {
-        auto code_line = CommandCompiler::create("   PRINT", program)->compile();
+        Compiler compiler {"   PRINT", program};
+        CommandCompiler::compile(compiler);
+        auto code_line = compiler.getCodeLine();
 
         REQUIRE(code_line.size() == 1);
         REQUIRE(code_line[0].instructionCode()->getValue() == print_code.getValue());
     }
     SECTION("check for an error if non-alphabetic word if first")
     {
-        auto command = CommandCompiler::create("   123", program);
+        Compiler compiler {"   123", program};
 
         SECTION("check that error is thrown")
         {
-            REQUIRE_THROWS_AS(command->compile(), CompileError);
+            REQUIRE_THROWS_AS(CommandCompiler::compile(compiler), CompileError);
         }
         SECTION("check the message, column and length of the error thrown")
         {
             try {
-                command->compile();
+                CommandCompiler::compile(compiler);
             }
             catch (const CompileError &error) {
                 std::string expected = "expected command keyword";
@@ -76,16 +103,16 @@ TEST_CASE("compile simple commands", "[commands]")
     }
     SECTION("verify error column when constant is not at the beginning of the stream")
     {
-        auto command = CommandCompiler::create("print 01", program);
+        Compiler compiler {"print 01", program};
 
         SECTION("check that the error is thrown")
         {
-            REQUIRE_THROWS_AS(command->compile(), CompileError);
+            REQUIRE_THROWS_AS(CommandCompiler::compile(compiler), CompileError);
         }
         SECTION("check the message, column and length of the error thrown")
         {
             try {
-                command->compile();
+                CommandCompiler::compile(compiler);
             }
             catch (const CompileError &error) {
                 std::string expected = "expected decimal point after leading zero";
@@ -162,7 +189,7 @@ TEST_CASE("compile multiple line program", "[compile]")
         {
             std::ostringstream oss;
 
-            program.run(oss);
+            program.run(oss, OutputBuffering::Line, test_dispatch);
             REQUIRE(oss.str() ==
                 "-2.45\n"
                 "\n"
@@ -180,7 +207,7 @@ TEST_CASE("compile multiple line program", "[compile]")
         REQUIRE(program.compile(iss).empty());
 
         std::ostringstream oss;
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() ==
             "1.704e+123\n"
@@ -224,12 +251,12 @@ TEST_CASE("compile multiple line program", "[compile]")
         std::ostringstream oss;
         SECTION("check that error is thrown")
         {
-            REQUIRE_THROWS_AS(program.run(oss), ProgramError);
+            REQUIRE_THROWS_AS(program.run(oss, OutputBuffering::Line, test_dispatch), ProgramError);
         }
         SECTION("check message of the error thrown")
         {
             try {
-                program.run(oss);
+                program.run(oss, OutputBuffering::Line, test_dispatch);
             }
             catch (const ProgramError &error) {
                 std::string expected = "BUG: value stack not empty at end of program";
@@ -244,16 +271,16 @@ TEST_CASE("correct error column on large double constant", "[large-constant]")
 {
     ProgramUnit program;
 
-    auto command = CommandCompiler::create("PRINT 1.23e4567", program);
+    Compiler compiler {"PRINT 1.23e4567", program};
 
     SECTION("check that error is thrown")
     {
-        REQUIRE_THROWS_AS(command->compile(), CompileError);
+        REQUIRE_THROWS_AS(CommandCompiler::compile(compiler), CompileError);
     }
     SECTION("check the message, column and length of the error thrown")
     {
         try {
-            command->compile();
+            CommandCompiler::compile(compiler);
         }
         catch (const CompileError &error) {
             std::string expected = "floating point constant is out of range";
@@ -271,8 +298,11 @@ TEST_CASE("execute an END command", "[END]")
     std::ostringstream unused_oss;
     program.compile(iss);
 
-    auto executer = program.createExecuter(unused_oss);
-    REQUIRE_THROWS_AS(executer.executeOneCode(), EndOfProgram);
+    auto executer = program.createExecuter(unused_oss, OutputBuffering::Line, test_dispatch);
+    REQUIRE(executer.isRunning());
+    executer.executeOneCode();
+    REQUIRE_FALSE(executer.isRunning());
+    REQUIRE_FALSE(executer.hasRunError());
 }
 
 TEST_CASE("run program code", "[execute]")
@@ -288,7 +318,7 @@ TEST_CASE("run program code", "[execute]")
         };
         program.compile(iss);
 
-        REQUIRE_FALSE(program.runCode(oss));
+        REQUIRE_FALSE(program.runCode(oss, OutputBuffering::Line, test_dispatch));
         REQUIRE(oss.str() ==
             "4096\n"
             "run error at line 2:13: divide by zero\n"
@@ -302,7 +332,7 @@ TEST_CASE("run program code", "[execute]")
         auto code_line = compiler.getCodeLine();
         program.appendCodeLine(code_line);
 
-        REQUIRE_FALSE(program.runCode(oss));
+        REQUIRE_FALSE(program.runCode(oss, OutputBuffering::Line, test_dispatch));
         REQUIRE(oss.str() ==
             "run error at end of program: BUG: value stack not empty at end of program\n");
     }
@@ -313,10 +343,692 @@ TEST_CASE("run program code", "[execute]")
         };
         program.compile(iss);
 
-        REQUIRE(program.runCode(oss));
+        REQUIRE(program.runCode(oss, OutputBuffering::Line, test_dispatch));
         REQUIRE(oss.str() ==
             "4096\n");
     }
+    SECTION("run the program again after lines are added and after the code is fused")
+    {
+        std::istringstream iss {"PRINT 2^3^4\n"};
+        program.compile(iss);
+        REQUIRE(program.runCode(oss, OutputBuffering::Line, test_dispatch));
+
+        std::istringstream more_iss {"PRINT 3 * 4\n"};
+        program.compile(more_iss);
+        REQUIRE(program.runCode(oss, OutputBuffering::Line, test_dispatch));
+        program.fuseCode();
+        REQUIRE(program.runCode(oss, OutputBuffering::Line, test_dispatch));
+
+        REQUIRE(oss.str() == "4096\n4096\n12\n4096\n12\n");
+    }
+}
+
+TEST_CASE("map between code offsets and lines", "[lines]")
+{
+    ProgramUnit program;
+    std::istringstream iss {
+        "PRINT 1\n"
+        "\n"
+        "PRINT 2+3\n"
+        "END\n"
+    };
+    program.compile(iss);
+
+    SECTION("offset and size of each line")
+    {
+        REQUIRE(program.lineCount() == 4);
+        REQUIRE(program.getLineInfo(0).offset == 0);
+        REQUIRE(program.getLineInfo(0).size == 4);
+        REQUIRE(program.getLineInfo(1).offset == 4);
+        REQUIRE(program.getLineInfo(1).size == 0);
+        REQUIRE(program.getLineInfo(2).offset == 4);
+        REQUIRE(program.getLineInfo(2).size == 7);
+        REQUIRE(program.getLineInfo(3).offset == 11);
+        REQUIRE(program.getLineInfo(3).size == 1);
+    }
+    SECTION("line containing an offset (a line without code contains no offsets)")
+    {
+        REQUIRE(program.lineIndex(0) == 0);
+        REQUIRE(program.lineIndex(3) == 0);
+        REQUIRE(program.lineIndex(4) == 2);
+        REQUIRE(program.lineIndex(10) == 2);
+        REQUIRE(program.lineIndex(11) == 3);
+    }
+    SECTION("offset past the end of the program is not within a line")
+    {
+        REQUIRE(program.lineIndex(12) == program.lineCount());
+    }
+    SECTION("every offset maps back to the line containing it")
+    {
+        for (unsigned line_index = 0; line_index < program.lineCount(); ++line_index) {
+            auto info = program.getLineInfo(line_index);
+            for (auto offset = info.offset; offset < info.offset + info.size; ++offset) {
+                REQUIRE(program.lineIndex(offset) == line_index);
+            }
+        }
+    }
+}
+
+TEST_CASE("run a sealed program many times", "[sealed]")
+{
+    ProgramUnit program;
+
+    SECTION("each run goes to its own output stream")
+    {
+        std::istringstream iss {
+            R"(PRINT "a"+"b")" "\n"
+            "PRINT 2^3\n"
+        };
+        program.compile(iss);
+        auto compiled_program = std::move(program).seal();
+        std::ostringstream unused_oss;
+        auto executer = compiled_program.createExecuter(unused_oss, OutputBuffering::Line,
+            test_dispatch);
+
+        for (int run = 0; run < 3; ++run) {
+            std::ostringstream oss;
+            REQUIRE(compiled_program.runCode(executer, oss, OutputBuffering::Line, test_dispatch));
+            REQUIRE(oss.str() == "ab\n8\n");
+        }
+        REQUIRE(unused_oss.str().empty());
+        REQUIRE(executer.getStringPoolStatistics().misses == 0);
+    }
+    SECTION("the sealed program owns the code of the program unit")
+    {
+        auto compiled_program = []() {
+            ProgramUnit unit;
+            std::istringstream iss {R"(PRINT "abc" + "def")" "\n"};
+            unit.compile(iss);
+            return std::move(unit).seal();
+        }();
+        std::ostringstream unused_oss;
+        auto executer = compiled_program.createExecuter(unused_oss, OutputBuffering::Line,
+            test_dispatch);
+        std::ostringstream oss;
+
+        REQUIRE(compiled_program.runCode(executer, oss, OutputBuffering::Line, test_dispatch));
+        REQUIRE(oss.str() == "abcdef\n");
+    }
+    SECTION("run errors are reported for every run")
+    {
+        std::istringstream iss {
+            R"(PRINT "a"+"b")" "\n"
+            "PRINT 1+0^-1\n"
+        };
+        program.compile(iss);
+        auto compiled_program = std::move(program).seal();
+        std::ostringstream unused_oss;
+        auto executer = compiled_program.createExecuter(unused_oss, OutputBuffering::Line,
+            test_dispatch);
+
+        for (int run = 0; run < 2; ++run) {
+            std::ostringstream oss;
+            REQUIRE_FALSE(compiled_program.runCode(executer, oss, OutputBuffering::Line,
+                test_dispatch));
+            REQUIRE(oss.str() ==
+                "ab\n"
+                "run error at line 2:13: divide by zero\n"
+                "    PRINT 1 + 0 ^ -1\n"
+                "                ^\n");
+            REQUIRE_THROWS_AS(compiled_program.run(executer, oss, OutputBuffering::Line,
+                test_dispatch), ProgramError);
+        }
+    }
+}
+
+TEST_CASE("run one program on every hardware thread at the same time", "[threads]")
+{
+    std::string source {
+        R"(PRINT "abc"+"def"+("ghi"+"jkl"))" "\n"
+        "PRINT 1.5*2+3^2-7/2\n"
+        "PRINT RND(1000000)+RND(1000000)\n"
+        R"(PRINT "abc"<"abd"+"e")" "\n"
+        "PRINT 2^0.5\n"
+    };
+    ProgramUnit program;
+    program.compile(source.data(), source.size());
+    program.fuseCode();
+    std::ostringstream expected;
+    program.run(expected, OutputBuffering::Line, test_dispatch);
+    ProgramUnit sealed_program;
+    sealed_program.compile(source.data(), source.size());
+    sealed_program.fuseCode();
+    auto compiled_program = std::move(sealed_program).seal();
+
+    const int RunCount = 200;
+    auto thread_count = std::max(std::thread::hardware_concurrency(), 2u);
+    std::atomic<int> mismatch_count {0};
+    auto run_program = [&]() {
+        std::ostringstream unused_oss;
+        auto executer = compiled_program.createExecuter(unused_oss, OutputBuffering::Line,
+            test_dispatch);
+        for (int run = 0; run < RunCount; ++run) {
+            std::ostringstream oss;
+            if (run % 2 == 0) {
+                compiled_program.run(executer, oss, OutputBuffering::Full, test_dispatch);
+            } else {
+                program.run(oss, OutputBuffering::Line, test_dispatch);
+            }
+            if (oss.str() != expected.str()) {
+                ++mismatch_count;
+            }
+        }
+    };
+    std::vector<std::thread> threads;
+    for (unsigned i = 0; i < thread_count; ++i) {
+        threads.emplace_back(run_program);
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    REQUIRE(mismatch_count == 0);
+}
+
+TEST_CASE("fuse common code sequences", "[fuse]")
+{
+    ProgramUnit program;
+    std::ostringstream oss;
+
+    SECTION("fused program recreates the original program")
+    {
+        std::istringstream iss {
+            "PRINT 1\n"
+            "PRINT 2.5\n"
+            "PRINT 2 + 3 * 4 - 1\n"
+            "PRINT 1.5 * 2.5 / 0.5 + (1.5 - 0.5)\n"
+            "PRINT (1 < 2) AND (3 >= 4) OR 5 <> 6\n"
+            "PRINT 3 ^ (2 * 4) MOD 7\n"
+            "PRINT \"abc\"\n"
+            "PRINT\n"
+        };
+        program.compile(iss);
+        std::ostringstream unfused_oss;
+        program.recreate(unfused_oss);
+
+        program.fuseCode();
+        program.recreate(oss);
+        REQUIRE(oss.str() == unfused_oss.str());
+    }
+    SECTION("fused program produces the same output")
+    {
+        std::istringstream iss {
+            "PRINT 2 + 3 * 4 - 1\n"
+            "PRINT 1.5 * 2.5 / 0.5 + (1.5 - 0.5)\n"
+            "PRINT (1 < 2) AND (3 >= 4) OR 5 <> 6\n"
+            "PRINT 3 ^ (2 * 4) MOD 7\n"
+        };
+        program.compile(iss);
+        program.fuseCode();
+
+        REQUIRE(program.runCode(oss, OutputBuffering::Line, test_dispatch));
+        REQUIRE(oss.str() ==
+            "13\n"
+            "8.5\n"
+            "-1\n"
+            "2\n");
+    }
+    SECTION("a constant, print item and print are fused into a single code")
+    {
+        std::istringstream iss {"PRINT 1\n"};
+        program.compile(iss);
+        program.fuseCode();
+
+        auto executer = program.createExecuter(oss, OutputBuffering::Line, test_dispatch);
+        executer.executeOneCode();
+        REQUIRE(oss.str() == "1\n");
+        REQUIRE(executer.stackEmpty());
+    }
+    SECTION("run error in a fused constant and operator")
+    {
+        std::istringstream iss {
+            "PRINT 2^3^4\n"
+            "PRINT 16^8\n"
+        };
+        program.compile(iss);
+        program.fuseCode();
+
+        REQUIRE_FALSE(program.runCode(oss, OutputBuffering::Line, test_dispatch));
+        REQUIRE(oss.str() ==
+            "4096\n"
+            "run error at line 2:10: overflow\n"
+            "    PRINT 16 ^ 8\n"
+            "             ^\n");
+    }
+    SECTION("run error in a fused operator and print item does not print")
+    {
+        std::istringstream iss {"PRINT 65536 * 65536 ^ 1\n"};
+        program.compile(iss);
+        program.fuseCode();
+
+        REQUIRE_FALSE(program.runCode(oss, OutputBuffering::Line, test_dispatch));
+        REQUIRE(oss.str() ==
+            "run error at line 1:13: overflow\n"
+            "    PRINT 65536 * 65536 ^ 1\n"
+            "                ^\n");
+    }
+}
+
+// the files of the tests are written to the temporary directory instead of the current
+// directory (with the process id so that tests being run at the same time use different files)
+std::string temporaryFileName(const std::string &name)
+{
+    auto directory = std::getenv("TMPDIR");
+    return std::string {directory ? directory : "/tmp"} + '/' + std::to_string(getpid()) + '_'
+        + name;
+}
+
+// swaps every occurrence of two names of the same length in a saved image
+std::string swapNames(std::string image, const std::string &name1, const std::string &name2)
+{
+    auto size = name1.size();
+    for (std::size_t pos = 0; pos + size <= image.size(); ++pos) {
+        if (image.compare(pos, size, name1) == 0) {
+            image.replace(pos, size, name2);
+            pos += size - 1;
+        } else if (image.compare(pos, size, name2) == 0) {
+            image.replace(pos, size, name1);
+            pos += size - 1;
+        }
+    }
+    return image;
+}
+
+WordType codeValue(const std::string &name)
+{
+    unsigned value = 0;
+    while (Code::getCode(value)->getName() != name) {
+        ++value;
+    }
+    return value;
+}
+
+// replaces the first occurrence of a sequence of values in an image
+template <typename T>
+std::string replaceValues(std::string image, const std::vector<T> &values,
+    const std::vector<T> &new_values)
+{
+    std::string bytes(reinterpret_cast<const char *>(values.data()), values.size() * sizeof(T));
+    auto pos = image.find(bytes);
+    REQUIRE(pos != std::string::npos);
+    image.replace(pos, bytes.size(), reinterpret_cast<const char *>(new_values.data()),
+        new_values.size() * sizeof(T));
+    return image;
+}
+
+std::string replaceWords(std::string image, const std::vector<WordType> &words,
+    const std::vector<WordType> &new_words)
+{
+    return replaceValues(image, words, new_words);
+}
+
+// replaces a word of the header of an image (the header words are saved without padding)
+std::string replaceHeaderWord(std::string image, std::size_t offset, uint32_t word)
+{
+    image.replace(offset, sizeof(word), reinterpret_cast<const char *>(&word), sizeof(word));
+    return image;
+}
+
+bool openImage(const std::string &image, uint64_t source_hash)
+{
+    ProgramImage program_image {image.data(), image.size()};
+    return program_image.open(source_hash, false);
+}
+
+TEST_CASE("save and load a compiled program", "[image]")
+{
+    std::string source {
+        "PRINT 2 + 3 * 4 - 1\n"
+        "PRINT 1.5 * 2.5 / 0.5 + (1.5 - 0.5)\n"
+        "PRINT \"abc\" + \"def\"\n"
+        "PRINT -ABS(-7)\n"
+        "PRINT (1 < 2) AND (3 >= 4) OR 5 <> 6\n"
+        "PRINT 65536 * 65536\n"
+    };
+    auto source_hash = ProgramImage::hashSource(source);
+    ProgramUnit program;
+    program.setConstantFolding(true);
+    std::istringstream iss {source};
+    program.compile(iss);
+    program.fuseCode();
+    std::ostringstream image;
+    ProgramImage::save(image, program, source_hash);
+
+    ProgramUnit loaded_program;
+    loaded_program.setConstantFolding(true);
+
+    SECTION("every code has a unique name")
+    {
+        std::set<std::string> names;
+        for (unsigned value = 0; value < Code::getCodeCount(); ++value) {
+            auto &name = Code::getCode(value)->getName();
+            REQUIRE_FALSE(name.empty());
+            REQUIRE(names.insert(name).second);
+        }
+    }
+    SECTION("the data types of each code agree with its stack effect")
+    {
+        for (unsigned value = 0; value < Code::getCodeCount(); ++value) {
+            auto &code = *Code::getCode(value);
+            if (!FusedCode::isFused(value) && !code.hasChainOperand()) {
+                INFO(code.getName());
+                REQUIRE(dataTypesStackEffect(code.getDataTypes()) == code.getStackEffect(nullptr));
+            }
+        }
+    }
+    SECTION("loaded program recreates and runs the same as the compiled program")
+    {
+        std::istringstream image_iss {image.str()};
+        REQUIRE(ProgramImage::load(image_iss, loaded_program, source_hash));
+
+        std::ostringstream recreate_oss;
+        program.recreate(recreate_oss);
+        std::ostringstream loaded_recreate_oss;
+        loaded_program.recreate(loaded_recreate_oss);
+        REQUIRE(loaded_recreate_oss.str() == recreate_oss.str());
+
+        std::ostringstream oss;
+        REQUIRE_FALSE(program.runCode(oss, OutputBuffering::Line, test_dispatch));
+        std::ostringstream loaded_oss;
+        REQUIRE_FALSE(loaded_program.runCode(loaded_oss, OutputBuffering::Line, test_dispatch));
+        REQUIRE(loaded_oss.str() == oss.str());
+    }
+    SECTION("image is not loaded for a different source")
+    {
+        std::istringstream image_iss {image.str()};
+        auto other_hash = ProgramImage::hashSource(source + "PRINT\n");
+
+        REQUIRE_FALSE(ProgramImage::load(image_iss, loaded_program, other_hash));
+        REQUIRE(loaded_program.lineCount() == 0);
+    }
+    SECTION("image is not loaded for different compile options")
+    {
+        std::istringstream image_iss {image.str()};
+        loaded_program.setConstantFolding(false);
+
+        REQUIRE_FALSE(ProgramImage::load(image_iss, loaded_program, source_hash));
+    }
+    SECTION("truncated image is not loaded")
+    {
+        auto image_string = image.str();
+        std::istringstream image_iss {image_string.substr(0, image_string.size() - 1)};
+
+        REQUIRE_FALSE(ProgramImage::load(image_iss, loaded_program, source_hash));
+        REQUIRE(loaded_program.lineCount() == 0);
+    }
+    SECTION("image using a code that no longer exists is not loaded")
+    {
+        std::istringstream image_iss {swapNames(image.str(), "PRINT", "PRUNT")};
+
+        REQUIRE_FALSE(ProgramImage::load(image_iss, loaded_program, source_hash));
+    }
+    SECTION("program is run where the image is mapped")
+    {
+        auto image_file_name = temporaryFileName("program_unittests.ibc");
+        {
+            std::ofstream ofs {image_file_name, std::ios::binary};
+            ofs << image.str();
+        }
+        MappedProgram mapped_program {image_file_name, source_hash, true};
+        MappedProgram other_source_program {image_file_name, source_hash + 1, true};
+        MappedProgram missing_program {temporaryFileName("missing.ibc"), source_hash, true};
+        std::remove(image_file_name.c_str());
+
+        REQUIRE(mapped_program.runsInPlace());
+        std::ostringstream oss;
+        REQUIRE_FALSE(program.runCode(oss, OutputBuffering::Line, test_dispatch));
+        std::ostringstream mapped_oss;
+        REQUIRE_FALSE(mapped_program.runCode(mapped_oss, OutputBuffering::Line, test_dispatch));
+        REQUIRE(mapped_oss.str() == oss.str());
+
+        REQUIRE(mapped_program.load(loaded_program));
+        REQUIRE(loaded_program.lineCount() == program.lineCount());
+
+        REQUIRE_FALSE(other_source_program.isOpen());
+        REQUIRE_FALSE(missing_program.isOpen());
+    }
+    SECTION("code values are mapped by the name of each code")
+    {
+        std::istringstream small_iss {"PRINT 5 - 3\n"};
+        ProgramUnit small_program;
+        small_program.compile(small_iss);
+        std::ostringstream small_image;
+        ProgramImage::save(small_image, small_program, source_hash);
+        loaded_program.setConstantFolding(false);
+
+        // the image now says that the value of subtract is add and the value of add is subtract
+        std::istringstream image_iss {swapNames(small_image.str(), "-@6#3", "+@6#3")};
+        REQUIRE(ProgramImage::load(image_iss, loaded_program, source_hash));
+        std::ostringstream oss;
+        loaded_program.run(oss, OutputBuffering::Line, test_dispatch);
+        REQUIRE(oss.str() == "8\n");
+    }
+    SECTION("image with code that can't be run is not opened (so it is not run in place)")
+    {
+        std::istringstream small_iss {"PRINT 5 - 3\nPRINT \"ab\" + \"cd\"\n"};
+        ProgramUnit small_program;
+        small_program.compile(small_iss);
+        std::ostringstream small_image;
+        ProgramImage::save(small_image, small_program, source_hash);
+        auto image_string = small_image.str();
+        auto const_int = codeValue("ConstInt");
+        auto const_dbl = codeValue("ConstDbl");
+        auto const_str = codeValue("ConstStr");
+        auto print_int = codeValue("PrintInt");
+        REQUIRE(openImage(image_string, source_hash));
+
+        // a code word that is not a code
+        REQUIRE_FALSE(openImage(replaceWords(image_string, {const_int, 0}, {0x7fff, 0}),
+            source_hash));
+        // constant indexes that are not in the dictionaries
+        REQUIRE_FALSE(openImage(replaceWords(image_string, {const_int, 1}, {const_int, 2}),
+            source_hash));
+        REQUIRE_FALSE(openImage(replaceWords(image_string, {const_str, 1}, {const_str, 2}),
+            source_hash));
+        // more items popped than were pushed
+        REQUIRE_FALSE(openImage(replaceWords(image_string, {const_int, 0, const_int, 1},
+            {const_int, 0, print_int, print_int}), source_hash));
+        // items of other data types than the codes that pop them expect
+        REQUIRE_FALSE(openImage(replaceWords(image_string, {const_int, 1}, {const_dbl, 1}),
+            source_hash));
+        REQUIRE_FALSE(openImage(replaceWords(image_string, {const_str, 0}, {const_int, 0}),
+            source_hash));
+        // a maximum stack depth that is larger than the code (after the magic number, version,
+        // source hash, word size, compile options, code count, code size and line count)
+        constexpr std::size_t MaximumStackDepthOffset = 36;
+        REQUIRE_FALSE(openImage(replaceHeaderWord(image_string, MaximumStackDepthOffset,
+            0xffffffff), source_hash));
+        REQUIRE_FALSE(openImage(replaceHeaderWord(image_string, MaximumStackDepthOffset,
+            1000), source_hash));
+        REQUIRE(openImage(replaceHeaderWord(image_string, MaximumStackDepthOffset, 4),
+            source_hash));
+        // string constant offsets that are out of order (the strings are run in place)
+        REQUIRE_FALSE(openImage(replaceValues<uint32_t>(image_string, {0, 2, 4}, {0, 4, 2}),
+            source_hash));
+
+        auto image_file_name = temporaryFileName("program_unittests.ibc");
+        {
+            std::ofstream ofs {image_file_name, std::ios::binary};
+            ofs << replaceWords(image_string, {const_int, 0}, {0x7fff, 0});
+        }
+        MappedProgram mapped_program {image_file_name, source_hash, false};
+        std::remove(image_file_name.c_str());
+
+        REQUIRE_FALSE(mapped_program.runsInPlace());
+        REQUIRE_FALSE(mapped_program.load(loaded_program));
+    }
+}
+
+TEST_CASE("compile programs with more constants than fit in one word", "[long-operands]")
+{
+    extern Code const_dbl_long_code;
+    extern Code const_int_long_code;
+    extern Code const_str_long_code;
+    extern Code folded_int_long_code;
+    extern Code folded_str_long_code;
+
+    // enough lines that the last constants are past the one word limit
+    constexpr unsigned ConstantCount = 65600;
+    std::ostringstream source;
+    std::ostringstream expected_output;
+    for (unsigned i = 0; i < ConstantCount; ++i) {
+        source << "PRINT " << 100000 + i << '\n';
+        source << "PRINT \"s" << i << "\"\n";
+        expected_output << 100000 + i << '\n';
+        expected_output << 's' << i << '\n';
+    }
+    auto first_line = 2 * ConstantCount;
+    auto firstCode = [](const ProgramUnit &program, unsigned line_index) {
+        return program.createProgramReader(line_index).getInstruction()->getValue();
+    };
+    ProgramUnit program;
+
+    SECTION("constants past the limit use the long constant codes")
+    {
+        source <<
+            "PRINT 30000 \\ 1.5\n"
+            "PRINT NOT 300000.4\n"
+            "PRINT \"last\"\n";
+        std::istringstream iss {source.str()};
+
+        REQUIRE(program.compile(iss).empty());
+        REQUIRE(firstCode(program, first_line - 2) == const_int_long_code.getValue());
+        REQUIRE(firstCode(program, first_line - 1) == const_str_long_code.getValue());
+        REQUIRE(program.recreateLine(first_line) == "PRINT 30000 \\ 1.5");
+        REQUIRE(program.recreateLine(first_line + 1) == "PRINT NOT 300000.4");
+        REQUIRE(program.recreateLine(first_line + 2) == "PRINT \"last\"");
+
+        std::ostringstream oss;
+        program.run(oss, OutputBuffering::Line, test_dispatch);
+        REQUIRE(oss.str() == expected_output.str() + "20000\n" "-300001\n" "last\n");
+
+        SECTION("long constant codes are saved and loaded")
+        {
+            std::ostringstream image;
+            ProgramImage::save(image, program, 0);
+            std::istringstream image_iss {image.str()};
+            ProgramUnit loaded_program;
+            REQUIRE(ProgramImage::load(image_iss, loaded_program, 0));
+
+            REQUIRE(loaded_program.recreateLine(first_line) == "PRINT 30000 \\ 1.5");
+            std::ostringstream loaded_oss;
+            loaded_program.run(loaded_oss, OutputBuffering::Line, test_dispatch);
+            REQUIRE(loaded_oss.str() == oss.str());
+        }
+    }
+    SECTION("integer and double conversions of long constants")
+    {
+        source <<
+            "PRINT 30000 \\ 1.5\n"
+            "PRINT NOT 300000.4\n";
+        std::istringstream iss {source.str()};
+        program.compile(iss);
+
+        REQUIRE(firstCode(program, first_line) == const_dbl_long_code.getValue());
+        REQUIRE(firstCode(program, first_line + 1) == const_int_long_code.getValue());
+    }
+    SECTION("folded constants past the limit use the long folded codes")
+    {
+        source <<
+            "PRINT 1 + 2\n"
+            "PRINT \"a\" + \"b\"\n";
+        std::istringstream iss {source.str()};
+        program.setConstantFolding(true);
+
+        REQUIRE(program.compile(iss).empty());
+        REQUIRE(firstCode(program, first_line) == folded_int_long_code.getValue());
+        REQUIRE(firstCode(program, first_line + 1) == folded_str_long_code.getValue());
+        REQUIRE(program.recreateLine(first_line) == "PRINT 1 + 2");
+        REQUIRE(program.recreateLine(first_line + 1) == "PRINT \"a\" + \"b\"");
+
+        std::ostringstream oss;
+        program.run(oss, OutputBuffering::Line, test_dispatch);
+        REQUIRE(oss.str() == expected_output.str() + "3\n" "ab\n");
+    }
+}
+
+TEST_CASE("compile a source in memory", "[source]")
+{
+    auto compileInMemory = [](const std::string &source, ProgramUnit &program) {
+        return program.compile(source.data(), source.size());
+    };
+    auto compileStream = [](const std::string &source, ProgramUnit &program) {
+        std::istringstream iss {source};
+        return program.compile(iss);
+    };
+    auto recreate = [](const ProgramUnit &program) {
+        std::ostringstream oss;
+        program.recreate(oss);
+        return oss.str();
+    };
+
+    SECTION("lines are separated the same as lines read from a stream")
+    {
+        std::string sources[] = {
+            "",
+            "\n",
+            "PRINT 1",
+            "PRINT 1\n",
+            "PRINT 1\n\nPRINT \"two\"\n\n",
+            "\n\nPRINT ABS(-3) + 2\nPRINT"
+        };
+        for (auto &source : sources) {
+            ProgramUnit program;
+            ProgramUnit stream_program;
+            compileInMemory(source, program);
+            compileStream(source, stream_program);
+            REQUIRE(program.lineCount() == stream_program.lineCount());
+            REQUIRE(recreate(program) == recreate(stream_program));
+        }
+    }
+    SECTION("errors have the line numbers and lines of the source")
+    {
+        std::string source {"PRINT 1\nPRINT 1 +\nPRINT\nPRINT (2"};
+        ProgramUnit program;
+        auto errors = compileInMemory(source, program);
+        REQUIRE(errors.size() == 2);
+        REQUIRE(errors[0].line_number == 2);
+        REQUIRE(errors[0].line == "PRINT 1 +");
+        REQUIRE(errors[1].line_number == 4);
+        REQUIRE(errors[1].line == "PRINT (2");
+        REQUIRE(program.lineCount() == 4);
+    }
+    SECTION("compile a mapped source file")
+    {
+        auto file_name = temporaryFileName("program_unittests_source.bas");
+        std::string source {"PRINT 2 * 3\nPRINT \"mapped\"\n"};
+        {
+            std::ofstream ofs {file_name};
+            ofs << source;
+        }
+        MappedFile mapped_source {file_name};
+        REQUIRE(mapped_source.isOpen());
+        REQUIRE(std::string(mapped_source.data(), mapped_source.size()) == source);
+        REQUIRE(ProgramImage::hashSource(mapped_source.data(), mapped_source.size())
+            == ProgramImage::hashSource(source));
+
+        ProgramUnit program;
+        std::ostringstream oss;
+        REQUIRE(program.compileSource(mapped_source.data(), mapped_source.size(), oss));
+        REQUIRE(program.runCode(oss, OutputBuffering::Line, test_dispatch));
+        REQUIRE(oss.str() == "6\nmapped\n");
+        std::remove(file_name.c_str());
+    }
+    SECTION("an empty file is open without data and a missing file is not open")
+    {
+        auto file_name = temporaryFileName("program_unittests_empty.bas");
+        std::ofstream {file_name}.close();
+        MappedFile empty_source {file_name};
+        REQUIRE(empty_source.isOpen());
+        REQUIRE(empty_source.size() == 0);
+        ProgramUnit program;
+        REQUIRE(program.compile(empty_source.data(), empty_source.size()).empty());
+        REQUIRE(program.lineCount() == 0);
+        std::remove(file_name.c_str());
+
+        MappedFile missing_source {file_name};
+        REQUIRE_FALSE(missing_source.isOpen());
+    }
 }
 
 TEST_CASE("miscellaneous error class coverage", "[misc-coverage]")
@@ -0,0 +1,81 @@
+/* vim:ts=4:sw=4:et:sts=4:
+ *
+ * Copyright 2016 Thunder422.  All rights reserved.
+ * Distributed under GNU General Public License Version 3
+ * (See accompanying file LICENSE or <http://www.gnu.org/licenses/>)
+ */
+
+#include <random>
+#include <set>
+#include <vector>
+
+#include "catch.hpp"
+#include "randomgenerator.h"
+
+
+std::vector<double> generateNumbers(RandomGenerator &generator, int count)
+{
+    std::vector<double> numbers;
+    for (int i = 0; i < count; ++i) {
+        numbers.push_back(generator.getNumber());
+    }
+    return numbers;
+}
+
+TEST_CASE("random generators of each engine", "[engines]")
+{
+    for (auto engine : {RandomEngine::Standard, RandomEngine::MersenneTwister,
+            RandomEngine::Xoshiro}) {
+        SECTION("numbers are between 0 and 1")
+        {
+            auto generator = RandomGenerator::create(engine);
+            for (auto number : generateNumbers(*generator, 10000)) {
+                REQUIRE(number >= 0.0);
+                REQUIRE(number < 1.0);
+            }
+        }
+        SECTION("integers are between 1 and the limit and all occur")
+        {
+            auto generator = RandomGenerator::create(engine);
+            std::set<int32_t> integers;
+            for (int i = 0; i < 1000; ++i) {
+                auto integer = generator->getNumber(6);
+                REQUIRE(integer >= 1);
+                REQUIRE(integer <= 6);
+                integers.insert(integer);
+            }
+            REQUIRE(integers.size() == 6);
+            REQUIRE(generator->getNumber(1) == 1);
+            REQUIRE(generator->getNumber(INT32_MAX) >= 1);
+        }
+        SECTION("the same seed generates the same numbers")
+        {
+            auto generator = RandomGenerator::create(engine, 12345);
+            auto numbers = generateNumbers(*generator, 100);
+            REQUIRE(generateNumbers(*generator, 100) != numbers);
+
+            generator->seed(12345);
+            REQUIRE(generateNumbers(*generator, 100) == numbers);
+            REQUIRE(generateNumbers(*RandomGenerator::create(engine, 12345), 100) == numbers);
+        }
+        SECTION("different seeds generate different numbers")
+        {
+            auto numbers1 = generateNumbers(*RandomGenerator::create(engine, 1), 100);
+            auto numbers2 = generateNumbers(*RandomGenerator::create(engine, 2), 100);
+            REQUIRE(numbers1 != numbers2);
+        }
+    }
+}
+
+TEST_CASE("standard engine numbers are unchanged", "[standard]")
+{
+    std::default_random_engine engine;
+    std::uniform_real_distribution<double> distribution {0.0, 1.0};
+    std::uniform_int_distribution<int> int_distribution {1, 10};
+    auto generator = RandomGenerator::create(RandomEngine::Standard);
+
+    for (int i = 0; i < 100; ++i) {
+        REQUIRE(generator->getNumber() == distribution(engine));
+        REQUIRE(generator->getNumber(10) == int_distribution(engine));
+    }
+}
@@ -0,0 +1,82 @@
+/* vim:ts=4:sw=4:et:sts=4:
+ *
+ * Copyright 2016 Thunder422.  All rights reserved.
+ * Distributed under GNU General Public License Version 3
+ * (See accompanying file LICENSE or <http://www.gnu.org/licenses/>)
+ */
+
+#include <string>
+
+#include "catch.hpp"
+#include "stringcompare.h"
+
+
+// the result of a comparison is only checked for its sign
+int sign(int value)
+{
+    return (value > 0) - (value < 0);
+}
+
+void requireSameAsStandardStrings(const std::string &lhs, const std::string &rhs)
+{
+    INFO("lengths " << lhs.size() << " and " << rhs.size());
+    REQUIRE(sign(compareStrings(lhs, rhs)) == sign(lhs.compare(rhs)));
+    REQUIRE(sign(compareStrings(rhs, lhs)) == sign(rhs.compare(lhs)));
+    REQUIRE(equalStrings(lhs, rhs) == (lhs == rhs));
+}
+
+void requireKernelSameAsStandardStrings(StringCompareKernel kernel)
+{
+    auto default_kernel = getStringCompareKernel();
+    setStringCompareKernel(kernel);
+
+    for (std::size_t length = 0; length <= 100; ++length) {
+        std::string string(length, 'a');
+        for (std::size_t i = 0; i < length; ++i) {
+            string[i] += i % 26;
+        }
+        requireSameAsStandardStrings(string, string);
+        requireSameAsStandardStrings(string, string + 'a');
+        requireSameAsStandardStrings(string + 'a', string + 'b');
+        for (std::size_t offset = 0; offset < length; ++offset) {
+            auto other = string;
+            other[offset] = '\xe9';  // compares as an unsigned character
+            requireSameAsStandardStrings(string, other);
+            REQUIRE(mismatchOffset(string.data(), other.data(), length) == offset);
+        }
+    }
+
+    std::string large(1 << 20, 'x');
+    auto other = large;
+    other.back() = 'y';
+    requireSameAsStandardStrings(large, large);
+    requireSameAsStandardStrings(large, other);
+
+    setStringCompareKernel(default_kernel);
+}
+
+
+TEST_CASE("compare strings with each kernel", "[compare]")
+{
+    SECTION("the scalar kernel is always supported")
+    {
+        REQUIRE(isStringCompareKernelSupported(StringCompareKernel::Scalar));
+        REQUIRE(isStringCompareKernelSupported(getStringCompareKernel()));
+    }
+    SECTION("scalar kernel")
+    {
+        requireKernelSameAsStandardStrings(StringCompareKernel::Scalar);
+    }
+    SECTION("SSE2 kernel (when supported)")
+    {
+        if (isStringCompareKernelSupported(StringCompareKernel::Sse2)) {
+            requireKernelSameAsStandardStrings(StringCompareKernel::Sse2);
+        }
+    }
+    SECTION("AVX2 kernel (when supported)")
+    {
+        if (isStringCompareKernelSupported(StringCompareKernel::Avx2)) {
+            requireKernelSameAsStandardStrings(StringCompareKernel::Avx2);
+        }
+    }
+}
@@ -12,6 +12,7 @@
 #include "operators.h"
 #include "programerror.h"
 #include "programunit.h"
+#include "support.h"
 
 
 TEST_CASE("string constants", "[const][compile]")
@@ -80,12 +81,12 @@ TEST_CASE("string constants", "[const][compile]")
     }
     SECTION("check that each string has a unique operand (index) value")
     {
+        // the code line of each compiler is copied since the compilers share the program's buffers
         Compiler compiler1 {R"("first")", program};
         compiler1.compileStringConstant();
+        auto code_line1 = compiler1.getCodeLine();
         Compiler compiler2 {R"("second")", program};
         compiler2.compileStringConstant();
-
-        auto code_line1 = compiler1.getCodeLine();
         auto code_line2 = compiler2.getCodeLine();
 
         REQUIRE(code_line1.size() == 2);
@@ -263,9 +264,50 @@ TEST_CASE("execute string constants", "[const][execute]")
         auto code_line = compiler.getCodeLine();
         program.appendCodeLine(code_line);
 
-        auto executer = program.createExecuter(unused_oss);
+        auto executer = program.createExecuter(unused_oss, OutputBuffering::Line, test_dispatch);
         executer.executeOneCode();
-        REQUIRE(*executer.topStr() == "test123");
+        REQUIRE(executer.topStr() == "test123");
+    }
+}
+
+TEST_CASE("string constant dictionary", "[const][dictionary]")
+{
+    ProgramUnit program;
+
+    SECTION("the indexes of the constants do not change as the hash table grows")
+    {
+        for (unsigned i = 0; i < 1000; ++i) {
+            REQUIRE(program.addConstantString("constant" + std::to_string(i)) == i);
+        }
+        for (unsigned i = 0; i < 1000; ++i) {
+            auto string = "constant" + std::to_string(i);
+            REQUIRE(program.addConstantString(string) == i);
+            REQUIRE(program.getConstantString(i) == string.c_str());
+        }
+        REQUIRE(program.getConstantStringMemoryUsage().entry_count == 1000);
+    }
+    SECTION("constants that differ only by length or case are different")
+    {
+        REQUIRE(program.addConstantString("") == 0);
+        REQUIRE(program.addConstantString("a") == 1);
+        REQUIRE(program.addConstantString("A") == 2);
+        REQUIRE(program.addConstantString("aa") == 3);
+        REQUIRE(program.addConstantString("") == 0);
+        REQUIRE(program.getConstantString(0).empty());
+        REQUIRE(program.getConstantString(3) == "aa");
+    }
+    SECTION("the memory used grows with the constants")
+    {
+        auto memory_usage = program.getConstantStringMemoryUsage();
+        REQUIRE(memory_usage.entry_count == 0);
+        for (unsigned i = 0; i < 100; ++i) {
+            program.addConstantString(std::string(50, 'a' + i % 26) + std::to_string(i));
+        }
+        auto new_memory_usage = program.getConstantStringMemoryUsage();
+        REQUIRE(new_memory_usage.characters >= 100 * 51);
+        REQUIRE(new_memory_usage.hash_table > memory_usage.hash_table);
+        REQUIRE(new_memory_usage.values == 0);  // the executer uses the dictionary characters
+        REQUIRE(new_memory_usage.total() > memory_usage.total());
     }
 }
 
@@ -369,7 +411,7 @@ TEST_CASE("relational operators with string operands", "[relational]")
         std::ostringstream oss;
 
         program.compileSource(iss, oss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "-1\n0\n0\n");
     }
@@ -383,7 +425,7 @@ TEST_CASE("relational operators with string operands", "[relational]")
         std::ostringstream oss;
 
         program.compileSource(iss, oss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "0\n-1\n0\n");
     }
@@ -397,7 +439,7 @@ TEST_CASE("relational operators with string operands", "[relational]")
         std::ostringstream oss;
 
         program.compileSource(iss, oss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "-1\n0\n-1\n");
     }
@@ -411,7 +453,7 @@ TEST_CASE("relational operators with string operands", "[relational]")
         std::ostringstream oss;
 
         program.compileSource(iss, oss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "0\n-1\n-1\n");
     }
@@ -461,7 +503,7 @@ TEST_CASE("equality operators with string operands", "[equality]")
         std::ostringstream oss;
 
         program.compileSource(iss, oss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "0\n0\n-1\n");
     }
@@ -475,7 +517,7 @@ TEST_CASE("equality operators with string operands", "[equality]")
         std::ostringstream oss;
 
         program.compileSource(iss, oss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "-1\n-1\n0\n");
     }
@@ -533,7 +575,7 @@ TEST_CASE("compile concatenation operator expressions", "[cat][compile]")
     }
     SECTION("compile with left side temporary string operand")
     {
-        Compiler compiler {R"("left1"+"left2"+"right")", program};
+        Compiler compiler {R"(("left1"+"left2")+"right")", program};
 
         compiler.compileExpression();
         auto code_line = compiler.getCodeLine();
@@ -544,7 +586,7 @@ TEST_CASE("compile concatenation operator expressions", "[cat][compile]")
     }
     SECTION("compile with left and right side temporary string operands")
     {
-        Compiler compiler {R"("left1"+"left2"+("right1"+"right2"))", program};
+        Compiler compiler {R"(("left1"+"left2")+("right1"+"right2"))", program};
 
         compiler.compileExpression();
         auto code_line = compiler.getCodeLine();
@@ -553,6 +595,42 @@ TEST_CASE("compile concatenation operator expressions", "[cat][compile]")
         REQUIRE(code_line.size() == 11);
         REQUIRE(code_line[10].instructionCode()->getValue() == cat_tmp_tmp_code.getValue());
     }
+    SECTION("compile a chain of concatenations into one instruction")
+    {
+        Compiler compiler {R"("one"+"two"+("three"+"four")+"five")", program};
+
+        compiler.compileExpression();
+        auto code_line = compiler.getCodeLine();
+
+        extern Code cat_strings_code;
+        REQUIRE(code_line.size() == 14);
+        REQUIRE(code_line[11].instructionCode()->getValue() == cat_strings_code.getValue());
+        REQUIRE(code_line[12].operand() == 4);
+        REQUIRE(code_line[13].operand() == 0x4);
+        REQUIRE(code_line.maximumStackDepth() == 4);
+        REQUIRE(cat_strings_code.getStackEffect(code_line.getBeginning() + 12) == -3);
+    }
+    SECTION("compile a chain longer than the maximum operands as continued chains")
+    {
+        std::string expression {R"("a")"};
+        for (unsigned i = 1; i < 20; ++i) {
+            expression += R"(+"a")";
+        }
+        Compiler compiler {expression, program};
+
+        auto data_type = compiler.compileExpression();
+        auto code_line = compiler.getCodeLine();
+
+        extern Code cat_strings_code;
+        REQUIRE(data_type.isTmpStr());
+        REQUIRE(code_line.size() == 20 * 2 + 3 + 3);
+        REQUIRE(code_line[32].instructionCode()->getValue() == cat_strings_code.getValue());
+        REQUIRE(code_line[33].operand() == 16);
+        REQUIRE(code_line[34].operand() == 0);
+        REQUIRE(code_line[43].instructionCode()->getValue() == cat_strings_code.getValue());
+        REQUIRE(code_line[44].operand() == 5);
+        REQUIRE(code_line[45].operand() == 1);
+    }
     SECTION("check for error with the left side temporary string on and right side not a string")
     {
         std::istringstream iss {R"(PRINT "left1"+"left2"+123)"};
@@ -611,6 +689,31 @@ TEST_CASE("recreate expressions with concatentation and temporary strings", "[ca
         program.recreate(oss);
 
         REQUIRE(oss.str() == R"(PRINT "left1" + "left2" + ("right1" + "right2"))" "\n");
+    }    SECTION("chain of concatenations with parenthesized operands")
+    {
+        std::istringstream iss {R"(PRINT ("a"+"b")+"c"+("d"+"e"+"f")+"g")"};
+        std::ostringstream oss;
+
+        program.compile(iss);
+        program.recreate(oss);
+
+        REQUIRE(oss.str() == R"(PRINT "a" + "b" + "c" + ("d" + "e" + "f") + "g")" "\n");
+    }
+    SECTION("chain of concatenations longer than the maximum operands")
+    {
+        std::string line {R"(PRINT "a")"};
+        std::string expected {R"(PRINT "a")"};
+        for (unsigned i = 1; i < 40; ++i) {
+            line += R"(+"a")";
+            expected += R"( + "a")";
+        }
+        std::istringstream iss {line};
+        std::ostringstream oss;
+
+        program.compile(iss);
+        program.recreate(oss);
+
+        REQUIRE(oss.str() == expected + "\n");
     }
 }
 
@@ -820,7 +923,7 @@ TEST_CASE("execute concatentation expressions with temporary strings", "[cat][ex
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "LeftRight\n");
     }
@@ -830,7 +933,7 @@ TEST_CASE("execute concatentation expressions with temporary strings", "[cat][ex
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "Left1Left2Right\n");
     }
@@ -840,7 +943,7 @@ TEST_CASE("execute concatentation expressions with temporary strings", "[cat][ex
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "LeftRight1Right2\n");
     }
@@ -850,9 +953,71 @@ TEST_CASE("execute concatentation expressions with temporary strings", "[cat][ex
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "Left1Left2Right1Right2\n");
+    }    SECTION("chain of concatenations with temporary string operands")
+    {
+        std::istringstream iss {R"(PRINT ("a"+"b")+"c"+("d"+"e"+"f")+"g"+("h"+"i"))"};
+        std::ostringstream oss;
+
+        program.compile(iss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
+
+        REQUIRE(oss.str() == "abcdefghi\n");
+    }
+    SECTION("chain of concatenations longer than the maximum operands")
+    {
+        std::string line {"PRINT \"0\""};
+        std::string expected {"0"};
+        for (unsigned i = 1; i < 40; ++i) {
+            auto digit = std::to_string(i % 10);
+            line += i % 7 == 0 ? "+(\"" + digit + "\"+\"" + digit + "\")" : "+\"" + digit + "\"";
+            expected += i % 7 == 0 ? digit + digit : digit;
+        }
+        std::istringstream iss {line};
+        std::ostringstream oss;
+
+        program.compile(iss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
+
+        REQUIRE(oss.str() == expected + "\n");
+    }
+    SECTION("chain of concatenations with constant folding")
+    {
+        std::istringstream iss {R"(PRINT "a"+"b"+"c"+("d"+"e"))"};
+        std::ostringstream oss;
+
+        program.setConstantFolding(true);
+        program.compile(iss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
+
+        REQUIRE(oss.str() == "abcde\n");
+    }
+}
+
+TEST_CASE("reuse temporary strings", "[cat][execute]")
+{
+    ProgramUnit program;
+
+    SECTION("temporary strings are returned to the pool of the executer")
+    {
+        std::istringstream iss {
+            R"(PRINT "ab"+"cd")" "\n"
+            R"(PRINT "ab"+"cd"+"ef")" "\n"
+            R"(PRINT "ab"+("cd"+"ef"))" "\n"
+            "END"
+        };
+        std::ostringstream oss;
+
+        program.compile(iss);
+        auto executer = program.createExecuter(oss, OutputBuffering::Line, test_dispatch);
+        executer.run();
+
+        REQUIRE(oss.str() == "abcd\nabcdef\nabcdef\n");
+        auto statistics = executer.getStringPoolStatistics();
+        REQUIRE(statistics.misses == 0);
+        REQUIRE(statistics.hits == 3);
     }
 }
 
@@ -870,7 +1035,7 @@ TEST_CASE("execute relational expressions with temporary strings", "[relational]
         std::ostringstream oss;
 
         program.compileSource(iss, oss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "-1\n0\n0\n");
     }
@@ -884,7 +1049,7 @@ TEST_CASE("execute relational expressions with temporary strings", "[relational]
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "-1\n0\n0\n");
     }
@@ -898,8 +1063,32 @@ TEST_CASE("execute relational expressions with temporary strings", "[relational]
         std::ostringstream oss;
 
         program.compile(iss);
-        program.run(oss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
 
         REQUIRE(oss.str() == "-1\n0\n0\n");
     }
 }
+
+TEST_CASE("execute comparison operators with temporary strings", "[relational][execute]")
+{
+    ProgramUnit program;
+
+    SECTION("each comparison operator with temporary string operands")
+    {
+        std::istringstream iss {
+            R"(PRINT "b"+"b">"ab")" "\n"
+            R"(PRINT "ab"<="a"+"b")" "\n"
+            R"(PRINT "a"+"a">="a"+"b")" "\n"
+            R"(PRINT "a"+"b"="ab")" "\n"
+            R"(PRINT "ab"="a"+"bc")" "\n"
+            R"(PRINT "a"+"b"<>"a"+"b")" "\n"
+            R"(PRINT "a"+"b"<>"a"+"c")"
+        };
+        std::ostringstream oss;
+
+        program.compile(iss);
+        program.run(oss, OutputBuffering::Line, test_dispatch);
+
+        REQUIRE(oss.str() == "-1\n-1\n0\n-1\n0\n0\n-1\n");
+    }
+}
@@ -8,6 +8,12 @@
 #ifndef SUPPORT_H
 #define SUPPORT_H
 
+#include "executer.h"
+
+
+// the dispatch the tests run programs with (the tests are run once with each dispatch)
+extern Dispatch test_dispatch;
+
 
 #define REQUIRE_CODESIZE_OPERAND(expected_code_size, number) \
     auto code_line = compiler.getCodeLine(); \
@@ -0,0 +1,81 @@
+/* vim:ts=4:sw=4:et:sts=4:
+ *
+ * Copyright 2016 Thunder422.  All rights reserved.
+ * Distributed under GNU General Public License Version 3
+ * (See accompanying file LICENSE or <http://www.gnu.org/licenses/>)
+ */
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "catch.hpp"
+#include "ibc-bin/threadpool.h"
+
+
+TEST_CASE("run tasks on a pool of threads", "[threadpool]")
+{
+    std::mutex mutex;
+    std::vector<int> order;
+    auto record = [&mutex, &order](int value) {
+        std::lock_guard<std::mutex> lock {mutex};
+        order.push_back(value);
+    };
+
+    SECTION("tasks are taken in the order submitted")
+    {
+        {
+            ThreadPool thread_pool {1};
+            for (int value = 0; value < 100; ++value) {
+                thread_pool.submit([&record, value]() { record(value); });
+            }
+        }
+        REQUIRE(order.size() == 100);
+        for (int value = 0; value < 100; ++value) {
+            REQUIRE(order[value] == value);
+        }
+    }
+    SECTION("tasks submitted by a task go to the back of the queue")
+    {
+        {
+            ThreadPool thread_pool {1};
+            thread_pool.submit([&thread_pool, &record]() {
+                thread_pool.submit([&record]() { record(3); });
+                record(1);
+            });
+            thread_pool.submit([&record]() { record(2); });
+        }
+        REQUIRE(order == (std::vector<int> {1, 2, 3}));
+    }
+    SECTION("the tasks still queued are run before the pool is destroyed")
+    {
+        std::atomic<unsigned> run_count {0};
+        {
+            ThreadPool thread_pool {2};
+            thread_pool.submit([]() {
+                std::this_thread::sleep_for(std::chrono::milliseconds {20});
+            });
+            for (unsigned count = 0; count < 1000; ++count) {
+                thread_pool.submit([&run_count]() { ++run_count; });
+            }
+        }
+        REQUIRE(run_count == 1000);
+    }
+    SECTION("an exception thrown by a task does not stop the pool")
+    {
+        {
+            ThreadPool thread_pool {1};
+            thread_pool.submit([&record]() { record(1); });
+            thread_pool.submit([]() { throw std::runtime_error {"task failed"}; });
+            thread_pool.submit([&record]() { record(2); });
+        }
+        REQUIRE(order == (std::vector<int> {1, 2}));
+    }
+    SECTION("a pool without tasks is destroyed")
+    {
+        ThreadPool thread_pool {4};
+    }
+}